@@ -7,38 +7,84 @@
  Features:
  - Character count (total, no spaces, punctuation)
  - Word, sentence, and line counting
- - Vowel frequency analysis
+ - Vowel frequency analysis and full letter histogram
  - Pangram detection (using all alphabet letters)
  - Longest/Shortest word finding
+ - Streaming analyzer for input of any size (typed text, file or stdin):
+   byte histogram with 4 interleaved tables, letter runs from a SIMD
+   nibble lookup table (AVX2 vpshufb), word lengths tracked on the fly
+ - Throughput benchmark (GB/s) against the per-character analyzer
+ - Word frequency engine: case-folded words interned in an open-addressing
+   hash table backed by an arena, one table per thread (mmap'ed file split
+   on word boundaries) merged at the end, top-K picked with a min-heap
+ - Word frequency benchmark against `tr | sort | uniq -c | sort -rn`
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <ctype.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 #define TRUE 1
 #define FALSE 0
-#define MAX_BUFFER 2048
+#define MIN_OPTION 1
+#define MAX_OPTION 6
+#define MAX_LINE 1024
+#define MAX_PATH 256
 #define MAX_WORD_LENGTH 50
 #define ALPHABET_SIZE 26
 #define VOWEL_COUNT 5
+#define STREAM_CHUNK (1 << 20)
+#define HISTOGRAM_SLICE (1 << 30) // Keeps the 32-bit sub-tables from wrapping
+#define MB (1024 * 1024)
+#define MAX_THREADS 16
+#define MAX_TOP_K 1000
+#define MAX_TOKEN 64          // Longer words are counted by their prefix
+#define SHORT_WORD 16         // Words below this are stored in the slot
+#define ARENA_BLOCK (1 << 20) // Word text storage, allocated 1 MB at a time
+#define TABLE_MIN_CAPACITY 4096
+#define CORPUS_FILENAME "word_corpus.txt"
+#define CORPUS_VOCABULARY 200000
 
-typedef enum { SUCCESS, ERR_BUFFER_OVERFLOW } Status;
+typedef enum {
+  SUCCESS,
+  ERR_INVALID_INPUT,
+  ERR_FILE_NOT_FOUND,
+  ERR_READ_FAILED,
+  ERR_WRITE_FAILED,
+  ERR_MEMORY_ALLOCATION
+} Status;
 
 typedef struct {
-  int total_chars;
-  int chars_no_space;
-  int words;
-  int sentences;
-  int lines;
-  int letters;
-  int spaces;
-  int punctuation;
+  long long total_chars;
+  long long chars_no_space;
+  long long words;
+  long long sentences;
+  long long lines;
+  long long letters;
+  long long spaces;
+  long long punctuation;
 } CharStats;
 
 typedef struct {
-  int vowel_counts[VOWEL_COUNT];
+  long long vowel_counts[VOWEL_COUNT];
+  long long letter_counts[ALPHABET_SIZE];
   int alpha_present[ALPHABET_SIZE];
   int unique_letters;
 } AlphabetStats;
@@ -46,6 +92,8 @@ typedef struct {
 typedef struct {
   char longest[MAX_WORD_LENGTH];
   char shortest[MAX_WORD_LENGTH];
+  long long longest_length;
+  long long shortest_length;
   double average_length;
 } WordStats;
 
@@ -56,126 +104,883 @@ typedef struct {
   WordStats words;
 } TextAnalysisResult;
 
+// State of the streaming analyzer between chunks
+typedef struct {
+  unsigned long long histogram[256];
+  long long words;
+  long long run;      // Letters so far in the word still open
+  long word_start;    // Chunk offset of that word, -1 if it began earlier
+  char partial[MAX_WORD_LENGTH]; // Its first letters, once the chunk ends
+  int partial_len;
+  WordStats word_stats;
+} TextStream;
+
+// Text of long words lives here: one malloc per MB instead of one per word
+typedef struct ArenaBlock {
+  struct ArenaBlock *next;
+  size_t used;
+  char data[ARENA_BLOCK];
+} ArenaBlock;
+
+// 32 bytes: short words are compared without leaving the slot
+typedef struct {
+  union {
+    char text[SHORT_WORD];  // Words shorter than SHORT_WORD, NUL padded
+    const char *long_word;  // Longer ones live in the arena
+  } key;
+  long long count; // 0 marks an empty slot
+  uint32_t hash;
+  uint32_t length;
+} WordEntry;
+
+// Open addressing, linear probing, power-of-two capacity
+typedef struct {
+  WordEntry *slots;
+  size_t capacity;
+  size_t used;
+  ArenaBlock *arena;
+  size_t arena_blocks;
+  long long total_words;
+  long long total_bytes;
+  char token[MAX_TOKEN]; // Word still open at the end of the last chunk
+  int token_len;         // Its letters so far (at most MAX_TOKEN - 1)
+} WordTable;
+
+typedef struct {
+  const char *data;
+  size_t start; // Range [start, end), both cut on word boundaries
+  size_t end;
+  WordTable table;
+  Status status;
+} FrequencyJob;
+
+void show_menu(void);
+void handle_error(Status status);
 void show_analysis_results(const TextAnalysisResult *result);
 void run_text_analysis(void);
+void run_file_analysis(void);
+void run_benchmark(void);
+void run_word_frequency(void);
+void run_frequency_benchmark(void);
 
-Status read_text_input(char *buffer, int max_size);
+void clear_input_buffer(void);
+Status read_integer(int *value);
+Status read_string(char *buffer, int max_len);
+double now_seconds(void);
 
 TextAnalysisResult analyze_text_logic(const char *text);
+TextAnalysisResult analyze_text_scalar(const char *text);
+Status analyze_file(FILE *file, TextAnalysisResult *result);
 int is_vowel(char c);
 int get_vowel_index(char c);
 
+void text_stream_init(TextStream *ts);
+void text_stream_feed(TextStream *ts, const char *chunk, size_t n);
+void text_stream_finish(TextStream *ts, TextAnalysisResult *result);
+void count_histogram(unsigned long long *histogram, const unsigned char *p,
+                     size_t n);
+void scan_letter_mask(TextStream *ts, const char *chunk, size_t base,
+                      unsigned mask, int bits);
+void end_word(TextStream *ts, const char *chunk, size_t end);
+int word_ends_matter(const TextStream *ts, unsigned mask, int bits);
+int is_letter(unsigned char c);
+unsigned letter_mask(const char *p, int bits);
+#ifdef __x86_64__
+size_t scan_words_avx2(TextStream *ts, const char *chunk, size_t n);
+#endif
+void fill_sample_text(char *text, size_t len);
+int same_results(const TextAnalysisResult *a, const TextAnalysisResult *b);
+
+void word_table_init(WordTable *table);
+void word_table_free(WordTable *table);
+Status word_table_feed(WordTable *table, const char *chunk, size_t n);
+Status word_table_finish(WordTable *table);
+Status word_table_end_word(WordTable *table, const char *chunk, long start,
+                           size_t end);
+Status word_table_add(WordTable *table, const char *word, uint32_t length,
+                      uint32_t hash, long long count);
+Status word_table_grow(WordTable *table);
+Status word_table_merge(WordTable *total, const WordTable *part);
+const WordEntry *word_table_find(const WordTable *table, const char *word);
+const char *entry_word(const WordEntry *entry);
+size_t word_table_bytes(const WordTable *table);
+char *arena_store(WordTable *table, const char *word, uint32_t length);
+uint32_t hash_word(const char *word, uint32_t length);
+Status frequency_stream(FILE *file, WordTable *table);
+Status frequency_parallel(const char *path, WordTable *table);
+void *frequency_worker(void *arg);
+size_t top_words(const WordTable *table, const WordEntry **top, size_t k);
+int ranks_before(const WordEntry *a, const WordEntry *b);
+void sift_down(const WordEntry **heap, size_t n, size_t i);
+void show_top_words(const WordTable *table, size_t k);
+Status write_corpus(const char *path, size_t size);
+double pipeline_baseline(const char *path, size_t k, const WordTable *table,
+                         int *matches, long *peak_kb);
+int online_cpus(void);
+
+int use_avx2 = FALSE;
+
 int main(void) {
-  printf("=== Text Analyzer ===\n\n");
-  printf("Enter text (type END on a new line to finish):\n\n");
+  int option = 0;
+
+#ifdef __x86_64__
+  use_avx2 = __builtin_cpu_supports("avx2");
+#endif
 
-  run_text_analysis();
+  while (TRUE) {
+    show_menu();
+
+    // Stdin may have been read to the end by option 2 or 4 with '-'
+    if (read_integer(&option) != SUCCESS) {
+      if (feof(stdin)) {
+        printf("\nExiting. Goodbye!\n");
+        break;
+      }
+      handle_error(ERR_INVALID_INPUT);
+      continue;
+    }
+
+    if (option == MAX_OPTION) {
+      printf("\nExiting. Goodbye!\n");
+      break;
+    }
+
+    if (option < MIN_OPTION || option > MAX_OPTION) {
+      handle_error(ERR_INVALID_INPUT);
+      continue;
+    }
+
+    switch (option) {
+    case 1:
+      run_text_analysis();
+      break;
+    case 2:
+      run_file_analysis();
+      break;
+    case 3:
+      run_benchmark();
+      break;
+    case 4:
+      run_word_frequency();
+      break;
+    case 5:
+      run_frequency_benchmark();
+      break;
+    }
+  }
 
   return 0;
 }
 
+void show_menu(void) {
+  printf("=== Text Analyzer ===\n\n");
+  printf("1. Analyze typed text\n2. Analyze file or stdin (streaming)\n"
+         "3. Throughput benchmark (GB/s)\n4. Word frequency (top-K)\n"
+         "5. Word frequency benchmark (vs sort | uniq -c)\n6. Exit\n");
+  printf("Option: ");
+}
+
+void handle_error(Status status) {
+  switch (status) {
+  case ERR_INVALID_INPUT:
+    printf("Error: Invalid input. Please enter a valid value.\n\n");
+    break;
+  case ERR_FILE_NOT_FOUND:
+    printf("Error: Could not open file for reading.\n\n");
+    break;
+  case ERR_READ_FAILED:
+    printf("Error: Failed to read input.\n\n");
+    break;
+  case ERR_WRITE_FAILED:
+    printf("Error: Failed to write file.\n\n");
+    break;
+  case ERR_MEMORY_ALLOCATION:
+    printf("Error: Memory allocation failed.\n\n");
+    break;
+  case SUCCESS:
+    break;
+  }
+}
+
 void show_analysis_results(const TextAnalysisResult *result) {
   printf("\n----- Text Statistics -----\n\n");
 
   printf("Character Counts:\n");
-  printf("  - Total characters: %d\n", result->chars.total_chars);
-  printf("  - Characters (no spaces): %d\n", result->chars.chars_no_space);
-  printf("  - Words: %d\n", result->chars.words);
-  printf("  - Sentences: %d\n", result->chars.sentences);
-  printf("  - Lines: %d\n\n", result->chars.lines);
+  printf("  - Total characters: %lld\n", result->chars.total_chars);
+  printf("  - Characters (no spaces): %lld\n", result->chars.chars_no_space);
+  printf("  - Words: %lld\n", result->chars.words);
+  printf("  - Sentences: %lld\n", result->chars.sentences);
+  printf("  - Lines: %lld\n\n", result->chars.lines);
 
   if (result->chars.words > 0) {
     printf("Word Analysis:\n");
     printf("  - Average word length: %.2f characters\n",
            result->words.average_length);
-    printf("  - Longest word: \"%s\" (%zu characters)\n", result->words.longest,
-           strlen(result->words.longest));
-    printf("  - Shortest word: \"%s\" (%zu characters)\n\n",
-           result->words.shortest, strlen(result->words.shortest));
+    printf("  - Longest word: \"%s\" (%lld characters)\n",
+           result->words.longest, result->words.longest_length);
+    printf("  - Shortest word: \"%s\" (%lld characters)\n\n",
+           result->words.shortest, result->words.shortest_length);
+  }
+
+  if (result->chars.total_chars == 0) {
+    return;
   }
 
   printf("Character Distribution:\n");
-  printf("  - Letters: %d (%.2f%%)\n", result->chars.letters,
+  printf("  - Letters: %lld (%.2f%%)\n", result->chars.letters,
          (result->chars.letters * 100.0) / result->chars.total_chars);
-  printf("  - Spaces: %d (%.2f%%)\n", result->chars.spaces,
+  printf("  - Spaces: %lld (%.2f%%)\n", result->chars.spaces,
          (result->chars.spaces * 100.0) / result->chars.total_chars);
-  printf("  - Punctuation: %d (%.2f%%)\n\n", result->chars.punctuation,
+  printf("  - Punctuation: %lld (%.2f%%)\n\n", result->chars.punctuation,
          (result->chars.punctuation * 100.0) / result->chars.total_chars);
 
   printf("Vowel Frequency:\n  ");
   const char vowels[] = "aeiou";
   for (int i = 0; i < VOWEL_COUNT; i++) {
-    printf("%c: %d", vowels[i], result->alphabet.vowel_counts[i]);
+    printf("%c: %lld", vowels[i], result->alphabet.vowel_counts[i]);
     if (i < VOWEL_COUNT - 1) {
       printf(", ");
     }
   }
 
+  printf("\n\nLetter Histogram:\n");
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    double share = (result->chars.letters > 0)
+                       ? result->alphabet.letter_counts[i] * 100.0 /
+                             result->chars.letters
+                       : 0.0;
+    printf("  %c: %6.2f%%%s", 'a' + i, share, (i % 6 == 5) ? "\n" : "");
+  }
+
   printf("\n\nPangram Detection:\n");
   printf("  - Unique letters used: %d/%d\n", result->alphabet.unique_letters,
          ALPHABET_SIZE);
   printf("  - Is pangram? ");
   if (result->alphabet.unique_letters == ALPHABET_SIZE) {
     printf("YES\n");
-    printf("  - (Contains all 26 letters of the alphabet)\n");
+    printf("  - (Contains all 26 letters of the alphabet)\n\n");
   } else {
     printf("NO\n");
-    printf("  - (Missing %d letters)\n",
+    printf("  - (Missing %d letters)\n\n",
            ALPHABET_SIZE - result->alphabet.unique_letters);
   }
 }
 
 void run_text_analysis(void) {
-  char buffer[MAX_BUFFER] = "";
+  char line[MAX_LINE];
+  TextStream ts;
+  TextAnalysisResult result;
+
+  printf("\nEnter text (type END on a new line to finish):\n\n");
+
+  // Lines go straight into the analyzer: no limit on the total size
+  text_stream_init(&ts);
+  while (fgets(line, sizeof(line), stdin)) {
+    if (strncmp(line, "END", 3) == 0 &&
+        (line[3] == '\n' || line[3] == '\r' || line[3] == '\0')) {
+      break;
+    }
+    text_stream_feed(&ts, line, strlen(line));
+  }
+
+  text_stream_finish(&ts, &result);
+  show_analysis_results(&result);
+}
 
-  Status status = read_text_input(buffer, MAX_BUFFER);
+void run_file_analysis(void) {
+  char path[MAX_PATH];
+  TextAnalysisResult result;
+
+  printf("\nEnter file path ('-' reads the rest of stdin): ");
+  if (read_string(path, sizeof(path)) != SUCCESS || strlen(path) == 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  FILE *file = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+  if (file == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+
+  double start = now_seconds();
+  Status status = analyze_file(file, &result);
+  double elapsed = now_seconds() - start;
+  if (file != stdin) {
+    fclose(file);
+  }
   if (status != SUCCESS) {
-    printf("Error: Failed to read input.\n");
+    handle_error(status);
+    return;
+  }
+
+  show_analysis_results(&result);
+  printf("Throughput:\n");
+  printf("  - %.1f MB in %.3f s (%.2f GB/s)\n\n",
+         (double)result.chars.total_chars / MB, elapsed,
+         elapsed > 0.0 ? result.chars.total_chars / elapsed / 1e9 : 0.0);
+}
+
+void run_benchmark(void) {
+  int size_mb = 0;
+
+  printf("\nEnter text size in MB (e.g., 256, 1024): ");
+  if (read_integer(&size_mb) != SUCCESS || size_mb <= 0) {
+    handle_error(ERR_INVALID_INPUT);
     return;
   }
 
-  TextAnalysisResult result = analyze_text_logic(buffer);
-  if (result.status == SUCCESS) {
-    show_analysis_results(&result);
+  size_t len = (size_t)size_mb * MB;
+  char *text = (char *)malloc(len + 1);
+  if (text == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
   }
+  fill_sample_text(text, len);
+
+  double start = now_seconds();
+  TextAnalysisResult scalar = analyze_text_scalar(text);
+  double scalar_time = now_seconds() - start;
+
+  start = now_seconds();
+  TextAnalysisResult fast = analyze_text_logic(text);
+  double fast_time = now_seconds() - start;
+
+  printf("\n=== Text Analysis Throughput: %d MB ===\n\n", size_mb);
+  printf("%-28s | %-9s | %s\n", "Analyzer", "Time (s)", "GB/s");
+  printf("-----------------------------|-----------|--------\n");
+  printf("%-28s | %9.3f | %6.2f\n", "Per-character (ctype)", scalar_time,
+         scalar_time > 0.0 ? len / scalar_time / 1e9 : 0.0);
+  printf("%-28s | %9.3f | %6.2f\n",
+         use_avx2 ? "Streaming (histogram + AVX2)"
+                  : "Streaming (histogram + SSE2)",
+         fast_time, fast_time > 0.0 ? len / fast_time / 1e9 : 0.0);
+  printf("\n  - Results %s\n\n",
+         same_results(&scalar, &fast) ? "match" : "DIFFER");
+
+  free(text);
 }
 
-Status read_text_input(char *buffer, int max_size) {
-  char line[256];
-  int current_length = 0;
+void run_word_frequency(void) {
+  char path[MAX_PATH];
+  int k = 0;
+  WordTable table;
 
-  while (TRUE) {
-    if (!fgets(line, sizeof(line), stdin)) {
-      break;
+  printf("\nHow many top words (1-%d): ", MAX_TOP_K);
+  if (read_integer(&k) != SUCCESS || k < 1 || k > MAX_TOP_K) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+  printf("Enter file path ('-' reads the rest of stdin): ");
+  if (read_string(path, sizeof(path)) != SUCCESS || strlen(path) == 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  // A file is split across threads; stdin can only be streamed
+  Status status = SUCCESS;
+  double start = now_seconds();
+  if (strcmp(path, "-") == 0) {
+    status = frequency_stream(stdin, &table);
+  } else {
+    status = frequency_parallel(path, &table);
+  }
+  double elapsed = now_seconds() - start;
+  if (status != SUCCESS) {
+    handle_error(status);
+    word_table_free(&table);
+    return;
+  }
+
+  show_top_words(&table, (size_t)k);
+  printf("\n  - Words: %lld (%zu distinct)\n", table.total_words, table.used);
+  printf("  - Table + arena: %.1f MB\n", (double)word_table_bytes(&table) / MB);
+  printf("  - %.1f MB in %.3f s (%.2f GB/s)\n\n",
+         (double)table.total_bytes / MB, elapsed,
+         elapsed > 0.0 ? table.total_bytes / elapsed / 1e9 : 0.0);
+  word_table_free(&table);
+}
+
+void run_frequency_benchmark(void) {
+  const size_t k = 10;
+  int size_mb = 0;
+  int matches = FALSE;
+  long peak_kb = 0;
+  WordTable single;
+  WordTable parallel;
+
+  printf("\nEnter corpus size in MB (e.g., 256, 1024): ");
+  if (read_integer(&size_mb) != SUCCESS || size_mb <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("\nWriting %d MB corpus to %s...\n", size_mb, CORPUS_FILENAME);
+  Status status = write_corpus(CORPUS_FILENAME, (size_t)size_mb * MB);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  FILE *file = fopen(CORPUS_FILENAME, "rb");
+  if (file == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+  double start = now_seconds();
+  status = frequency_stream(file, &single);
+  double single_time = now_seconds() - start;
+  fclose(file);
+
+  start = now_seconds();
+  if (status == SUCCESS) {
+    status = frequency_parallel(CORPUS_FILENAME, &parallel);
+  } else {
+    word_table_init(&parallel);
+  }
+  double parallel_time = now_seconds() - start;
+
+  if (status != SUCCESS) {
+    handle_error(status);
+    word_table_free(&single);
+    word_table_free(&parallel);
+    remove(CORPUS_FILENAME);
+    return;
+  }
+
+  printf("Running the sort | uniq -c pipeline...\n");
+  double pipe_time =
+      pipeline_baseline(CORPUS_FILENAME, k, &parallel, &matches, &peak_kb);
+
+  int threads = online_cpus() < MAX_THREADS ? online_cpus() : MAX_THREADS;
+  double bytes = (double)single.total_bytes;
+  printf("\n=== Word Frequency: %d MB, %zu distinct words ===\n\n", size_mb,
+         parallel.used);
+  printf("%-24s | %-9s | %-8s | %s\n", "Engine", "Time (s)", "MB/s",
+         "Memory (MB)");
+  printf("-------------------------|-----------|----------|------------\n");
+  printf("%-24s | %9.3f | %8.1f | %11.1f\n", "Hash table (1 thread)",
+         single_time, single_time > 0.0 ? bytes / MB / single_time : 0.0,
+         (double)word_table_bytes(&single) / MB);
+  printf("Hash table (%2d threads)  | %9.3f | %8.1f | %11.1f\n", threads,
+         parallel_time, parallel_time > 0.0 ? bytes / MB / parallel_time : 0.0,
+         (double)word_table_bytes(&parallel) / MB);
+  if (pipe_time >= 0.0) {
+    printf("%-24s | %9.3f | %8.1f | %11.1f\n", "sort | uniq -c", pipe_time,
+           pipe_time > 0.0 ? bytes / MB / pipe_time : 0.0,
+           (double)peak_kb / 1024.0);
+  } else {
+    printf("%-24s | %9s | %8s | %11s\n", "sort | uniq -c", "n/a", "n/a",
+           "n/a");
+  }
+
+  printf("\n  - Memory: table + arena for the engine, peak RSS of the "
+         "largest\n    pipeline process (sort) for the baseline\n");
+  printf("  - Thread tables match the single table: %s\n",
+         (single.total_words == parallel.total_words &&
+          single.used == parallel.used)
+             ? "yes"
+             : "NO");
+  printf("  - Top-%zu counts match the pipeline: %s\n", k,
+         pipe_time < 0.0 ? "n/a" : (matches ? "yes" : "NO"));
+  show_top_words(&parallel, k);
+  printf("\n");
+
+  word_table_free(&single);
+  word_table_free(&parallel);
+  remove(CORPUS_FILENAME);
+}
+
+void clear_input_buffer(void) {
+  int c;
+  while ((c = getchar()) != '\n' && c != EOF) {
+    ;
+  }
+}
+
+Status read_integer(int *value) {
+  if (scanf("%d", value) != 1) {
+    clear_input_buffer();
+    return ERR_INVALID_INPUT;
+  }
+  clear_input_buffer();
+  return SUCCESS;
+}
+
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
+    return ERR_INVALID_INPUT;
+  }
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+  }
+  return SUCCESS;
+}
+
+int online_cpus(void) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return (cpus > 0) ? (int)cpus : 1;
+}
+
+double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+TextAnalysisResult analyze_text_logic(const char *text) {
+  TextStream ts;
+  TextAnalysisResult result;
+
+  text_stream_init(&ts);
+  text_stream_feed(&ts, text, strlen(text));
+  text_stream_finish(&ts, &result);
+  return result;
+}
+
+Status analyze_file(FILE *file, TextAnalysisResult *result) {
+  TextStream ts;
+  char *buffer = (char *)malloc(STREAM_CHUNK);
+  if (buffer == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  text_stream_init(&ts);
+  size_t n;
+  while ((n = fread(buffer, 1, STREAM_CHUNK, file)) > 0) {
+    text_stream_feed(&ts, buffer, n);
+  }
+  Status status = ferror(file) ? ERR_READ_FAILED : SUCCESS;
+
+  text_stream_finish(&ts, result);
+  free(buffer);
+  return status;
+}
+
+void text_stream_init(TextStream *ts) {
+  memset(ts, 0, sizeof(*ts));
+  ts->word_start = -1;
+}
+
+void text_stream_feed(TextStream *ts, const char *chunk, size_t n) {
+  size_t i = 0;
+
+  // Every class count (letters, vowels, spaces, ...) comes from this
+  count_histogram(ts->histogram, (const unsigned char *)chunk, n);
+
+  // Word boundaries need order, so they come from a 32-bit letter mask
+#ifdef __x86_64__
+  if (use_avx2) {
+    i = scan_words_avx2(ts, chunk, n);
+  }
+#endif
+
+  for (; i < n; i += 32) {
+    int bits = (n - i < 32) ? (int)(n - i) : 32;
+    scan_letter_mask(ts, chunk, i, letter_mask(chunk + i, bits), bits);
+  }
+
+  // The open word outlives this chunk: keep its first letters
+  if (ts->run > 0 && ts->word_start >= 0) {
+    size_t len = n - (size_t)ts->word_start;
+    ts->partial_len =
+        (len < MAX_WORD_LENGTH - 1) ? (int)len : MAX_WORD_LENGTH - 1;
+    memcpy(ts->partial, chunk + ts->word_start, ts->partial_len);
+  } else if (ts->run > 0 && ts->partial_len < MAX_WORD_LENGTH - 1) {
+    size_t room = MAX_WORD_LENGTH - 1 - ts->partial_len;
+    size_t take = (n < room) ? n : room;
+    memcpy(ts->partial + ts->partial_len, chunk, take);
+    ts->partial_len += (int)take;
+  }
+  ts->word_start = -1;
+}
+
+void scan_letter_mask(TextStream *ts, const char *chunk, size_t base,
+                      unsigned mask, int bits) {
+  unsigned full = (bits == 32) ? 0xFFFFFFFFu : (1u << bits) - 1;
+  unsigned carry = (ts->run > 0);
+
+  // A word starts at every letter that follows a non-letter
+  ts->words += __builtin_popcount(mask & ~((mask << 1) | carry));
+
+  if (mask == full) {
+    if (ts->run == 0) {
+      ts->word_start = (long)base;
     }
+    ts->run += bits;
+    return;
+  }
 
-    if (strncmp(line, "END", 3) == 0 &&
-        (line[3] == '\n' || line[3] == '\r' || line[3] == '\0')) {
-      break;
+  if (!word_ends_matter(ts, mask, bits)) {
+    // Only the word left open at the top of the block is still needed
+    unsigned gaps = ~mask & full;
+    int top = bits - 1 - (31 - __builtin_clz(gaps));
+    ts->run = top;
+    ts->word_start = (long)(base + bits - top);
+    return;
+  }
+
+  int i = 0;
+  while (i < bits) {
+    if (ts->run == 0) {
+      unsigned rest = mask >> i;
+      if (rest == 0) {
+        return;
+      }
+      i += __builtin_ctz(rest);
+      ts->word_start = (long)(base + i);
     }
 
-    int line_len = strlen(line);
-    if (current_length + line_len >= max_size - 1) {
-      return ERR_BUFFER_OVERFLOW;
+    // Separators past 'bits' are zero in mask, so ~mask stops the run
+    unsigned gaps = ~mask >> i;
+    int len = (gaps == 0) ? bits - i : __builtin_ctz(gaps);
+    if (len > bits - i) {
+      len = bits - i;
     }
+    ts->run += len;
+    i += len;
+    if (i < bits) {
+      end_word(ts, chunk, base + i);
+    }
+  }
+}
 
-    strcat(buffer, line);
-    current_length += line_len;
+int word_ends_matter(const TextStream *ts, unsigned mask, int bits) {
+  const WordStats *ws = &ts->word_stats;
+  unsigned full = (bits == 32) ? 0xFFFFFFFFu : (1u << bits) - 1;
+  unsigned gaps = ~mask & full;
+  int leading = __builtin_ctz(gaps);
+  int highest_gap = 31 - __builtin_clz(gaps);
+
+  if (ws->longest_length == 0) {
+    return TRUE;
   }
 
-  return SUCCESS;
+  // The word carried in from earlier blocks ends in this one
+  unsigned inner = mask;
+  if (ts->run > 0) {
+    long long len = ts->run + leading;
+    if (len > ws->longest_length || len < ws->shortest_length) {
+      return TRUE;
+    }
+    inner &= ~((1u << leading) - 1);
+  }
+  // The word open at the top is judged in the block where it ends
+  if (highest_gap < 31) {
+    inner &= (1u << (highest_gap + 1)) - 1;
+  }
+  if (inner == 0) {
+    return FALSE;
+  }
+
+  // Longer than the longest: a run of longest + 1 letters
+  if (ws->longest_length < 32) {
+    unsigned run = inner;
+    for (int k = 1; k <= ws->longest_length && run != 0; k++) {
+      run &= inner >> k;
+    }
+    if (run != 0) {
+      return TRUE;
+    }
+  }
+
+  // Shorter than the shortest: a word end close enough to its start
+  if (ws->shortest_length > 1) {
+    unsigned starts = inner & ~(inner << 1);
+    unsigned ends = inner & ~(inner >> 1);
+    unsigned near = ends;
+    for (int k = 1; k < ws->shortest_length - 1 && k < 32; k++) {
+      near |= ends >> k;
+    }
+    if ((starts & near) != 0) {
+      return TRUE;
+    }
+  }
+  return FALSE;
 }
 
-TextAnalysisResult analyze_text_logic(const char *text) {
-  TextAnalysisResult result = {SUCCESS, {0}, {{0}, {0}, 0}, {"", "", 0.0}};
+void end_word(TextStream *ts, const char *chunk, size_t end) {
+  WordStats *ws = &ts->word_stats;
+  long long len = ts->run;
+  int longer = (ws->longest_length == 0 || len > ws->longest_length);
+  int shorter = (ws->shortest_length == 0 || len < ws->shortest_length);
+
+  ts->run = 0;
+  if (!longer && !shorter) {
+    return;
+  }
+
+  // Text of the word: saved prefix if it began in an earlier chunk
+  char word[MAX_WORD_LENGTH];
+  int copied = 0;
+  if (ts->word_start >= 0) {
+    copied = (len < MAX_WORD_LENGTH - 1) ? (int)len : MAX_WORD_LENGTH - 1;
+    memcpy(word, chunk + ts->word_start, copied);
+  } else {
+    copied = ts->partial_len;
+    memcpy(word, ts->partial, copied);
+    size_t rest = (chunk != NULL) ? end : 0;
+    while (copied < MAX_WORD_LENGTH - 1 && copied < len && rest > 0) {
+      word[copied] = chunk[end - rest];
+      copied++;
+      rest--;
+    }
+  }
+  word[copied] = '\0';
+
+  if (longer) {
+    ws->longest_length = len;
+    strcpy(ws->longest, word);
+  }
+  if (shorter) {
+    ws->shortest_length = len;
+    strcpy(ws->shortest, word);
+  }
+}
+
+void text_stream_finish(TextStream *ts, TextAnalysisResult *result) {
+  const unsigned long long *h = ts->histogram;
+
+  if (ts->run > 0) {
+    end_word(ts, NULL, 0);
+  }
+
+  memset(result, 0, sizeof(*result));
+  result->status = SUCCESS;
+  result->words = ts->word_stats;
+
+  for (int c = 0; c < 256; c++) {
+    result->chars.total_chars += (long long)h[c];
+    if (ispunct(c)) {
+      result->chars.punctuation += (long long)h[c];
+    }
+  }
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    long long count = (long long)(h['a' + i] + h['A' + i]);
+    result->alphabet.letter_counts[i] = count;
+    result->alphabet.alpha_present[i] = (count > 0);
+    result->alphabet.unique_letters += (count > 0);
+    result->chars.letters += count;
+
+    int vowel = get_vowel_index((char)('a' + i));
+    if (vowel >= 0) {
+      result->alphabet.vowel_counts[vowel] = count;
+    }
+  }
 
-  result.chars.total_chars = strlen(text);
+  result->chars.lines = (long long)h['\n'];
+  result->chars.sentences = (long long)(h['.'] + h['!'] + h['?']);
+  result->chars.spaces = (long long)(h[' '] + h['\t'] + h['\v'] + h['\f']);
+  result->chars.chars_no_space =
+      result->chars.letters + result->chars.punctuation;
+  result->chars.words = ts->words;
+
+  // Every letter belongs to exactly one word
+  if (ts->words > 0) {
+    result->words.average_length =
+        (double)result->chars.letters / (double)ts->words;
+  }
+}
+
+void count_histogram(unsigned long long *histogram, const unsigned char *p,
+                     size_t n) {
+  // Four tables break the store-to-load chain when a byte repeats
+  unsigned tables[4][256];
+
+  while (n > 0) {
+    size_t slice = (n < HISTOGRAM_SLICE) ? n : HISTOGRAM_SLICE;
+    size_t i = 0;
+
+    memset(tables, 0, sizeof(tables));
+    for (; i + 4 <= slice; i += 4) {
+      tables[0][p[i]]++;
+      tables[1][p[i + 1]]++;
+      tables[2][p[i + 2]]++;
+      tables[3][p[i + 3]]++;
+    }
+    for (; i < slice; i++) {
+      tables[0][p[i]]++;
+    }
+
+    for (int c = 0; c < 256; c++) {
+      histogram[c] += (unsigned long long)tables[0][c] + tables[1][c] +
+                      tables[2][c] + tables[3][c];
+    }
+    p += slice;
+    n -= slice;
+  }
+}
+
+int is_letter(unsigned char c) {
+  return (unsigned char)((c | 0x20) - 'a') < ALPHABET_SIZE;
+}
+
+unsigned letter_mask(const char *p, int bits) {
+  unsigned mask = 0;
+
+#ifdef __x86_64__
+  if (bits == 32) {
+    // SSE2 has no byte shuffle: letters = ((c | 0x20) - 'a') <= 25
+    __m128i lower = _mm_set1_epi8(0x20);
+    __m128i a = _mm_set1_epi8('a');
+    __m128i last = _mm_set1_epi8(25);
+    for (int half = 0; half < 2; half++) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(p + half * 16));
+      __m128i d = _mm_sub_epi8(_mm_or_si128(v, lower), a);
+      __m128i letter = _mm_cmpeq_epi8(_mm_min_epu8(d, last), d);
+      mask |= (unsigned)_mm_movemask_epi8(letter) << (half * 16);
+    }
+    return mask;
+  }
+#endif
+
+  for (int b = 0; b < bits; b++) {
+    mask |= (unsigned)is_letter((unsigned char)p[b]) << b;
+  }
+  return mask;
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) size_t
+scan_words_avx2(TextStream *ts, const char *chunk, size_t n) {
+  // Nibble tables: letter iff lo_lut[low nibble] & hi_lut[high nibble].
+  // Bit 0: 0x41-0x4F / 0x61-0x6F, bit 1: 0x50-0x5A / 0x70-0x7A
+  const __m256i lo_lut = _mm256_setr_epi8(
+      2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 1, 2, 3, 3, 3, 3, 3, 3,
+      3, 3, 3, 3, 1, 1, 1, 1, 1);
+  const __m256i hi_lut = _mm256_setr_epi8(
+      0, 0, 0, 0, 1, 2, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 1,
+      2, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(chunk + i));
+    __m256i lo = _mm256_and_si256(v, nibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    __m256i cls = _mm256_and_si256(_mm256_shuffle_epi8(lo_lut, lo),
+                                   _mm256_shuffle_epi8(hi_lut, hi));
+    unsigned mask =
+        ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cls, zero));
+    scan_letter_mask(ts, chunk, i, mask, 32);
+  }
+  return i;
+}
+#endif
+
+TextAnalysisResult analyze_text_scalar(const char *text) {
+  TextAnalysisResult result;
+  memset(&result, 0, sizeof(result));
+
+  result.chars.total_chars = (long long)strlen(text);
 
   char current_word[MAX_WORD_LENGTH];
   size_t word_idx = 0;
   double total_word_len = 0;
 
-  for (int i = 0; i <= result.chars.total_chars; i++) {
+  for (long long i = 0; i <= result.chars.total_chars; i++) {
     char c = text[i];
 
     if (c == '\n') {
@@ -190,6 +995,7 @@ TextAnalysisResult analyze_text_logic(const char *text) {
       result.chars.letters++;
       result.chars.chars_no_space++;
       result.alphabet.alpha_present[tolower(c) - 'a'] = TRUE;
+      result.alphabet.letter_counts[tolower(c) - 'a']++;
 
       if (is_vowel(c)) {
         int idx = get_vowel_index(c);
@@ -234,6 +1040,8 @@ TextAnalysisResult analyze_text_logic(const char *text) {
   if (result.chars.words > 0) {
     result.words.average_length = total_word_len / result.chars.words;
   }
+  result.words.longest_length = (long long)strlen(result.words.longest);
+  result.words.shortest_length = (long long)strlen(result.words.shortest);
 
   for (int i = 0; i < ALPHABET_SIZE; i++) {
     if (result.alphabet.alpha_present[i]) {
@@ -265,3 +1073,594 @@ int get_vowel_index(char c) {
     return -1;
   }
 }
+
+void fill_sample_text(char *text, size_t len) {
+  static const char *words[] = {"the",    "Quick", "brown",   "fox",
+                                "jumps",  "over",  "a",       "lazy",
+                                "dog",    "while", "analysis", "of",
+                                "text",   "runs",  "at",      "memory",
+                                "speed",  "I",     "zebra",   "vexing"};
+  static const char *separators[] = {" ", " ", " ", " ", ", ", ". ", "! ",
+                                     "? ", "\n", "; ", " (", ") "};
+  const int num_words = (int)(sizeof(words) / sizeof(words[0]));
+  const int num_separators = (int)(sizeof(separators) / sizeof(separators[0]));
+  size_t i = 0;
+
+  while (i < len) {
+    const char *w = words[rand() % num_words];
+    const char *s = separators[rand() % num_separators];
+    for (; *w && i < len; w++) {
+      text[i++] = *w;
+    }
+    for (; *s && i < len; s++) {
+      text[i++] = *s;
+    }
+  }
+  text[len] = '\0';
+}
+
+int same_results(const TextAnalysisResult *a, const TextAnalysisResult *b) {
+  return a->chars.total_chars == b->chars.total_chars &&
+         a->chars.chars_no_space == b->chars.chars_no_space &&
+         a->chars.words == b->chars.words &&
+         a->chars.sentences == b->chars.sentences &&
+         a->chars.lines == b->chars.lines &&
+         a->chars.letters == b->chars.letters &&
+         a->chars.spaces == b->chars.spaces &&
+         a->chars.punctuation == b->chars.punctuation &&
+         memcmp(&a->alphabet, &b->alphabet, sizeof(a->alphabet)) == 0 &&
+         strcmp(a->words.longest, b->words.longest) == 0 &&
+         strcmp(a->words.shortest, b->words.shortest) == 0;
+}
+
+void word_table_init(WordTable *table) {
+  // Slots are allocated on the first insert
+  memset(table, 0, sizeof(*table));
+}
+
+void word_table_free(WordTable *table) {
+  free(table->slots);
+  while (table->arena != NULL) {
+    ArenaBlock *next = table->arena->next;
+    free(table->arena);
+    table->arena = next;
+  }
+  word_table_init(table);
+}
+
+Status word_table_feed(WordTable *table, const char *chunk, size_t n) {
+  long start = -1; // Offset of the open word if it began in this chunk
+
+  table->total_bytes += (long long)n;
+  for (size_t i = 0; i < n; i += 32) {
+    int bits = (n - i < 32) ? (int)(n - i) : 32;
+    unsigned mask = letter_mask(chunk + i, bits);
+    int pos = 0;
+
+    // One step per word, not per byte
+    while (pos < bits) {
+      if (start < 0 && table->token_len == 0) {
+        unsigned rest = mask >> pos;
+        if (rest == 0) {
+          break;
+        }
+        pos += __builtin_ctz(rest);
+        start = (long)(i + pos);
+      }
+
+      unsigned gaps = ~mask >> pos;
+      pos += (gaps == 0) ? bits - pos : __builtin_ctz(gaps);
+      if (pos < bits) {
+        Status status = word_table_end_word(table, chunk, start, i + pos);
+        start = -1;
+        if (status != SUCCESS) {
+          return status;
+        }
+      }
+    }
+  }
+
+  // The open word outlives this chunk: keep its letters
+  size_t from = (start >= 0) ? (size_t)start : 0;
+  if (start >= 0 || table->token_len > 0) {
+    for (; from < n && table->token_len < MAX_TOKEN - 1; from++) {
+      table->token[table->token_len++] = (char)(chunk[from] | 0x20);
+    }
+  }
+  return SUCCESS;
+}
+
+Status word_table_end_word(WordTable *table, const char *chunk, long start,
+                           size_t end) {
+  char word[MAX_TOKEN];
+  uint32_t len = 0;
+
+  if (start >= 0) {
+    // Letters only, so | 0x20 is the lower case
+    const char *p = chunk + start;
+    len = (uint32_t)(end - (size_t)start);
+    if (len > MAX_TOKEN - 1) {
+      len = MAX_TOKEN - 1;
+    }
+    for (uint32_t j = 0; j < len; j++) {
+      word[j] = (char)(p[j] | 0x20);
+    }
+  } else {
+    // Began in an earlier chunk: the head is already in token
+    len = (uint32_t)table->token_len;
+    memcpy(word, table->token, len);
+    for (size_t j = 0; j < end && len < MAX_TOKEN - 1; j++) {
+      word[len++] = (char)(chunk[j] | 0x20);
+    }
+    table->token_len = 0;
+  }
+  return word_table_add(table, word, len, hash_word(word, len), 1);
+}
+
+Status word_table_finish(WordTable *table) {
+  uint32_t len = (uint32_t)table->token_len;
+
+  table->token_len = 0;
+  if (len == 0) {
+    return SUCCESS;
+  }
+  return word_table_add(table, table->token, len,
+                        hash_word(table->token, len), 1);
+}
+
+Status word_table_add(WordTable *table, const char *word, uint32_t length,
+                      uint32_t hash, long long count) {
+  char key[SHORT_WORD] = {0};
+  int is_short = (length < SHORT_WORD);
+
+  // Keep the load factor under 70% so probe runs stay short
+  if ((table->used + 1) * 10 > table->capacity * 7) {
+    Status status = word_table_grow(table);
+    if (status != SUCCESS) {
+      return status;
+    }
+  }
+
+  if (is_short) {
+    memcpy(key, word, length);
+  }
+  size_t mask = table->capacity - 1;
+  size_t i = hash & mask;
+  while (table->slots[i].count != 0) {
+    WordEntry *entry = &table->slots[i];
+    if (entry->hash == hash && entry->length == length &&
+        (is_short ? memcmp(entry->key.text, key, SHORT_WORD) == 0
+                  : memcmp(entry->key.long_word, word, length) == 0)) {
+      entry->count += count;
+      table->total_words += count;
+      return SUCCESS;
+    }
+    i = (i + 1) & mask;
+  }
+
+  WordEntry *entry = &table->slots[i];
+  if (is_short) {
+    memcpy(entry->key.text, key, SHORT_WORD);
+  } else {
+    entry->key.long_word = arena_store(table, word, length);
+    if (entry->key.long_word == NULL) {
+      return ERR_MEMORY_ALLOCATION;
+    }
+  }
+  entry->count = count;
+  entry->hash = hash;
+  entry->length = length;
+  table->used++;
+  table->total_words += count;
+  return SUCCESS;
+}
+
+Status word_table_grow(WordTable *table) {
+  size_t capacity =
+      (table->capacity == 0) ? TABLE_MIN_CAPACITY : table->capacity * 2;
+  WordEntry *slots = (WordEntry *)calloc(capacity, sizeof(WordEntry));
+  if (slots == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Stored hashes make the rehash a pure move: no word is read again
+  for (size_t i = 0; i < table->capacity; i++) {
+    if (table->slots[i].count == 0) {
+      continue;
+    }
+    size_t j = table->slots[i].hash & (capacity - 1);
+    while (slots[j].count != 0) {
+      j = (j + 1) & (capacity - 1);
+    }
+    slots[j] = table->slots[i];
+  }
+
+  free(table->slots);
+  table->slots = slots;
+  table->capacity = capacity;
+  return SUCCESS;
+}
+
+Status word_table_merge(WordTable *total, const WordTable *part) {
+  for (size_t i = 0; i < part->capacity; i++) {
+    const WordEntry *entry = &part->slots[i];
+    if (entry->count == 0) {
+      continue;
+    }
+    Status status = word_table_add(total, entry_word(entry), entry->length,
+                                   entry->hash, entry->count);
+    if (status != SUCCESS) {
+      return status;
+    }
+  }
+  total->total_bytes += part->total_bytes;
+  return SUCCESS;
+}
+
+const WordEntry *word_table_find(const WordTable *table, const char *word) {
+  uint32_t length = (uint32_t)strlen(word);
+  uint32_t hash = hash_word(word, length);
+
+  if (table->capacity == 0) {
+    return NULL;
+  }
+  size_t mask = table->capacity - 1;
+  for (size_t i = hash & mask; table->slots[i].count != 0;
+       i = (i + 1) & mask) {
+    const WordEntry *entry = &table->slots[i];
+    if (entry->hash == hash && entry->length == length &&
+        memcmp(entry_word(entry), word, length) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+const char *entry_word(const WordEntry *entry) {
+  return (entry->length < SHORT_WORD) ? entry->key.text
+                                      : entry->key.long_word;
+}
+
+size_t word_table_bytes(const WordTable *table) {
+  return table->capacity * sizeof(WordEntry) +
+         table->arena_blocks * sizeof(ArenaBlock);
+}
+
+char *arena_store(WordTable *table, const char *word, uint32_t length) {
+  ArenaBlock *block = table->arena;
+
+  if (block == NULL || block->used + length + 1 > ARENA_BLOCK) {
+    block = (ArenaBlock *)malloc(sizeof(ArenaBlock));
+    if (block == NULL) {
+      return NULL;
+    }
+    block->next = table->arena;
+    block->used = 0;
+    table->arena = block;
+    table->arena_blocks++;
+  }
+
+  char *copy = block->data + block->used;
+  memcpy(copy, word, length);
+  copy[length] = '\0';
+  block->used += length + 1;
+  return copy;
+}
+
+uint32_t hash_word(const char *word, uint32_t length) {
+  // 8 bytes per multiply instead of FNV's one
+  uint64_t h = length * 0x9E3779B97F4A7C15ULL;
+  uint32_t i = 0;
+
+  for (; i + 8 <= length; i += 8) {
+    uint64_t block;
+    memcpy(&block, word + i, sizeof(block));
+    h = (h ^ block) * 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 32;
+  }
+  if (i < length) {
+    uint64_t tail = 0;
+    memcpy(&tail, word + i, length - i);
+    h = (h ^ tail) * 0xFF51AFD7ED558CCDULL;
+  }
+  h ^= h >> 29;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 32;
+  return (uint32_t)h;
+}
+
+Status frequency_stream(FILE *file, WordTable *table) {
+  word_table_init(table);
+  char *buffer = (char *)malloc(STREAM_CHUNK);
+  if (buffer == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  Status status = SUCCESS;
+  size_t n;
+  while (status == SUCCESS &&
+         (n = fread(buffer, 1, STREAM_CHUNK, file)) > 0) {
+    status = word_table_feed(table, buffer, n);
+  }
+  if (status == SUCCESS) {
+    status = ferror(file) ? ERR_READ_FAILED : word_table_finish(table);
+  }
+
+  free(buffer);
+  return status;
+}
+
+Status frequency_parallel(const char *path, WordTable *table) {
+  pthread_t threads[MAX_THREADS];
+  FrequencyJob jobs[MAX_THREADS];
+  int running[MAX_THREADS] = {FALSE};
+  struct stat st;
+
+  word_table_init(table);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return ERR_READ_FAILED;
+  }
+  size_t size = (size_t)st.st_size;
+  if (size == 0) {
+    close(fd);
+    return SUCCESS;
+  }
+
+  char *data = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return ERR_READ_FAILED;
+  }
+  posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+
+  // Small files are not worth a thread (and a table) each
+  int num_threads = online_cpus();
+  if (num_threads > MAX_THREADS) {
+    num_threads = MAX_THREADS;
+  }
+  if ((size_t)num_threads > size / MB + 1) {
+    num_threads = (int)(size / MB + 1);
+  }
+
+  // Each cut moves forward to the next non-letter so no word is split
+  size_t cut = 0;
+  for (int t = 0; t < num_threads; t++) {
+    size_t end = (t == num_threads - 1) ? size : size / num_threads * (t + 1);
+    if (end < cut) {
+      end = cut;
+    }
+    while (end < size && is_letter((unsigned char)data[end])) {
+      end++;
+    }
+    jobs[t].data = data;
+    jobs[t].start = cut;
+    jobs[t].end = end;
+    cut = end;
+    running[t] = t > 0 &&
+                 pthread_create(&threads[t], NULL, frequency_worker,
+                                &jobs[t]) == 0;
+    if (t > 0 && !running[t]) {
+      frequency_worker(&jobs[t]);
+    }
+  }
+  frequency_worker(&jobs[0]);
+
+  // Thread 0's table becomes the result; the others are folded into it
+  Status status = SUCCESS;
+  for (int t = 0; t < num_threads; t++) {
+    if (running[t]) {
+      pthread_join(threads[t], NULL);
+    }
+    if (status == SUCCESS) {
+      status = jobs[t].status;
+    }
+  }
+  *table = jobs[0].table;
+  for (int t = 1; t < num_threads; t++) {
+    if (status == SUCCESS) {
+      status = word_table_merge(table, &jobs[t].table);
+    }
+    word_table_free(&jobs[t].table);
+  }
+
+  munmap(data, size);
+  return status;
+}
+
+void *frequency_worker(void *arg) {
+  FrequencyJob *job = (FrequencyJob *)arg;
+
+  word_table_init(&job->table);
+  job->status = word_table_feed(&job->table, job->data + job->start,
+                                job->end - job->start);
+  if (job->status == SUCCESS) {
+    job->status = word_table_finish(&job->table);
+  }
+  return NULL;
+}
+
+size_t top_words(const WordTable *table, const WordEntry **top, size_t k) {
+  size_t n = 0;
+
+  // Min-heap of the k best so far: the root is the one to beat
+  for (size_t i = 0; i < table->capacity && k > 0; i++) {
+    const WordEntry *entry = &table->slots[i];
+    if (entry->count == 0) {
+      continue;
+    }
+    if (n < k) {
+      size_t c = n++;
+      top[c] = entry;
+      while (c > 0 && ranks_before(top[(c - 1) / 2], top[c])) {
+        const WordEntry *swap = top[c];
+        top[c] = top[(c - 1) / 2];
+        top[(c - 1) / 2] = swap;
+        c = (c - 1) / 2;
+      }
+    } else if (ranks_before(entry, top[0])) {
+      top[0] = entry;
+      sift_down(top, n, 0);
+    }
+  }
+
+  // Moving the root to the back each time leaves the best word first
+  for (size_t end = n; end > 1; end--) {
+    const WordEntry *swap = top[0];
+    top[0] = top[end - 1];
+    top[end - 1] = swap;
+    sift_down(top, end - 1, 0);
+  }
+  return n;
+}
+
+int ranks_before(const WordEntry *a, const WordEntry *b) {
+  if (a->count != b->count) {
+    return a->count > b->count;
+  }
+  return strcmp(entry_word(a), entry_word(b)) < 0;
+}
+
+void sift_down(const WordEntry **heap, size_t n, size_t i) {
+  while (TRUE) {
+    size_t worst = i;
+    size_t left = 2 * i + 1;
+    size_t right = left + 1;
+    if (left < n && ranks_before(heap[worst], heap[left])) {
+      worst = left;
+    }
+    if (right < n && ranks_before(heap[worst], heap[right])) {
+      worst = right;
+    }
+    if (worst == i) {
+      return;
+    }
+    const WordEntry *swap = heap[i];
+    heap[i] = heap[worst];
+    heap[worst] = swap;
+    i = worst;
+  }
+}
+
+void show_top_words(const WordTable *table, size_t k) {
+  const WordEntry **top = (const WordEntry **)malloc(k * sizeof(*top));
+  if (top == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  size_t n = top_words(table, top, k);
+  printf("\n%-5s | %-24s | %12s | %s\n", "Rank", "Word", "Count", "Share");
+  printf("------|--------------------------|--------------|--------\n");
+  for (size_t i = 0; i < n; i++) {
+    printf("%5zu | %-24s | %12lld | %6.2f%%\n", i + 1, entry_word(top[i]),
+           top[i]->count, top[i]->count * 100.0 / table->total_words);
+  }
+  free(top);
+}
+
+Status write_corpus(const char *path, size_t size) {
+  static const char *separators[] = {" ", " ", " ", " ", ", ", ". ", "\n"};
+  const int num_separators = (int)(sizeof(separators) / sizeof(separators[0]));
+  const size_t stride = 16;
+
+  // Random vocabulary, picked log-uniformly: close to Zipf's law
+  char *vocabulary = (char *)malloc(CORPUS_VOCABULARY * stride);
+  char *buffer = (char *)malloc(STREAM_CHUNK);
+  FILE *file = fopen(path, "wb");
+  if (vocabulary == NULL || buffer == NULL || file == NULL) {
+    free(vocabulary);
+    free(buffer);
+    if (file != NULL) {
+      fclose(file);
+    }
+    return (file == NULL) ? ERR_WRITE_FAILED : ERR_MEMORY_ALLOCATION;
+  }
+  for (size_t i = 0; i < CORPUS_VOCABULARY; i++) {
+    int len = 2 + rand() % 11;
+    for (int j = 0; j < len; j++) {
+      vocabulary[i * stride + j] = (char)('a' + rand() % ALPHABET_SIZE);
+    }
+    vocabulary[i * stride + len] = '\0';
+  }
+
+  double log_vocabulary = log((double)CORPUS_VOCABULARY);
+  size_t written = 0;
+  size_t fill = 0;
+  Status status = SUCCESS;
+  while (status == SUCCESS && written + fill < size) {
+    double u = rand() / (RAND_MAX + 1.0);
+    size_t index = (size_t)exp(u * log_vocabulary) - 1;
+    const char *word = vocabulary + index * stride;
+    const char *sep = separators[rand() % num_separators];
+
+    // Capitalized now and then, so case folding has work to do
+    size_t start = fill;
+    for (; *word; word++) {
+      buffer[fill++] = *word;
+    }
+    if (rand() % 10 == 0) {
+      buffer[start] = (char)toupper((unsigned char)buffer[start]);
+    }
+    for (; *sep; sep++) {
+      buffer[fill++] = *sep;
+    }
+
+    if (fill > STREAM_CHUNK - 2 * stride || written + fill >= size) {
+      if (fwrite(buffer, 1, fill, file) != fill) {
+        status = ERR_WRITE_FAILED;
+      }
+      written += fill;
+      fill = 0;
+    }
+  }
+
+  if (fclose(file) != 0) {
+    status = ERR_WRITE_FAILED;
+  }
+  free(vocabulary);
+  free(buffer);
+  return status;
+}
+
+double pipeline_baseline(const char *path, size_t k, const WordTable *table,
+                         int *matches, long *peak_kb) {
+  char command[MAX_PATH + 256];
+  char line[MAX_LINE];
+  struct rusage usage;
+  int lines = 0;
+  int matched = 0;
+
+  // Same words as the engine: letter runs, folded to lower case
+  snprintf(command, sizeof(command),
+           "export LC_ALL=C; tr -cs 'A-Za-z' '\\n' < '%s' | tr 'A-Z' 'a-z' "
+           "| sort | uniq -c | sort -rn | head -n %zu",
+           path, k);
+
+  double start = now_seconds();
+  FILE *pipe = popen(command, "r");
+  if (pipe == NULL) {
+    return -1.0;
+  }
+  while (fgets(line, sizeof(line), pipe) != NULL) {
+    long long count = 0;
+    char word[MAX_TOKEN];
+    if (sscanf(line, "%lld %63s", &count, word) != 2) {
+      continue;
+    }
+    const WordEntry *entry = word_table_find(table, word);
+    lines++;
+    matched += (entry != NULL && entry->count == count);
+  }
+  pclose(pipe);
+  double elapsed = now_seconds() - start;
+
+  getrusage(RUSAGE_CHILDREN, &usage);
+  *peak_kb = usage.ru_maxrss;
+  *matches = (lines > 0 && matched == lines);
+  return elapsed;
+}
@@ -8,20 +8,67 @@
  - Dynamic Array Generation (Sorted)
  - Algorithm 1: Linear Search O(n)
  - Algorithm 2: Binary Search O(log n)
+ - Algorithm 3: Branchless Binary Search (cmov-style step, prefetch of both
+   possible next midpoints)
+ - Algorithm 4: Eytzinger (BFS order) layout search with prefetch
+ - Algorithm 5: Static B+-tree (S-tree, 16 keys per node) with AVX2 node
+   comparison and scalar fallback
+ - Scaling mode: ns per lookup for every engine from 1K to 1G elements
+ - Batch search API: K queries advance in lockstep with exact prefetch of
+   each next probe, overlapping memory latency across queries
+ - Multi-threaded batch mode (pthreads) and lookups/sec benchmark
+ - AVX2 linear scan (32 ints per step on sorted data, 8-wide tail)
+ - Interpolation search with exponential (galloping) correction, plus
+   plain exponential search
+ - Adaptive mode: picks SIMD scan / interpolation / branchless from size
+   and a uniformity test, using crossover points measured at runtime
  - Performance Metrics: Time (seconds) and Comparison Count
+ - Benchmark harness mode with repeated trials and CSV/JSON export
  - Automatic efficiency calculation and recommendation
  - Dynamic memory management with proper cleanup
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
+#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "bench_harness.h"
 
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 2
+#define MAX_OPTION 6
+#define BENCH_TARGETS 1024
+#define CACHE_LINE 64
+#define STREE_B 16
+#define STREE_MAX_HEIGHT 16
+#define SCALING_MIN_SIZE (1 << 10)
+#define SCALING_MAX_SIZE (1 << 30)
+#define SCALING_QUERIES (1 << 20)
+#define LINEAR_BUDGET (1L << 28)
+#define LINEAR_MIN_QUERIES 16
+#define BATCH_MAX_WIDTH 32
+#define BATCH_DEFAULT_WIDTH 16
+#define BATCH_THREADS 4
+#define CALIBRATION_QUERIES (1 << 16)
+#define CALIBRATION_SMALL_MAX 4096
+#define CALIBRATION_LARGE_MIN (1 << 10)
+#define CALIBRATION_LARGE_MAX (1 << 22)
+#define UNIFORMITY_SAMPLES 64
+#define UNIFORMITY_TOLERANCE 0.01
+#define NUM_SCALING_ENGINES (ENGINE_STREE + 1)
+#define FILES_DIR "files"
 
 typedef enum {
   SUCCESS,
@@ -36,22 +83,131 @@ typedef struct {
   double time_taken;
 } SearchResult;
 
+typedef struct {
+  int *keys; // Layer 0 holds the sorted keys, upper layers follow
+  size_t offsets[STREE_MAX_HEIGHT];
+  int height;
+  int size;
+  int simd;
+} STree;
+
+typedef enum {
+  ENGINE_LINEAR,
+  ENGINE_BINARY,
+  ENGINE_BRANCHLESS,
+  ENGINE_EYTZINGER,
+  ENGINE_STREE,
+  ENGINE_SIMD_LINEAR,
+  ENGINE_INTERPOLATION,
+  ENGINE_EXPONENTIAL,
+  ENGINE_ADAPTIVE,
+  NUM_ENGINES
+} SearchEngine;
+
+typedef enum {
+  MODE_SIMD_LINEAR,
+  MODE_INTERPOLATION,
+  MODE_BRANCHLESS
+} SearchMode;
+
+typedef struct {
+  int linear_crossover; // Largest size where the SIMD scan still wins
+  int interp_crossover; // Smallest uniform size where interpolation wins
+} SearchTuning;
+
+typedef struct {
+  const int *arr;
+  const int *eytz;
+  const STree *tree;
+  SearchMode mode;
+  int size;
+  int targets[BENCH_TARGETS];
+  int next;
+  long comparisons;
+  long sink;
+} SearchBench;
+
+typedef struct {
+  const int *arr;
+  int size;
+  const int *queries;
+  int count;
+  int *results;
+  int width;
+} BatchJob;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_comparison_mode(void);
 void run_algorithm_explanation(void);
+void run_harness_benchmark(void);
+void run_scaling_mode(void);
+void run_batch_mode(void);
+void run_adaptive_mode(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 
 Status generate_sorted_array(int **arr, int size);
+Status generate_skewed_array(int **arr, int size);
 SearchResult linear_search(const int *arr, int size, int target);
 SearchResult binary_search(const int *arr, int size, int target);
+int linear_search_core(const int *arr, int size, int target,
+                       long *comparisons);
+int binary_search_core(const int *arr, int size, int target,
+                       long *comparisons);
+int branchless_search(const int *arr, int size, int target);
+Status eytzinger_build(const int *arr, int size, int **eytz);
+int eytzinger_fill(const int *arr, int *eytz, int size, int i, size_t k);
+int eytzinger_search(const int *eytz, int size, int target);
+Status stree_build(const int *arr, int size, STree *tree);
+int stree_search(const STree *tree, int target);
+int stree_search_scalar(const STree *tree, int target);
+void stree_free(STree *tree);
+int cpu_has_avx2(void);
+int simd_linear_search(const int *arr, int size, int target);
+int scalar_scan(const int *arr, int from, int size, int target);
+#ifdef __x86_64__
+int stree_search_avx2(const STree *tree, int target);
+int simd_linear_search_avx2(const int *arr, int size, int target);
+#endif
+int interpolation_search(const int *arr, int size, int target);
+int exponential_search(const int *arr, int size, int target);
+int gallop_search(const int *arr, int size, int target, int start);
+double measure_uniformity(const int *arr, int size);
+SearchMode choose_search_mode(const int *arr, int size,
+                              const SearchTuning *tuning, double *error);
+int adaptive_search(const int *arr, int size, int target, SearchMode mode);
+Status calibrate_search(SearchTuning *tuning);
+double engine_ns(SearchEngine engine, const SearchBench *bench,
+                 const int *queries, int count);
+const char *mode_name(SearchMode mode);
+double time_engine(SearchEngine engine, const SearchBench *bench,
+                   const int *queries, int count, long *hits);
+void batch_search(const int *arr, int size, const int *queries, int count,
+                  int *results, int width);
+void *batch_worker(void *arg);
+void batch_search_parallel(const int *arr, int size, const int *queries,
+                           int count, int *results, int width);
+int count_mismatches(const int *expected, const int *actual, int count);
+void print_throughput(const char *label, int count, double elapsed,
+                      double baseline, int mismatches);
+size_t physical_memory(void);
+void format_size(int size, char *buf, size_t len);
+void print_engine_result(const char *label, int index, double time_taken);
+void bench_linear_kernel(void *ctx);
+void bench_binary_kernel(void *ctx);
+void bench_branchless_kernel(void *ctx);
+void bench_eytzinger_kernel(void *ctx);
+void bench_stree_kernel(void *ctx);
 void print_array_preview(const int *arr, int size);
 
+int use_avx2 = FALSE;
+
 int main(void) {
   int option = 0;
   srand(time(NULL));
+  use_avx2 = cpu_has_avx2();
 
   while (TRUE) {
     show_menu();
@@ -67,12 +223,12 @@ int main(void) {
     }
 
     // Standard Exit Option logic if preferred, but simpler 1-2 menu structure:
-    if (option == 3) {
+    if (option == 7) {
       printf("\nExiting. Goodbye!\n");
       break;
     }
 
-    if (option < MIN_OPTION || option > 3) {
+    if (option < MIN_OPTION || option > 7) {
       handle_error(ERR_INVALID_OPTION);
       continue;
     }
@@ -84,6 +240,18 @@ int main(void) {
     case 2:
       run_algorithm_explanation();
       break;
+    case 3:
+      run_scaling_mode();
+      break;
+    case 4:
+      run_batch_mode();
+      break;
+    case 5:
+      run_adaptive_mode();
+      break;
+    case 6:
+      run_harness_benchmark();
+      break;
     }
   }
 
@@ -94,7 +262,11 @@ void show_menu(void) {
   printf("=== Search Algorithm Comparator ===\n\n");
   printf("1. Run Performance Comparison\n");
   printf("2. Algorithm Explanations\n");
-  printf("3. Exit\n");
+  printf("3. Search Engine Scaling (1K - 1G elements)\n");
+  printf("4. Batch Lookup Throughput (lookups/sec)\n");
+  printf("5. Adaptive Search (SIMD scan / Interpolation)\n");
+  printf("6. Run Benchmark Harness (CSV/JSON)\n");
+  printf("7. Exit\n");
   printf("Option: ");
 }
 
@@ -162,6 +334,33 @@ void run_comparison_mode(void) {
   printf("  - Time: %.6f sec\n", bin_res.time_taken);
   printf("  - Complexity: O(log n)\n");
 
+  int *eytz = NULL;
+  STree tree;
+  if (eytzinger_build(arr, size, &eytz) != SUCCESS ||
+      stree_build(arr, size, &tree) != SUCCESS) {
+    free(eytz);
+    free(arr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n=== Cache-Friendly Engines ===\n");
+  double start = bench_now();
+  int index = branchless_search(arr, size, target);
+  print_engine_result("Branchless", index, bench_now() - start);
+
+  start = bench_now();
+  index = eytzinger_search(eytz, size, target);
+  print_engine_result("Eytzinger slot", index, bench_now() - start);
+
+  start = bench_now();
+  index = stree_search(&tree, target);
+  print_engine_result(tree.simd ? "S-tree (AVX2)" : "S-tree (scalar)", index,
+                      bench_now() - start);
+
+  stree_free(&tree);
+  free(eytz);
+
   printf("\n=== Conclusion ===\n");
   if (bin_res.comparisons > 0 && lin_res.comparisons > 0) {
     double reduction = 100.0 *
@@ -176,6 +375,352 @@ void run_comparison_mode(void) {
   free(arr);
 }
 
+void run_scaling_mode(void) {
+  SearchBench bench;
+  int max_size = 0;
+  int *queries = NULL;
+  int *arr = NULL;
+  int *eytz = NULL;
+  STree tree;
+  char size_label[16];
+  size_t budget = physical_memory() / 4 * 3;
+
+  printf("\nMaximum array size (%d - %d): ", SCALING_MIN_SIZE,
+         SCALING_MAX_SIZE);
+  if (read_integer(&max_size) != SUCCESS || max_size < SCALING_MIN_SIZE ||
+      max_size > SCALING_MAX_SIZE) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  queries = (int *)malloc(SCALING_QUERIES * sizeof(int));
+  if (queries == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n=== Search Engine Scaling (ns per lookup, %d random queries) "
+         "===\n",
+         SCALING_QUERIES);
+  printf("S-tree node comparison: %s\n\n",
+         cpu_has_avx2() ? "AVX2" : "scalar (AVX2 not supported)");
+  printf("%-6s | %-9s | %-9s | %-10s | %-9s | %-9s | %s\n", "Size",
+         "Linear", "Binary", "Branchless", "Eytzinger", "S-tree", "Check");
+  printf("-------|-----------|-----------|------------|-----------|"
+         "-----------|------\n");
+
+  for (long size = SCALING_MIN_SIZE; size <= max_size; size *= 4) {
+    double ns[NUM_SCALING_ENGINES];
+    long hits[NUM_SCALING_ENGINES];
+    int consistent = TRUE;
+
+    format_size((int)size, size_label, sizeof(size_label));
+
+    // Sorted array + Eytzinger copy + S-tree (~1/16 extra for inner nodes)
+    size_t footprint = (size_t)size * sizeof(int) * 3 + (size_t)size / 4;
+    if (footprint > budget) {
+      printf("%-6s | skipped: needs %zu MB, RAM budget %zu MB\n", size_label,
+             footprint >> 20, budget >> 20);
+      continue;
+    }
+
+    if (generate_sorted_array(&arr, (int)size) != SUCCESS) {
+      printf("%-6s | skipped: allocation failed\n", size_label);
+      continue;
+    }
+    if (eytzinger_build(arr, (int)size, &eytz) != SUCCESS ||
+        stree_build(arr, (int)size, &tree) != SUCCESS) {
+      free(eytz);
+      free(arr);
+      printf("%-6s | skipped: allocation failed\n", size_label);
+      continue;
+    }
+
+    // Random targets over the whole value range: mix of hits and misses
+    for (int i = 0; i < SCALING_QUERIES; i++) {
+      queries[i] = rand() % (arr[size - 1] + 1);
+    }
+
+    bench.arr = arr;
+    bench.eytz = eytz;
+    bench.tree = &tree;
+    bench.size = (int)size;
+    bench.comparisons = 0;
+    for (int e = 0; e < NUM_SCALING_ENGINES; e++) {
+      int count = SCALING_QUERIES;
+      if (e == ENGINE_LINEAR && LINEAR_BUDGET / size < count) {
+        count = (int)(LINEAR_BUDGET / size);
+      }
+      ns[e] = (count >= LINEAR_MIN_QUERIES)
+                  ? time_engine((SearchEngine)e, &bench, queries, count,
+                                &hits[e]) *
+                        1e9 / count
+                  : -1.0;
+    }
+
+    // Linear search may have run a prefix of the queries only
+    for (int e = ENGINE_BRANCHLESS; e < NUM_SCALING_ENGINES; e++) {
+      if (hits[e] != hits[ENGINE_BINARY]) {
+        consistent = FALSE;
+      }
+    }
+
+    printf("%-6s | ", size_label);
+    if (ns[ENGINE_LINEAR] < 0.0) {
+      printf("%9s | ", "-");
+    } else {
+      printf("%9.0f | ", ns[ENGINE_LINEAR]);
+    }
+    printf("%9.1f | %10.1f | %9.1f | %9.1f | %s\n", ns[ENGINE_BINARY],
+           ns[ENGINE_BRANCHLESS], ns[ENGINE_EYTZINGER], ns[ENGINE_STREE],
+           consistent ? "OK" : "FAIL");
+    fflush(stdout);
+
+    stree_free(&tree);
+    free(eytz);
+    free(arr);
+    eytz = NULL;
+    arr = NULL;
+  }
+
+  printf("\n  - Linear search runs at most %ld comparisons per size\n",
+         LINEAR_BUDGET);
+  printf("  - Check: every engine finds the same number of targets\n\n");
+  free(queries);
+}
+
+void run_batch_mode(void) {
+  int size = 0;
+  int count = 0;
+  int *arr = NULL;
+  int *queries = NULL;
+  int *expected = NULL;
+  int *results = NULL;
+  long comparisons = 0;
+  char label[32];
+
+  printf("\nEnter array size (e.g., 1000000, 100000000): ");
+  if (read_integer(&size) != SUCCESS || size <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter number of lookups (e.g., 10000000): ");
+  if (read_integer(&count) != SUCCESS || count <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  queries = (int *)malloc((size_t)count * sizeof(int));
+  expected = (int *)malloc((size_t)count * sizeof(int));
+  results = (int *)malloc((size_t)count * sizeof(int));
+  if (queries == NULL || expected == NULL || results == NULL ||
+      generate_sorted_array(&arr, size) != SUCCESS) {
+    free(queries);
+    free(expected);
+    free(results);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  // Random targets over the whole value range: mix of hits and misses
+  for (int i = 0; i < count; i++) {
+    queries[i] = rand() % (arr[size - 1] + 1);
+  }
+
+  printf("\n=== Batch Lookups: %d queries on %d elements ===\n\n", count,
+         size);
+  printf("%-26s | %-14s | %-8s | %s\n", "Mode", "Lookups/sec", "Speedup",
+         "Check");
+  printf("---------------------------|----------------|----------|------\n");
+
+  double start = bench_now();
+  for (int i = 0; i < count; i++) {
+    expected[i] = binary_search_core(arr, size, queries[i], &comparisons);
+  }
+  double baseline = bench_now() - start;
+  print_throughput("binary_search loop", count, baseline, baseline, 0);
+
+  start = bench_now();
+  for (int i = 0; i < count; i++) {
+    results[i] = branchless_search(arr, size, queries[i]);
+  }
+  print_throughput("branchless loop", count, bench_now() - start, baseline,
+                   count_mismatches(expected, results, count));
+
+  for (int width = 4; width <= BATCH_MAX_WIDTH; width *= 2) {
+    snprintf(label, sizeof(label), "batch_search (K=%d)", width);
+    start = bench_now();
+    batch_search(arr, size, queries, count, results, width);
+    print_throughput(label, count, bench_now() - start, baseline,
+                     count_mismatches(expected, results, count));
+  }
+
+  snprintf(label, sizeof(label), "batch x%d threads (K=%d)", BATCH_THREADS,
+           BATCH_DEFAULT_WIDTH);
+  start = bench_now();
+  batch_search_parallel(arr, size, queries, count, results,
+                        BATCH_DEFAULT_WIDTH);
+  print_throughput(label, count, bench_now() - start, baseline,
+                   count_mismatches(expected, results, count));
+
+  printf("\n  - Check: results identical to binary_search\n\n");
+
+  free(arr);
+  free(queries);
+  free(expected);
+  free(results);
+}
+
+void run_adaptive_mode(void) {
+  static const SearchEngine engines[] = {
+      ENGINE_LINEAR,        ENGINE_SIMD_LINEAR,  ENGINE_BINARY,
+      ENGINE_BRANCHLESS,    ENGINE_INTERPOLATION, ENGINE_EXPONENTIAL,
+      ENGINE_ADAPTIVE};
+  static const char *names[] = {"linear_search",  "simd_linear_search",
+                                "binary_search",  "branchless_search",
+                                "interpolation",  "exponential_search",
+                                "adaptive"};
+  SearchTuning tuning;
+  SearchBench bench;
+  int size = 0;
+  int distribution = 0;
+  int *arr = NULL;
+  int *queries = NULL;
+  double error = 0.0;
+
+  if (calibrate_search(&tuning) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\nEnter array size (e.g., 64, 100000, 10000000): ");
+  if (read_integer(&size) != SUCCESS || size <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Distribution (1 = uniform gaps, 2 = skewed x^4): ");
+  if (read_integer(&distribution) != SUCCESS ||
+      (distribution != 1 && distribution != 2)) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  Status status = (distribution == 1) ? generate_sorted_array(&arr, size)
+                                      : generate_skewed_array(&arr, size);
+  queries = (int *)malloc(SCALING_QUERIES * sizeof(int));
+  if (status != SUCCESS || queries == NULL) {
+    free(arr);
+    free(queries);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  // Half the targets are present keys, half are random values in range
+  for (int i = 0; i < SCALING_QUERIES; i++) {
+    queries[i] = (i % 2) ? arr[rand() % size]
+                         : arr[0] + rand() % (arr[size - 1] - arr[0] + 1);
+  }
+
+  bench.arr = arr;
+  bench.size = size;
+  bench.mode = choose_search_mode(arr, size, &tuning, &error);
+  print_array_preview(arr, size);
+  printf("  - Interpolation error: %.4f of n (uniform if < %.2f)\n", error,
+         UNIFORMITY_TOLERANCE);
+  printf("  - Adaptive choice:     %s\n\n", mode_name(bench.mode));
+
+  printf("%-20s | %s\n", "Engine", "ns/lookup");
+  printf("---------------------|----------\n");
+  for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+    int count = SCALING_QUERIES;
+    if ((engines[e] == ENGINE_LINEAR || engines[e] == ENGINE_SIMD_LINEAR) &&
+        LINEAR_BUDGET / size < count) {
+      count = (int)(LINEAR_BUDGET / size);
+    }
+    if (count < LINEAR_MIN_QUERIES) {
+      printf("%-20s | %9s\n", names[e], "-");
+      continue;
+    }
+    printf("%-20s | %9.1f\n", names[e],
+           engine_ns(engines[e], &bench, queries, count));
+  }
+  printf("\n");
+
+  free(arr);
+  free(queries);
+}
+
+void run_harness_benchmark(void) {
+  BenchRegistry reg;
+  SearchBench bench;
+  int *arr = NULL;
+  int *eytz = NULL;
+  STree tree;
+
+  printf("\nEnter array size (e.g., 1000, 1000000): ");
+  if (read_integer(&bench.size) != SUCCESS || bench.size <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  if (generate_sorted_array(&arr, bench.size) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  if (eytzinger_build(arr, bench.size, &eytz) != SUCCESS ||
+      stree_build(arr, bench.size, &tree) != SUCCESS) {
+    free(eytz);
+    free(arr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  // Random targets over the whole value range: mix of hits and misses
+  bench.arr = arr;
+  bench.eytz = eytz;
+  bench.tree = &tree;
+  bench.next = 0;
+  bench.comparisons = 0;
+  bench.sink = 0;
+  for (int i = 0; i < BENCH_TARGETS; i++) {
+    bench.targets[i] = rand() % (arr[bench.size - 1] + 1);
+  }
+
+  bench_init(&reg, "search");
+  bench_register(&reg, "linear_search", NULL, bench_linear_kernel, &bench);
+  bench_register(&reg, "binary_search", NULL, bench_binary_kernel, &bench);
+  bench_register(&reg, "branchless_search", NULL, bench_branchless_kernel,
+                 &bench);
+  bench_register(&reg, "eytzinger_search", NULL, bench_eytzinger_kernel,
+                 &bench);
+  bench_register(&reg, "stree_search", NULL, bench_stree_kernel, &bench);
+
+  printf("\n=== Harness: %d elements, %d warmup, %d trials ===\n",
+         bench.size, reg.config.warmup, reg.config.trials);
+  if (!bench_run_all(&reg)) {
+    stree_free(&tree);
+    free(eytz);
+    free(arr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  bench_print_table(&reg);
+  if (bench_export_csv(&reg, FILES_DIR "/bench_search.csv") &&
+      bench_export_json(&reg, FILES_DIR "/bench_search.json")) {
+    printf("\n  - Results: %s/bench_search.{csv,json}\n\n", FILES_DIR);
+  } else {
+    printf("\n  - Error: could not write to %s/\n\n", FILES_DIR);
+  }
+
+  stree_free(&tree);
+  free(eytz);
+  free(arr);
+}
+
 void run_algorithm_explanation(void) {
   printf("\n=== Algorithm Logic ===\n\n");
   printf("1. Linear Search (O(n)):\n");
@@ -185,6 +730,26 @@ void run_algorithm_explanation(void) {
   printf("   - Requires a SORTED array.\n");
   printf("   - Repeatedly divides the search interval in half.\n");
   printf("   - Extremely fast for large datasets.\n\n");
+  printf("3. Branchless Binary Search:\n");
+  printf("   - Halves a window with arithmetic instead of if/else, so the\n");
+  printf("     CPU never mispredicts; prefetches both next midpoints.\n\n");
+  printf("4. Eytzinger Layout:\n");
+  printf("   - Stores the array in BFS order of the implicit search tree.\n");
+  printf("   - The top levels share cache lines; 16 descendants four levels\n");
+  printf("     ahead sit in one line and are prefetched.\n\n");
+  printf("5. S-tree (Static B+-tree):\n");
+  printf("   - 16 keys per 64-byte node: one cache miss per level and\n");
+  printf("     log17(n) levels instead of log2(n).\n");
+  printf("   - Each node is ranked with two AVX2 compares + popcount.\n\n");
+  printf("6. Batch Search:\n");
+  printf("   - K independent queries advance one level at a time, and the\n");
+  printf("     next probe of each is prefetched, so K misses overlap.\n");
+  printf("   - Threads split the query list; the array is read-only.\n\n");
+  printf("7. SIMD Linear Scan / Interpolation / Adaptive:\n");
+  printf("   - AVX2 counts keys < target 32 at a time; wins on tiny arrays.\n");
+  printf("   - Interpolation guesses the position from the value and\n");
+  printf("     gallops from the guess: ~O(log log n) on uniform keys.\n");
+  printf("   - Adaptive picks between them using measured crossovers.\n\n");
 }
 
 void clear_input_buffer(void) {
@@ -203,16 +768,41 @@ Status read_integer(int *value) {
   return SUCCESS;
 }
 
+Status generate_skewed_array(int **arr, int size) {
+  *arr = (int *)malloc(size * sizeof(int));
+  if (*arr == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // x^4 curve: dense keys at the start, huge gaps at the end (+i keeps
+  // them strictly increasing)
+  double scale = (double)(INT_MAX / 2);
+  for (int i = 0; i < size; i++) {
+    double x = (double)i / size;
+    (*arr)[i] = (int)(x * x * x * x * scale) + i;
+  }
+
+  return SUCCESS;
+}
+
 Status generate_sorted_array(int **arr, int size) {
   *arr = (int *)malloc(size * sizeof(int));
   if (*arr == NULL) {
     return ERR_MEMORY_ALLOCATION;
   }
 
+  // Gaps of 1..3, narrowed for huge arrays so the values fit in an int
+  int spread = (INT_MAX - 10) / size - 1;
+  if (spread > 3) {
+    spread = 3;
+  } else if (spread < 1) {
+    spread = 1;
+  }
+
   // Generate sorted data: Each element is greater than the previous
   (*arr)[0] = rand() % 10;
   for (int i = 1; i < size; i++) {
-    (*arr)[i] = (*arr)[i - 1] + (rand() % 3 + 1);
+    (*arr)[i] = (*arr)[i - 1] + (rand() % spread + 1);
   }
 
   return SUCCESS;
@@ -220,40 +810,50 @@ Status generate_sorted_array(int **arr, int size) {
 
 SearchResult linear_search(const int *arr, int size, int target) {
   SearchResult res = {-1, 0, 0.0};
-  clock_t start = clock();
 
+  double start = bench_now();
+  res.index = linear_search_core(arr, size, target, &res.comparisons);
+  res.time_taken = bench_now() - start;
+
+  return res;
+}
+
+SearchResult binary_search(const int *arr, int size, int target) {
+  SearchResult res = {-1, 0, 0.0};
+
+  double start = bench_now();
+  res.index = binary_search_core(arr, size, target, &res.comparisons);
+  res.time_taken = bench_now() - start;
+
+  return res;
+}
+
+int linear_search_core(const int *arr, int size, int target,
+                       long *comparisons) {
   for (int i = 0; i < size; i++) {
-    res.comparisons++;
+    (*comparisons)++;
     if (arr[i] == target) {
-      res.index = i;
-      break;
+      return i;
     }
     // Optimization for sorted array: stop early if current > target
     if (arr[i] > target) {
       break;
     }
   }
-
-  clock_t end = clock();
-  res.time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-
-  return res;
+  return -1;
 }
 
-SearchResult binary_search(const int *arr, int size, int target) {
-  SearchResult res = {-1, 0, 0.0};
-  clock_t start = clock();
-
+int binary_search_core(const int *arr, int size, int target,
+                       long *comparisons) {
   int low = 0;
   int high = size - 1;
 
   while (low <= high) {
-    res.comparisons++;
+    (*comparisons)++;
     int mid = low + (high - low) / 2;
 
     if (arr[mid] == target) {
-      res.index = mid;
-      break;
+      return mid;
     }
 
     if (arr[mid] < target) {
@@ -262,11 +862,620 @@ SearchResult binary_search(const int *arr, int size, int target) {
       high = mid - 1;
     }
   }
+  return -1;
+}
 
-  clock_t end = clock();
-  res.time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+int branchless_search(const int *arr, int size, int target) {
+  const int *base = arr;
+  int len = size;
 
-  return res;
+  while (len > 1) {
+    int half = len / 2;
+    __builtin_prefetch(base + half / 2);
+    __builtin_prefetch(base + half + half / 2);
+    // Multiply instead of branch: compiles to setcc + imul/cmov
+    base += (base[half - 1] < target) * half;
+    len -= half;
+  }
+
+  int index = (int)(base - arr);
+  return (size > 0 && *base == target) ? index : -1;
+}
+
+Status eytzinger_build(const int *arr, int size, int **eytz) {
+  void *mem = NULL;
+
+  // Slot 0 is unused; aligned so each 16-slot group shares a cache line
+  if (posix_memalign(&mem, CACHE_LINE, ((size_t)size + 1) * sizeof(int)) !=
+      0) {
+    *eytz = NULL;
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  *eytz = (int *)mem;
+  (*eytz)[0] = INT_MIN;
+  eytzinger_fill(arr, *eytz, size, 0, 1);
+  return SUCCESS;
+}
+
+int eytzinger_fill(const int *arr, int *eytz, int size, int i, size_t k) {
+  // In-order walk of the implicit tree assigns the sorted keys in order
+  if (k <= (size_t)size) {
+    i = eytzinger_fill(arr, eytz, size, i, 2 * k);
+    eytz[k] = arr[i++];
+    i = eytzinger_fill(arr, eytz, size, i, 2 * k + 1);
+  }
+  return i;
+}
+
+int eytzinger_search(const int *eytz, int size, int target) {
+  size_t k = 1;
+
+  while (k <= (size_t)size) {
+    __builtin_prefetch(eytz + k * 16);
+    k = 2 * k + (eytz[k] < target);
+  }
+
+  // Undo the trailing right turns (1 bits) plus the last left turn
+  k >>= __builtin_ffsl((long)~k);
+  return (k != 0 && eytz[k] == target) ? (int)k : -1;
+}
+
+Status stree_build(const int *arr, int size, STree *tree) {
+  size_t keys[STREE_MAX_HEIGHT];
+  size_t total = 0;
+  void *mem = NULL;
+
+  memset(tree, 0, sizeof(*tree));
+  tree->size = size;
+  tree->simd = cpu_has_avx2();
+
+  // Layer h + 1 has one key per child boundary of layer h
+  keys[0] = (size_t)size;
+  tree->height = 1;
+  while (keys[tree->height - 1] > STREE_B) {
+    size_t blocks = (keys[tree->height - 1] + STREE_B - 1) / STREE_B;
+    keys[tree->height] = (blocks + STREE_B) / (STREE_B + 1) * STREE_B;
+    tree->height++;
+  }
+  for (int h = 0; h < tree->height; h++) {
+    tree->offsets[h] = total;
+    total += (keys[h] + STREE_B - 1) / STREE_B * STREE_B;
+  }
+
+  if (posix_memalign(&mem, CACHE_LINE, total * sizeof(int)) != 0) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  tree->keys = (int *)mem;
+
+  // Pad the last leaf with INT_MAX: never counted as "< target"
+  size_t leaf_end = (tree->height > 1) ? tree->offsets[1] : total;
+  memcpy(tree->keys, arr, (size_t)size * sizeof(int));
+  for (size_t i = (size_t)size; i < leaf_end; i++) {
+    tree->keys[i] = INT_MAX;
+  }
+
+  // Each separator is the smallest key of the subtree to its right
+  for (int h = 1; h < tree->height; h++) {
+    size_t count = (h + 1 < tree->height ? tree->offsets[h + 1] : total) -
+                   tree->offsets[h];
+    for (size_t i = 0; i < count; i++) {
+      size_t k = i / STREE_B * (STREE_B + 1) + i % STREE_B + 1;
+      for (int l = 1; l < h; l++) {
+        k *= STREE_B + 1;
+      }
+      tree->keys[tree->offsets[h] + i] =
+          (k * STREE_B < (size_t)size) ? tree->keys[k * STREE_B] : INT_MAX;
+    }
+  }
+
+  return SUCCESS;
+}
+
+int stree_search(const STree *tree, int target) {
+#ifdef __x86_64__
+  if (tree->simd) {
+    return stree_search_avx2(tree, target);
+  }
+#endif
+  return stree_search_scalar(tree, target);
+}
+
+int stree_search_scalar(const STree *tree, int target) {
+  size_t k = 0; // Offset of the current node inside its layer
+
+  for (int h = tree->height - 1; h >= 0; h--) {
+    const int *node = tree->keys + tree->offsets[h] + k;
+    size_t rank = 0;
+    for (int j = 0; j < STREE_B; j++) {
+      rank += (node[j] < target);
+    }
+    k = (h > 0) ? k * (STREE_B + 1) + rank * STREE_B : k + rank;
+  }
+
+  return (k < (size_t)tree->size && tree->keys[k] == target) ? (int)k : -1;
+}
+
+void stree_free(STree *tree) {
+  free(tree->keys);
+  tree->keys = NULL;
+}
+
+int cpu_has_avx2(void) {
+#ifdef __x86_64__
+  return __builtin_cpu_supports("avx2");
+#else
+  return FALSE;
+#endif
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) int stree_search_avx2(const STree *tree,
+                                                      int target) {
+  __m256i x = _mm256_set1_epi32(target);
+  size_t k = 0;
+
+  for (int h = tree->height - 1; h >= 0; h--) {
+    const int *node = tree->keys + tree->offsets[h] + k;
+    __m256i lo = _mm256_load_si256((const __m256i *)node);
+    __m256i hi = _mm256_load_si256((const __m256i *)(node + 8));
+
+    // Rank = number of keys < target, from two 8-lane compares
+    unsigned mask = (unsigned)_mm256_movemask_ps(
+                        _mm256_castsi256_ps(_mm256_cmpgt_epi32(x, lo))) |
+                    (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(
+                        _mm256_cmpgt_epi32(x, hi)))
+                        << 8;
+    size_t rank = (size_t)__builtin_popcount(mask);
+    k = (h > 0) ? k * (STREE_B + 1) + rank * STREE_B : k + rank;
+  }
+
+  return (k < (size_t)tree->size && tree->keys[k] == target) ? (int)k : -1;
+}
+#endif
+
+void batch_search(const int *arr, int size, const int *queries, int count,
+                  int *results, int width) {
+  const int *base[BATCH_MAX_WIDTH];
+
+  if (width > BATCH_MAX_WIDTH) {
+    width = BATCH_MAX_WIDTH;
+  }
+
+  for (int first = 0; first < count; first += width) {
+    int k = (count - first < width) ? count - first : width;
+    const int *batch = queries + first;
+    int len = size;
+
+    for (int q = 0; q < k; q++) {
+      base[q] = arr;
+    }
+
+    // Every query halves the same window length, so they stay in step and
+    // each miss overlaps with the other k - 1 outstanding loads
+    while (len > 1) {
+      int half = len / 2;
+      for (int q = 0; q < k; q++) {
+        base[q] += (base[q][half - 1] < batch[q]) * half;
+      }
+      len -= half;
+      for (int q = 0; q < k; q++) {
+        __builtin_prefetch(base[q] + len / 2 - 1);
+      }
+    }
+
+    for (int q = 0; q < k; q++) {
+      results[first + q] =
+          (size > 0 && *base[q] == batch[q]) ? (int)(base[q] - arr) : -1;
+    }
+  }
+}
+
+void *batch_worker(void *arg) {
+  BatchJob *job = (BatchJob *)arg;
+  batch_search(job->arr, job->size, job->queries, job->count, job->results,
+               job->width);
+  return NULL;
+}
+
+void batch_search_parallel(const int *arr, int size, const int *queries,
+                           int count, int *results, int width) {
+  pthread_t threads[BATCH_THREADS];
+  BatchJob jobs[BATCH_THREADS];
+  int started[BATCH_THREADS];
+  int chunk = (count + BATCH_THREADS - 1) / BATCH_THREADS;
+
+  for (int t = 0; t < BATCH_THREADS; t++) {
+    int first = t * chunk;
+    jobs[t].arr = arr;
+    jobs[t].size = size;
+    jobs[t].queries = queries + first;
+    jobs[t].count = (first >= count)           ? 0
+                    : (count - first < chunk) ? count - first
+                                              : chunk;
+    jobs[t].results = results + first;
+    jobs[t].width = width;
+    started[t] = (jobs[t].count > 0 &&
+                  pthread_create(&threads[t], NULL, batch_worker, &jobs[t]) ==
+                      0);
+    // A thread that could not be created runs its share here
+    if (!started[t] && jobs[t].count > 0) {
+      batch_worker(&jobs[t]);
+    }
+  }
+
+  for (int t = 0; t < BATCH_THREADS; t++) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+}
+
+int count_mismatches(const int *expected, const int *actual, int count) {
+  int mismatches = 0;
+  for (int i = 0; i < count; i++) {
+    mismatches += (expected[i] != actual[i]);
+  }
+  return mismatches;
+}
+
+void print_throughput(const char *label, int count, double elapsed,
+                      double baseline, int mismatches) {
+  if (elapsed <= 0.0) {
+    elapsed = 0.000000001;
+  }
+  printf("%-26s | %14.0f | %7.2fx | %s\n", label, count / elapsed,
+         baseline / elapsed, mismatches == 0 ? "OK" : "FAIL");
+}
+
+int simd_linear_search(const int *arr, int size, int target) {
+#ifdef __x86_64__
+  if (use_avx2) {
+    return simd_linear_search_avx2(arr, size, target);
+  }
+#endif
+  return scalar_scan(arr, 0, size, target);
+}
+
+int scalar_scan(const int *arr, int from, int size, int target) {
+  // Sorted data: the first key >= target decides the outcome
+  for (int i = from; i < size; i++) {
+    if (arr[i] >= target) {
+      return (arr[i] == target) ? i : -1;
+    }
+  }
+  return -1;
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) int simd_linear_search_avx2(const int *arr,
+                                                            int size,
+                                                            int target) {
+  __m256i x = _mm256_set1_epi32(target);
+  int i = 0;
+
+  // 32 keys per step: a lane is set while its key is < target
+  for (; i + 32 <= size; i += 32) {
+    unsigned mask = 0;
+    for (int v = 0; v < 4; v++) {
+      __m256i keys = _mm256_loadu_si256((const __m256i *)(arr + i + v * 8));
+      mask |= (unsigned)_mm256_movemask_ps(
+                  _mm256_castsi256_ps(_mm256_cmpgt_epi32(x, keys)))
+              << (v * 8);
+    }
+    if (mask != 0xFFFFFFFFu) {
+      int pos = i + __builtin_ctz(~mask);
+      return (arr[pos] == target) ? pos : -1;
+    }
+  }
+
+  for (; i + 8 <= size; i += 8) {
+    __m256i keys = _mm256_loadu_si256((const __m256i *)(arr + i));
+    unsigned mask = (unsigned)_mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(x, keys)));
+    if (mask != 0xFFu) {
+      int pos = i + __builtin_ctz(~mask);
+      return (arr[pos] == target) ? pos : -1;
+    }
+  }
+
+  return scalar_scan(arr, i, size, target);
+}
+#endif
+
+int interpolation_search(const int *arr, int size, int target) {
+  if (size == 0 || target < arr[0] || target > arr[size - 1]) {
+    return -1;
+  }
+
+  long long span = (long long)arr[size - 1] - arr[0];
+  int guess = (span == 0) ? 0
+                          : (int)(((long long)target - arr[0]) *
+                                  (size - 1) / span);
+
+  // A bad guess costs O(log distance), never more than a binary search
+  return gallop_search(arr, size, target, guess);
+}
+
+int exponential_search(const int *arr, int size, int target) {
+  if (size == 0) {
+    return -1;
+  }
+  return gallop_search(arr, size, target, 0);
+}
+
+int gallop_search(const int *arr, int size, int target, int start) {
+  long low, high;
+  long step = 1;
+
+  if (arr[start] < target) {
+    low = start;
+    while (low + step < size && arr[low + step] < target) {
+      low += step;
+      step *= 2;
+    }
+    high = (low + step < size) ? low + step : size - 1;
+  } else {
+    high = start;
+    while (high - step >= 0 && arr[high - step] >= target) {
+      high -= step;
+      step *= 2;
+    }
+    low = (high - step >= 0) ? high - step : 0;
+  }
+
+  int index = branchless_search(arr + low, (int)(high - low + 1), target);
+  return (index < 0) ? -1 : (int)low + index;
+}
+
+double measure_uniformity(const int *arr, int size) {
+  long long span = (long long)arr[size - 1] - arr[0];
+  double worst = 0.0;
+
+  if (size < 2 || span == 0) {
+    return 0.0;
+  }
+
+  // How far off is the straight-line guess at evenly spaced samples?
+  for (int s = 1; s < UNIFORMITY_SAMPLES; s++) {
+    int i = (int)((long long)s * (size - 1) / UNIFORMITY_SAMPLES);
+    double guess = (double)((long long)arr[i] - arr[0]) * (size - 1) / span;
+    double error = (guess > i ? guess - i : i - guess) / size;
+    if (error > worst) {
+      worst = error;
+    }
+  }
+  return worst;
+}
+
+SearchMode choose_search_mode(const int *arr, int size,
+                              const SearchTuning *tuning, double *error) {
+  *error = measure_uniformity(arr, size);
+  if (size <= tuning->linear_crossover) {
+    return MODE_SIMD_LINEAR;
+  }
+  if (*error < UNIFORMITY_TOLERANCE && size >= tuning->interp_crossover) {
+    return MODE_INTERPOLATION;
+  }
+  return MODE_BRANCHLESS;
+}
+
+int adaptive_search(const int *arr, int size, int target, SearchMode mode) {
+  switch (mode) {
+  case MODE_SIMD_LINEAR:
+    return simd_linear_search(arr, size, target);
+  case MODE_INTERPOLATION:
+    return interpolation_search(arr, size, target);
+  case MODE_BRANCHLESS:
+    break;
+  }
+  return branchless_search(arr, size, target);
+}
+
+Status calibrate_search(SearchTuning *tuning) {
+  SearchBench bench;
+  int scan_winning = TRUE;
+  int *arr = NULL;
+  int *queries = (int *)malloc(CALIBRATION_QUERIES * sizeof(int));
+  if (queries == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  tuning->linear_crossover = 0;
+  tuning->interp_crossover = INT_MAX;
+
+  printf("\n=== Calibration (ns per lookup, %s scan) ===\n\n",
+         use_avx2 ? "AVX2" : "scalar");
+  printf("%-8s | %-9s | %-10s | %s\n", "Size", "SIMD scan", "Branchless",
+         "Interpolation");
+  printf("---------|-----------|------------|--------------\n");
+
+  for (int size = 8; size <= CALIBRATION_LARGE_MAX;
+       size *= (size < CALIBRATION_SMALL_MAX) ? 2 : 4) {
+    if (generate_sorted_array(&arr, size) != SUCCESS) {
+      free(queries);
+      return ERR_MEMORY_ALLOCATION;
+    }
+    for (int i = 0; i < CALIBRATION_QUERIES; i++) {
+      queries[i] = rand() % (arr[size - 1] + 1);
+    }
+
+    bench.arr = arr;
+    bench.size = size;
+    double branchless =
+        engine_ns(ENGINE_BRANCHLESS, &bench, queries, CALIBRATION_QUERIES);
+    printf("%-8d | ", size);
+
+    // The scan only competes on small arrays, while it keeps winning
+    if (size <= CALIBRATION_SMALL_MAX) {
+      double scan =
+          engine_ns(ENGINE_SIMD_LINEAR, &bench, queries, CALIBRATION_QUERIES);
+      printf("%9.1f | ", scan);
+      if (scan <= branchless && scan_winning) {
+        tuning->linear_crossover = size;
+      } else {
+        scan_winning = FALSE;
+      }
+    } else {
+      printf("%9s | ", "-");
+    }
+    printf("%10.1f | ", branchless);
+
+    if (size >= CALIBRATION_LARGE_MIN) {
+      double interp = engine_ns(ENGINE_INTERPOLATION, &bench, queries,
+                                CALIBRATION_QUERIES);
+      printf("%9.1f\n", interp);
+      if (interp < branchless && tuning->interp_crossover == INT_MAX) {
+        tuning->interp_crossover = size;
+      } else if (interp >= branchless) {
+        tuning->interp_crossover = INT_MAX;
+      }
+    } else {
+      printf("%9s\n", "-");
+    }
+
+    free(arr);
+  }
+
+  printf("\n  - SIMD scan up to:      %d elements\n", tuning->linear_crossover);
+  if (tuning->interp_crossover == INT_MAX) {
+    printf("  - Interpolation from:   never (branchless always won)\n");
+  } else {
+    printf("  - Interpolation from:   %d elements (uniform data only)\n",
+           tuning->interp_crossover);
+  }
+
+  free(queries);
+  return SUCCESS;
+}
+
+double engine_ns(SearchEngine engine, const SearchBench *bench,
+                 const int *queries, int count) {
+  long hits = 0;
+  return time_engine(engine, bench, queries, count, &hits) * 1e9 / count;
+}
+
+const char *mode_name(SearchMode mode) {
+  switch (mode) {
+  case MODE_SIMD_LINEAR:
+    return "SIMD linear scan";
+  case MODE_INTERPOLATION:
+    return "Interpolation + gallop";
+  case MODE_BRANCHLESS:
+    break;
+  }
+  return "Branchless binary";
+}
+
+double time_engine(SearchEngine engine, const SearchBench *bench,
+                   const int *queries, int count, long *hits) {
+  long comparisons = 0;
+  long found = 0;
+
+  double start = bench_now();
+  for (int i = 0; i < count; i++) {
+    int index = -1;
+    switch (engine) {
+    case ENGINE_LINEAR:
+      index = linear_search_core(bench->arr, bench->size, queries[i],
+                                 &comparisons);
+      break;
+    case ENGINE_BINARY:
+      index = binary_search_core(bench->arr, bench->size, queries[i],
+                                 &comparisons);
+      break;
+    case ENGINE_BRANCHLESS:
+      index = branchless_search(bench->arr, bench->size, queries[i]);
+      break;
+    case ENGINE_EYTZINGER:
+      index = eytzinger_search(bench->eytz, bench->size, queries[i]);
+      break;
+    case ENGINE_STREE:
+      index = stree_search(bench->tree, queries[i]);
+      break;
+    case ENGINE_SIMD_LINEAR:
+      index = simd_linear_search(bench->arr, bench->size, queries[i]);
+      break;
+    case ENGINE_INTERPOLATION:
+      index = interpolation_search(bench->arr, bench->size, queries[i]);
+      break;
+    case ENGINE_EXPONENTIAL:
+      index = exponential_search(bench->arr, bench->size, queries[i]);
+      break;
+    case ENGINE_ADAPTIVE:
+      index = adaptive_search(bench->arr, bench->size, queries[i],
+                              bench->mode);
+      break;
+    case NUM_ENGINES:
+      break;
+    }
+    found += (index >= 0);
+  }
+  double elapsed = bench_now() - start;
+
+  *hits = found;
+  return elapsed;
+}
+
+size_t physical_memory(void) {
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGESIZE);
+  if (pages <= 0 || page_size <= 0) {
+    return (size_t)1 << 32; // Unknown: assume 4 GB
+  }
+  return (size_t)pages * (size_t)page_size;
+}
+
+void format_size(int size, char *buf, size_t len) {
+  if (size >= (1 << 30)) {
+    snprintf(buf, len, "%dG", size >> 30);
+  } else if (size >= (1 << 20)) {
+    snprintf(buf, len, "%dM", size >> 20);
+  } else if (size >= (1 << 10)) {
+    snprintf(buf, len, "%dK", size >> 10);
+  } else {
+    snprintf(buf, len, "%d", size);
+  }
+}
+
+void print_engine_result(const char *label, int index, double time_taken) {
+  if (index != -1) {
+    printf("  - %-16s found at %d (%.9f sec)\n", label, index, time_taken);
+  } else {
+    printf("  - %-16s not found (%.9f sec)\n", label, time_taken);
+  }
+}
+
+void bench_linear_kernel(void *ctx) {
+  SearchBench *bench = (SearchBench *)ctx;
+  int target = bench->targets[bench->next++ % BENCH_TARGETS];
+  bench->sink += linear_search_core(bench->arr, bench->size, target,
+                                    &bench->comparisons);
+}
+
+void bench_binary_kernel(void *ctx) {
+  SearchBench *bench = (SearchBench *)ctx;
+  int target = bench->targets[bench->next++ % BENCH_TARGETS];
+  bench->sink += binary_search_core(bench->arr, bench->size, target,
+                                    &bench->comparisons);
+}
+
+void bench_branchless_kernel(void *ctx) {
+  SearchBench *bench = (SearchBench *)ctx;
+  int target = bench->targets[bench->next++ % BENCH_TARGETS];
+  bench->sink += branchless_search(bench->arr, bench->size, target);
+}
+
+void bench_eytzinger_kernel(void *ctx) {
+  SearchBench *bench = (SearchBench *)ctx;
+  int target = bench->targets[bench->next++ % BENCH_TARGETS];
+  bench->sink += eytzinger_search(bench->eytz, bench->size, target);
+}
+
+void bench_stree_kernel(void *ctx) {
+  SearchBench *bench = (SearchBench *)ctx;
+  int target = bench->targets[bench->next++ % BENCH_TARGETS];
+  bench->sink += stree_search(bench->tree, target);
 }
 
 void print_array_preview(const int *arr, int size) {
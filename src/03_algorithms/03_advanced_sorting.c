@@ -6,55 +6,252 @@
  ===============================================================================
  Features:
  - Implementation of O(n log n) algorithms: Merge Sort & Quick Sort
+ - Quick Sort as Introsort: median-of-three/ninther pivot, 3-way partition,
+   insertion sort cutoff and Heap Sort fallback on deep recursion
+ - Input pattern benchmark (random, sorted, reversed, equal, organ pipe)
+ - Radix Sort LSD (8-bit digits, ping-pong buffer, single histogram pass)
+ - Parallel MSD Radix Sort with pthreads for large arrays
+ - Signed integer keys and stable key-value pair sorting
+ - AVX2 bitonic sorting network (8/16/32/64 ints) as base case for the
+   Merge Sort / Quick Sort recursion, plus vectorized merge of sorted runs
+ - External merge sort for binary int/record files larger than RAM:
+   sorted runs spilled to files/, k-way loser tree merge with
+   double-buffered background reads
  - Performance benchmarking (Time & Comparisons)
+ - Hardware counters per algorithm: cycles, instructions, IPC, cache and
+   branch misses (perf_event_open, perf_counters.h)
+ - Benchmark harness mode: warmup, repeated trials, outlier rejection,
+   median/CI and CSV/JSON export (bench_harness.h)
  - Dynamic comparison against O(n²) Bubble Sort (Estimated)
  - Handling of large arrays (heap allocation)
  - Dynamic memory management with proper cleanup
  ===============================================================================
 */
 
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <limits.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "bench_harness.h"
+#include "perf_counters.h"
 
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 3
+#define MAX_OPTION 7
+#define INSERTION_THRESHOLD 16
+#define NINTHER_THRESHOLD 128
+#define NUM_PATTERNS 5
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+#define RADIX_DIGITS 4
+#define RADIX_THREADS 4
+#define RADIX_PARALLEL_THRESHOLD 65536
+#define SIMD_WIDTH 8
+#define SIMD_BLOCK_MAX 64
+#define MAX_PATH 256
+#define MAX_RECORD_SIZE 4096
+#define FILES_DIR "files"
+#define EXTERNAL_INPUT FILES_DIR "/external_input.bin"
+#define EXTERNAL_OUTPUT FILES_DIR "/external_sorted.bin"
+#define EXTERNAL_IO_BLOCK (4 * 1024 * 1024)
+#define EXTERNAL_ALIGN 4096
 
 typedef enum {
   SUCCESS,
   ERR_INVALID_INPUT,
   ERR_INVALID_OPTION,
-  ERR_MEMORY_ALLOCATION
+  ERR_MEMORY_ALLOCATION,
+  ERR_FILE_IO,
+  ERR_THREAD_CREATE,
+  ERR_PARTIAL_RECORD
 } Status;
 
+typedef enum {
+  PATTERN_RANDOM,
+  PATTERN_SORTED,
+  PATTERN_REVERSED,
+  PATTERN_EQUAL,
+  PATTERN_ORGAN_PIPE
+} InputPattern;
+
 typedef struct {
   unsigned long long comparisons;
   double time_taken;
+  int passes;
 } SortStats;
 
+typedef struct {
+  int key;
+  int value;
+} KeyValue;
+
+typedef struct {
+  int *arr;
+  int *buffer;
+  int bucket_start[RADIX_BUCKETS + 1];
+  int digits;
+  int next_bucket;
+  pthread_mutex_t lock;
+} RadixJob;
+
+typedef struct {
+  const int *master;
+  int *work;
+  int *buffer;
+  int size;
+  unsigned long long comps;
+} SortBench;
+
+typedef struct {
+  long long records;
+  int runs;
+  int extra_merges; // Intermediate merges when all runs do not fit at once
+  double split_time;
+  double merge_time;
+} ExternalStats;
+
+typedef struct {
+  int fd;
+  char *buffers[2];
+  size_t lengths[2];
+  int ready[2];
+  int active;
+  size_t pos;
+  size_t available;
+  off_t file_offset;
+} RunReader;
+
+typedef struct {
+  int run;
+  int buffer;
+} IoRequest;
+
+typedef struct {
+  RunReader *runs;
+  IoRequest *queue;
+  int capacity;
+  int head;
+  int tail;
+  int shutdown;
+  int failed; // A pread() failed: the merge output is incomplete
+  size_t buffer_bytes;
+  pthread_mutex_t lock;
+  pthread_cond_t filled;
+  pthread_cond_t requested;
+} IoScheduler;
+
+int use_vector_base_case = FALSE;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_benchmark(void);
+void run_pattern_benchmark(void);
+void run_vector_benchmark(void);
+void run_external_sort(void);
+void run_harness_benchmark(void);
 void run_algorithm_info(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
+Status read_string(char *buffer, int max_len);
 
 Status generate_random_array(int **arr, int size);
+void fill_pattern_array(int *arr, int size, InputPattern pattern);
+const char *pattern_name(InputPattern pattern);
 void run_merge_sort(int *arr, int size, SortStats *stats);
 void run_quick_sort(int *arr, int size, SortStats *stats);
+Status measure_merge_sort(int *arr, int size, SortStats *stats);
+void measure_quick_sort(int *arr, int size, SortStats *stats);
 void merge_sort_recursive(int *arr, int l, int r, int *temp,
                           unsigned long long *comps);
 void merge(int *arr, int l, int m, int r, int *temp, unsigned long long *comps);
-void quick_sort_recursive(int *arr, int low, int high,
+void quick_sort_recursive(int *arr, int low, int high, int depth_limit,
                           unsigned long long *comps);
-int partition(int *arr, int low, int high, unsigned long long *comps);
+int select_pivot(const int *arr, int low, int high, unsigned long long *comps);
+int median_of_three(const int *arr, int a, int b, int c,
+                    unsigned long long *comps);
+void partition(int *arr, int low, int high, int pivot, int *lt, int *gt,
+               unsigned long long *comps);
+void insertion_sort_range(int *arr, int low, int high,
+                          unsigned long long *comps);
+void heap_sort_range(int *arr, int low, int high, unsigned long long *comps);
+void sift_down(int *heap, int root, int n, unsigned long long *comps);
+int is_sorted(const int *arr, int size);
+void run_radix_sort(int *arr, int size, SortStats *stats);
+void run_parallel_radix_sort(int *arr, int size, SortStats *stats);
+Status measure_radix_sort(int *arr, int size, SortStats *stats);
+Status measure_parallel_radix_sort(int *arr, int size, SortStats *stats);
+unsigned int radix_key(int value);
+void compute_histograms(const int *arr, int size, int digits,
+                        unsigned int hist[][RADIX_BUCKETS]);
+int digit_is_constant(const unsigned int *counts, int size);
+int *lsd_sort_digits(int *src, int *dst, int size, int digits,
+                     unsigned int hist[][RADIX_BUCKETS], int *passes);
+int radix_sort_lsd(int *arr, int size, int *buffer);
+void radix_sort_pairs(KeyValue *pairs, int size, KeyValue *buffer);
+void *radix_bucket_worker(void *arg);
+void radix_sort_msd_parallel(int *arr, int size, int *buffer);
+Status verify_radix_pairs(const int *src, int size, int *is_stable);
+void show_radix_comparison(SortStats merge_stats, SortStats quick_stats,
+                           SortStats radix_stats, SortStats parallel_stats);
+void sort_small_block(int *arr, int n);
+int cpu_has_avx2(void);
+#ifdef __x86_64__
+__m256i simd_sort8(__m256i v);
+__m256i simd_bitonic_merge8(__m256i v);
+__m256i simd_reverse8(__m256i v);
+void simd_sort_registers(__m256i *r, int k);
+void simd_sort_block(int *arr, int n);
+void simd_merge_runs(const int *a, int na, const int *b, int nb, int *out);
+#endif
+ssize_t read_full(int fd, char *buf, size_t count);
+int write_all(int fd, const char *buf, size_t count);
+int record_key(const char *record);
+Status generate_external_input(const char *path, long long count,
+                               int record_size);
+void run_file_path(char *path, int run);
+void sort_chunk(char *records, int count, size_t record_size, char *scratch,
+                KeyValue *pairs);
+Status create_sorted_runs(int in_fd, size_t record_size, size_t memory_bytes,
+                          ExternalStats *stats);
+void *io_worker(void *arg);
+void request_refill(IoScheduler *io, int run, int buffer);
+const char *run_head(IoScheduler *io, int run);
+void loser_tree_adjust(int *tree, const long long *keys, int k, int s);
+size_t merge_unit(size_t record_size);
+Status merge_all_runs(int num_runs, int out_fd, size_t record_size,
+                      size_t memory_bytes, int *extra_merges);
+Status merge_runs(int first, int num_runs, int out_fd, size_t record_size,
+                  size_t memory_bytes);
+Status external_sort_file(const char *in_path, const char *out_path,
+                          size_t record_size, size_t memory_bytes,
+                          ExternalStats *stats);
+void remove_run_files(int count);
+int verify_sorted_file(const char *path, size_t record_size,
+                       long long expected_records);
+void bench_sort_setup(void *ctx);
+void bench_merge_kernel(void *ctx);
+void bench_quick_kernel(void *ctx);
+void bench_radix_kernel(void *ctx);
+void bench_parallel_radix_kernel(void *ctx);
 void show_final_comparison(int size, SortStats merge_stats,
                            SortStats quick_stats);
 void print_array_preview(const int *arr, int size);
+void print_perf_counters(const PerfCounters *pc);
 void copy_array(const int *src, int *dest, int size);
 void swap(int *a, int *b);
 
@@ -85,6 +282,18 @@ int main(void) {
       run_benchmark();
       break;
     case 2:
+      run_pattern_benchmark();
+      break;
+    case 3:
+      run_vector_benchmark();
+      break;
+    case 4:
+      run_external_sort();
+      break;
+    case 5:
+      run_harness_benchmark();
+      break;
+    case 6:
       run_algorithm_info();
       break;
     }
@@ -95,9 +304,13 @@ int main(void) {
 
 void show_menu(void) {
   printf("=== Algoritmos de Ordenamiento Avanzados ===\n\n");
-  printf("1. Ejecutar Benchmark (Merge Sort vs Quick Sort)\n"
-         "2. Información de Algoritmos\n"
-         "3. Salir\n");
+  printf("1. Ejecutar Benchmark (Merge vs Quick vs Radix)\n"
+         "2. Benchmark por Patrones de Entrada\n"
+         "3. Benchmark Caso Base Vectorial (AVX2)\n"
+         "4. Ordenamiento Externo (archivos binarios)\n"
+         "5. Benchmark con Harness (CSV/JSON)\n"
+         "6. Información de Algoritmos\n"
+         "7. Salir\n");
   printf("Opción: ");
 }
 
@@ -112,6 +325,15 @@ void handle_error(Status status) {
   case ERR_MEMORY_ALLOCATION:
     printf("Error: Memoria insuficiente.\n\n");
     break;
+  case ERR_FILE_IO:
+    printf("Error: No se pudo leer/escribir el archivo.\n\n");
+    break;
+  case ERR_THREAD_CREATE:
+    printf("Error: No se pudo crear el hilo de E/S.\n\n");
+    break;
+  case ERR_PARTIAL_RECORD:
+    printf("Error: El tamaño del archivo no es múltiplo del registro.\n\n");
+    break;
   case SUCCESS:
     break;
   }
@@ -121,8 +343,11 @@ void run_benchmark(void) {
   int size = 0;
   int *master_arr = NULL;
   int *work_arr = NULL;
-  SortStats merge_stats = {0, 0.0};
-  SortStats quick_stats = {0, 0.0};
+  SortStats merge_stats = {0, 0.0, 0};
+  SortStats quick_stats = {0, 0.0, 0};
+  SortStats radix_stats = {0, 0.0, 0};
+  SortStats parallel_stats = {0, 0.0, 0};
+  int pairs_stable = FALSE;
 
   printf("\nIngrese tamaño del array (Recomendado 1000+): ");
   if (read_integer(&size) != SUCCESS || size < 2) {
@@ -154,22 +379,324 @@ void run_benchmark(void) {
   copy_array(master_arr, work_arr, size);
   run_quick_sort(work_arr, size, &quick_stats);
 
+  printf("\n=== Radix Sort LSD ===\n");
+  copy_array(master_arr, work_arr, size);
+  run_radix_sort(work_arr, size, &radix_stats);
+  printf("  - Ordenado:      %s\n", is_sorted(work_arr, size) ? "Sí" : "No");
+  if (verify_radix_pairs(master_arr, size, &pairs_stable) == SUCCESS) {
+    printf("  - Pares KV (claves con signo): %s\n",
+           pairs_stable ? "ordenados y estables" : "ERROR");
+  }
+
+  printf("\n=== Radix Sort MSD Paralelo ===\n");
+  copy_array(master_arr, work_arr, size);
+  run_parallel_radix_sort(work_arr, size, &parallel_stats);
+  printf("  - Ordenado:      %s\n", is_sorted(work_arr, size) ? "Sí" : "No");
+
   show_final_comparison(size, merge_stats, quick_stats);
+  show_radix_comparison(merge_stats, quick_stats, radix_stats,
+                        parallel_stats);
+
+  free(master_arr);
+  free(work_arr);
+}
+
+void run_pattern_benchmark(void) {
+  int size = 0;
+  int *work_arr = NULL;
+
+  printf("\nIngrese tamaño del array (Recomendado 100000+): ");
+  if (read_integer(&size) != SUCCESS || size < 2) {
+    printf("Tamaño inválido. Usando defecto (100000).\n");
+    size = 100000;
+  }
+
+  work_arr = (int *)malloc(size * sizeof(int));
+  if (work_arr == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n=== Benchmark por Patrones (%d elementos) ===\n\n", size);
+  printf("Patrón     | Merge (s)  | Merge comps  | "
+         "Quick (s)  | Quick comps\n");
+  printf("-----------|------------|--------------|------------|"
+         "-------------\n");
+
+  for (int p = 0; p < NUM_PATTERNS; p++) {
+    SortStats merge_stats = {0, 0.0, 0};
+    SortStats quick_stats = {0, 0.0, 0};
+
+    fill_pattern_array(work_arr, size, (InputPattern)p);
+    if (measure_merge_sort(work_arr, size, &merge_stats) != SUCCESS) {
+      free(work_arr);
+      handle_error(ERR_MEMORY_ALLOCATION);
+      return;
+    }
+    int merge_ok = is_sorted(work_arr, size);
+
+    fill_pattern_array(work_arr, size, (InputPattern)p);
+    measure_quick_sort(work_arr, size, &quick_stats);
+    int quick_ok = is_sorted(work_arr, size);
+
+    printf("%-10s | %10.6f | %12llu | %10.6f | %llu%s\n",
+           pattern_name((InputPattern)p), merge_stats.time_taken,
+           merge_stats.comparisons, quick_stats.time_taken,
+           quick_stats.comparisons,
+           (merge_ok && quick_ok) ? "" : "  (ERROR: no ordenado)");
+  }
+
+  printf("\n  - Introsort mantiene O(n log n) en entradas ordenadas,\n"
+         "    inversas y de órgano gracias al pivote ninther y al\n"
+         "    respaldo con Heap Sort.\n");
+  printf("  - La partición en 3 vías resuelve el caso de todos iguales\n"
+         "    en una sola pasada (O(n)).\n\n");
+
+  free(work_arr);
+}
+
+void run_vector_benchmark(void) {
+  int size = 0;
+  int *master_arr = NULL;
+  int *work_arr = NULL;
+
+  if (!cpu_has_avx2()) {
+    printf("\nEsta CPU no soporta AVX2. Benchmark no disponible.\n\n");
+    return;
+  }
+
+  printf("\nIngrese tamaño del array (Recomendado 1000000+): ");
+  if (read_integer(&size) != SUCCESS || size < 2) {
+    printf("Tamaño inválido. Usando defecto (1000000).\n");
+    size = 1000000;
+  }
+
+  if (generate_random_array(&master_arr, size) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  work_arr = (int *)malloc(size * sizeof(int));
+  if (work_arr == NULL) {
+    free(master_arr);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n=== Caso Base Vectorial AVX2 (%d elementos) ===\n\n", size);
+  printf("%-10s | %-12s | %-12s | %s\n", "Algoritmo", "Escalar (s)",
+         "AVX2 (s)", "Aceleración");
+  printf("-----------|--------------|--------------|------------\n");
+
+  for (int algo = 0; algo < 2; algo++) {
+    SortStats scalar_stats = {0, 0.0, 0};
+    SortStats vector_stats = {0, 0.0, 0};
+    int sorted_ok = TRUE;
+
+    for (int simd = 0; simd <= 1; simd++) {
+      SortStats *stats = simd ? &vector_stats : &scalar_stats;
+      use_vector_base_case = simd;
+      copy_array(master_arr, work_arr, size);
+
+      if (algo == 0) {
+        if (measure_merge_sort(work_arr, size, stats) != SUCCESS) {
+          use_vector_base_case = FALSE;
+          free(master_arr);
+          free(work_arr);
+          handle_error(ERR_MEMORY_ALLOCATION);
+          return;
+        }
+      } else {
+        measure_quick_sort(work_arr, size, stats);
+      }
+      sorted_ok = sorted_ok && is_sorted(work_arr, size);
+    }
+    use_vector_base_case = FALSE;
+
+    double vector_time =
+        (vector_stats.time_taken > 0) ? vector_stats.time_taken : 0.000001;
+    printf("%-10s | %12.6f | %12.6f | %.2fx%s\n",
+           (algo == 0) ? "Merge" : "Quick", scalar_stats.time_taken,
+           vector_stats.time_taken, scalar_stats.time_taken / vector_time,
+           sorted_ok ? "" : "  (ERROR: no ordenado)");
+  }
+
+  printf("\n  - Bloques de hasta %d enteros se ordenan con una red bitónica\n"
+         "    en registros de 256 bits, sin saltos condicionales.\n",
+         SIMD_BLOCK_MAX);
+  printf("  - Merge Sort además fusiona los runs de 8 en 8 con AVX2.\n\n");
 
   free(master_arr);
   free(work_arr);
 }
 
+void run_external_sort(void) {
+  char input_path[MAX_PATH];
+  int record_size = 0;
+  int memory_mb = 0;
+  ExternalStats stats = {0, 0, 0, 0.0, 0.0};
+
+  printf("\nArchivo de entrada (vacío = generar %s): ", EXTERNAL_INPUT);
+  if (read_string(input_path, MAX_PATH) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Tamaño de registro en bytes (4 = int, clave int al inicio): ");
+  if (read_integer(&record_size) != SUCCESS || record_size < 4 ||
+      record_size > MAX_RECORD_SIZE) {
+    printf("Tamaño inválido. Usando defecto (4).\n");
+    record_size = 4;
+  }
+
+  printf("Memoria disponible en MB (Recomendado 64+): ");
+  if (read_integer(&memory_mb) != SUCCESS || memory_mb < 1) {
+    printf("Memoria inválida. Usando defecto (64 MB).\n");
+    memory_mb = 64;
+  }
+
+  if (input_path[0] == '\0') {
+    int file_mb = 0;
+    printf("Tamaño del archivo de prueba en MB: ");
+    if (read_integer(&file_mb) != SUCCESS || file_mb < 1) {
+      printf("Tamaño inválido. Usando defecto (256 MB).\n");
+      file_mb = 256;
+    }
+
+    snprintf(input_path, MAX_PATH, "%s", EXTERNAL_INPUT);
+    printf("Generando %s (%d MB)...\n", input_path, file_mb);
+    Status status = generate_external_input(
+        input_path, (long long)file_mb * 1024 * 1024 / record_size,
+        record_size);
+    if (status != SUCCESS) {
+      handle_error(status);
+      return;
+    }
+  }
+
+  printf("\n=== Ordenamiento Externo ===\n");
+  printf("  - Entrada: %s\n", input_path);
+  printf("  - Salida:  %s\n", EXTERNAL_OUTPUT);
+
+  Status status =
+      external_sort_file(input_path, EXTERNAL_OUTPUT, (size_t)record_size,
+                         (size_t)memory_mb * 1024 * 1024, &stats);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  double total_mb = (double)stats.records * record_size / (1024.0 * 1024.0);
+  double split = (stats.split_time > 0) ? stats.split_time : 0.000001;
+  double merge = (stats.merge_time > 0) ? stats.merge_time : 0.000001;
+
+  printf("  - Registros:          %lld (%.1f MB)\n", stats.records, total_mb);
+  printf("  - Runs generados:     %d\n", stats.runs);
+  printf("  - Merges intermedios: %d\n", stats.extra_merges);
+  printf("  - Fase 1 (runs):      %.3f s (%.1f MB/s)\n", stats.split_time,
+         total_mb / split);
+  printf("  - Fase 2 (merge):     %.3f s (%.1f MB/s)\n", stats.merge_time,
+         total_mb / merge);
+  printf("  - Verificación:       %s\n\n",
+         verify_sorted_file(EXTERNAL_OUTPUT, (size_t)record_size,
+                            stats.records)
+             ? "Ordenado"
+             : "ERROR: no ordenado o incompleto");
+}
+
+void run_harness_benchmark(void) {
+  BenchRegistry reg;
+  SortBench bench;
+  int *master_arr = NULL;
+
+  printf("\nIngrese tamaño del array (Recomendado 100000+): ");
+  if (read_integer(&bench.size) != SUCCESS || bench.size < 2) {
+    printf("Tamaño inválido. Usando defecto (100000).\n");
+    bench.size = 100000;
+  }
+
+  if (generate_random_array(&master_arr, bench.size) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+  bench.master = master_arr;
+  bench.work = (int *)malloc(bench.size * sizeof(int));
+  bench.buffer = (int *)malloc(bench.size * sizeof(int));
+  if (bench.work == NULL || bench.buffer == NULL) {
+    free(master_arr);
+    free(bench.work);
+    free(bench.buffer);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  bench_init(&reg, "sorting");
+  bench_register(&reg, "merge_sort", bench_sort_setup, bench_merge_kernel,
+                 &bench);
+  bench_register(&reg, "quick_sort_introsort", bench_sort_setup,
+                 bench_quick_kernel, &bench);
+  bench_register(&reg, "radix_sort_lsd", bench_sort_setup, bench_radix_kernel,
+                 &bench);
+  bench_register(&reg, "radix_sort_msd_parallel", bench_sort_setup,
+                 bench_parallel_radix_kernel, &bench);
+
+  printf("\n=== Harness: %d elementos, %d warmup, %d repeticiones ===\n",
+         bench.size, reg.config.warmup, reg.config.trials);
+  if (!bench_run_all(&reg)) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+  } else {
+    bench_print_table(&reg);
+    if (bench_export_csv(&reg, FILES_DIR "/bench_sorting.csv") &&
+        bench_export_json(&reg, FILES_DIR "/bench_sorting.json")) {
+      printf("\n  - Resultados: %s/bench_sorting.{csv,json}\n\n",
+             FILES_DIR);
+    } else {
+      handle_error(ERR_FILE_IO);
+    }
+  }
+
+  free(master_arr);
+  free(bench.work);
+  free(bench.buffer);
+}
+
 void run_algorithm_info(void) {
   printf("\n=== Información de Algoritmos ===\n\n");
   printf("Merge Sort:\n");
   printf("  - Complejidad: O(n log n) en todos los casos\n");
   printf("  - Memoria adicional: O(n)\n");
   printf("  - Estable: Sí\n\n");
-  printf("Quick Sort:\n");
-  printf("  - Complejidad: O(n log n) promedio, O(n²) peor caso\n");
+  printf("Quick Sort (Introsort):\n");
+  printf("  - Complejidad: O(n log n) en todos los casos\n");
+  printf("  - Pivote: mediana de tres (ninther para n >= %d)\n",
+         NINTHER_THRESHOLD);
+  printf("  - Partición en 3 vías (bandera holandesa) para duplicados\n");
+  printf("  - Insertion Sort para particiones <= %d elementos\n",
+         INSERTION_THRESHOLD);
+  printf("  - Heap Sort si la recursión supera 2*log2(n) niveles\n");
   printf("  - Memoria adicional: O(log n) (stack de recursión)\n");
   printf("  - Estable: No\n\n");
+  printf("Radix Sort (LSD / MSD paralelo):\n");
+  printf("  - Complejidad: O(w * n), sin comparaciones\n");
+  printf("  - Dígitos de %d bits, %d pasadas máximo para int de 32 bits\n",
+         RADIX_BITS, RADIX_DIGITS);
+  printf("  - Omite las pasadas cuyo dígito es igual en todas las claves\n");
+  printf("  - MSD paralelo: reparte los cubos entre %d hilos\n",
+         RADIX_THREADS);
+  printf("  - Memoria adicional: O(n)\n");
+  printf("  - Estable: Sí (LSD)\n\n");
+  printf("Caso base vectorial (AVX2):\n");
+  printf("  - Red de ordenamiento bitónica en registros de 256 bits\n");
+  printf("  - Bloques de 8/16/32/64 enteros sin saltos condicionales\n");
+  printf("  - Fusión de runs ordenados de 8 en 8 elementos\n\n");
+  printf("Ordenamiento externo:\n");
+  printf("  - Fase 1: lee bloques del tamaño de la memoria, los ordena con\n"
+         "    Radix MSD paralelo y los escribe como runs en %s/\n",
+         FILES_DIR);
+  printf("  - Fase 2: fusión k-way con árbol de perdedores (log k por "
+         "registro)\n");
+  printf("  - Doble buffer por run: un hilo de E/S rellena un buffer\n"
+         "    mientras se consume el otro\n\n");
   printf("Recomendación:\n");
   printf("  - Merge Sort: cuando se necesita estabilidad garantizada\n");
   printf("  - Quick Sort: mejor rendimiento en promedio para datos "
@@ -192,6 +719,17 @@ Status read_integer(int *value) {
   return SUCCESS;
 }
 
+Status read_string(char *buffer, int max_len) {
+  if (fgets(buffer, max_len, stdin) == NULL) {
+    return ERR_INVALID_INPUT;
+  }
+  size_t len = strlen(buffer);
+  if (len > 0 && buffer[len - 1] == '\n') {
+    buffer[len - 1] = '\0';
+  }
+  return SUCCESS;
+}
+
 Status generate_random_array(int **arr, int size) {
   *arr = (int *)malloc(size * sizeof(int));
   if (*arr == NULL) {
@@ -204,30 +742,86 @@ Status generate_random_array(int **arr, int size) {
   return SUCCESS;
 }
 
+void fill_pattern_array(int *arr, int size, InputPattern pattern) {
+  for (int i = 0; i < size; i++) {
+    switch (pattern) {
+    case PATTERN_RANDOM:
+      arr[i] = rand() % 10000;
+      break;
+    case PATTERN_SORTED:
+      arr[i] = i;
+      break;
+    case PATTERN_REVERSED:
+      arr[i] = size - i;
+      break;
+    case PATTERN_EQUAL:
+      arr[i] = 42;
+      break;
+    case PATTERN_ORGAN_PIPE:
+      arr[i] = (i < size / 2) ? i : size - i;
+      break;
+    }
+  }
+}
+
+const char *pattern_name(InputPattern pattern) {
+  switch (pattern) {
+  case PATTERN_RANDOM:
+    return "Aleatorio";
+  case PATTERN_SORTED:
+    return "Ordenado";
+  case PATTERN_REVERSED:
+    return "Inverso";
+  case PATTERN_EQUAL:
+    return "Iguales";
+  case PATTERN_ORGAN_PIPE:
+    return "Organo";
+  }
+  return "Desconocido";
+}
+
 void run_merge_sort(int *arr, int size, SortStats *stats) {
+  PerfCounters counters;
+
   printf("Ejecutando...\n");
 
-  int *temp = (int *)malloc(size * sizeof(int));
-  if (temp == NULL) {
-    handle_error(ERR_MEMORY_ALLOCATION);
+  perf_open(&counters);
+  perf_start(&counters);
+  Status status = measure_merge_sort(arr, size, stats);
+  perf_stop(&counters);
+  perf_close(&counters);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
 
-  clock_t start = clock();
-  merge_sort_recursive(arr, 0, size - 1, temp, &stats->comparisons);
-  clock_t end = clock();
-
-  stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-  free(temp);
-
   printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
   printf("  - Comparaciones: %llu\n", stats->comparisons);
   printf("  - Complejidad:   O(n log n)\n");
   printf("  - Memoria extra: O(n)\n");
+  print_perf_counters(&counters);
+}
+
+Status measure_merge_sort(int *arr, int size, SortStats *stats) {
+  int *temp = (int *)malloc(size * sizeof(int));
+  if (temp == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  double start = bench_now();
+  merge_sort_recursive(arr, 0, size - 1, temp, &stats->comparisons);
+  stats->time_taken = bench_now() - start;
+  free(temp);
+  return SUCCESS;
 }
 
 void merge_sort_recursive(int *arr, int l, int r, int *temp,
                           unsigned long long *comps) {
+  if (use_vector_base_case && r - l + 1 <= SIMD_BLOCK_MAX) {
+    sort_small_block(arr + l, r - l + 1);
+    return;
+  }
+
   if (l < r) {
     int m = l + (r - l) / 2;
     merge_sort_recursive(arr, l, m, temp, comps);
@@ -238,6 +832,14 @@ void merge_sort_recursive(int *arr, int l, int r, int *temp,
 
 void merge(int *arr, int l, int m, int r, int *temp,
            unsigned long long *comps) {
+#ifdef __x86_64__
+  if (use_vector_base_case && m - l + 1 >= SIMD_WIDTH && r - m >= SIMD_WIDTH) {
+    simd_merge_runs(arr + l, m - l + 1, arr + m + 1, r - m, temp + l);
+    memcpy(arr + l, temp + l, (r - l + 1) * sizeof(int));
+    return;
+  }
+#endif
+
   int i = l;
   int j = m + 1;
   int k = l;
@@ -264,87 +866,1328 @@ void merge(int *arr, int l, int m, int r, int *temp,
 }
 
 void run_quick_sort(int *arr, int size, SortStats *stats) {
-  printf("Ejecutando...\n");
+  PerfCounters counters;
 
-  clock_t start = clock();
-  quick_sort_recursive(arr, 0, size - 1, &stats->comparisons);
-  clock_t end = clock();
+  printf("Ejecutando...\n");
 
-  stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+  perf_open(&counters);
+  perf_start(&counters);
+  measure_quick_sort(arr, size, stats);
+  perf_stop(&counters);
+  perf_close(&counters);
 
   printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
   printf("  - Comparaciones: %llu\n", stats->comparisons);
-  printf("  - Complejidad:   O(n log n) promedio\n");
+  printf("  - Complejidad:   O(n log n) (Introsort)\n");
   printf("  - Memoria extra: O(log n) (Stack)\n");
+  print_perf_counters(&counters);
+}
+
+void measure_quick_sort(int *arr, int size, SortStats *stats) {
+  // Depth budget of 2*floor(log2(n)) before falling back to Heap Sort
+  int depth_limit = 0;
+  for (int n = size; n > 1; n >>= 1) {
+    depth_limit += 2;
+  }
+
+  double start = bench_now();
+  quick_sort_recursive(arr, 0, size - 1, depth_limit, &stats->comparisons);
+  stats->time_taken = bench_now() - start;
 }
 
-void quick_sort_recursive(int *arr, int low, int high,
+void quick_sort_recursive(int *arr, int low, int high, int depth_limit,
                           unsigned long long *comps) {
-  if (low < high) {
-    int pi = partition(arr, low, high, comps);
-    quick_sort_recursive(arr, low, pi - 1, comps);
-    quick_sort_recursive(arr, pi + 1, high, comps);
+  int cutoff = use_vector_base_case ? SIMD_BLOCK_MAX : INSERTION_THRESHOLD;
+
+  while (high - low + 1 > cutoff) {
+    if (depth_limit == 0) {
+      heap_sort_range(arr, low, high, comps);
+      return;
+    }
+    depth_limit--;
+
+    int pivot = arr[select_pivot(arr, low, high, comps)];
+    int lt, gt;
+    partition(arr, low, high, pivot, &lt, &gt, comps);
+
+    // Recurse into the smaller side and loop on the larger: O(log n) stack
+    if (lt - low < high - gt) {
+      quick_sort_recursive(arr, low, lt - 1, depth_limit, comps);
+      low = gt + 1;
+    } else {
+      quick_sort_recursive(arr, gt + 1, high, depth_limit, comps);
+      high = lt - 1;
+    }
+  }
+
+  if (use_vector_base_case) {
+    sort_small_block(arr + low, high - low + 1);
+  } else {
+    insertion_sort_range(arr, low, high, comps);
   }
 }
 
-int partition(int *arr, int low, int high, unsigned long long *comps) {
-  int pivot = arr[high];
-  int i = (low - 1);
+int select_pivot(const int *arr, int low, int high,
+                 unsigned long long *comps) {
+  int mid = low + (high - low) / 2;
 
-  for (int j = low; j <= high - 1; j++) {
+  if (high - low + 1 < NINTHER_THRESHOLD) {
+    return median_of_three(arr, low, mid, high, comps);
+  }
+
+  // Tukey's ninther: median of three medians of three
+  int step = (high - low + 1) / 8;
+  int m1 = median_of_three(arr, low, low + step, low + 2 * step, comps);
+  int m2 = median_of_three(arr, mid - step, mid, mid + step, comps);
+  int m3 = median_of_three(arr, high - 2 * step, high - step, high, comps);
+  return median_of_three(arr, m1, m2, m3, comps);
+}
+
+int median_of_three(const int *arr, int a, int b, int c,
+                    unsigned long long *comps) {
+  (*comps) += 3;
+  if (arr[a] < arr[b]) {
+    if (arr[b] < arr[c]) {
+      return b;
+    }
+    return (arr[a] < arr[c]) ? c : a;
+  }
+  if (arr[a] < arr[c]) {
+    return a;
+  }
+  return (arr[b] < arr[c]) ? c : b;
+}
+
+void partition(int *arr, int low, int high, int pivot, int *lt, int *gt,
+               unsigned long long *comps) {
+  // Dutch national flag: [low, l) < pivot, [l, i) == pivot, (g, high] > pivot
+  int l = low;
+  int i = low;
+  int g = high;
+
+  while (i <= g) {
+    (*comps)++;
+    if (arr[i] < pivot) {
+      swap(&arr[l++], &arr[i++]);
+      continue;
+    }
     (*comps)++;
-    if (arr[j] < pivot) {
+    if (arr[i] > pivot) {
+      swap(&arr[i], &arr[g--]);
+    } else {
       i++;
-      swap(&arr[i], &arr[j]);
     }
   }
 
-  swap(&arr[i + 1], &arr[high]);
-  return (i + 1);
+  *lt = l;
+  *gt = g;
 }
 
-void show_final_comparison(int size, SortStats merge_stats,
-                           SortStats quick_stats) {
-  double n = (double)size;
-  double log_n = log2(n);
-  double ratio = (n * n) / (n * log_n);
-  double base_time =
-      (quick_stats.time_taken > 0) ? quick_stats.time_taken : 0.000001;
-  double estimated_bubble_time = base_time * ratio * 0.5;
-
-  printf("\n=== Comparación con Bubble Sort (estimado) ===\n\n");
-  printf("  - Bubble Sort tomaría: ~%.4f segundos\n", estimated_bubble_time);
+void insertion_sort_range(int *arr, int low, int high,
+                          unsigned long long *comps) {
+  for (int i = low + 1; i <= high; i++) {
+    int key = arr[i];
+    int j = i - 1;
 
-  if (quick_stats.time_taken > 0) {
-    printf("  - Quick Sort es %.0fx más rápido que Bubble Sort\n",
-           estimated_bubble_time / quick_stats.time_taken);
+    while (j >= low) {
+      (*comps)++;
+      if (arr[j] <= key) {
+        break;
+      }
+      arr[j + 1] = arr[j];
+      j--;
+    }
+    arr[j + 1] = key;
   }
-  if (merge_stats.time_taken > 0) {
-    printf("  - Merge Sort es %.0fx más rápido que Bubble Sort\n",
-           estimated_bubble_time / merge_stats.time_taken);
+}
+
+void heap_sort_range(int *arr, int low, int high, unsigned long long *comps) {
+  int n = high - low + 1;
+  int *heap = arr + low;
+
+  for (int i = n / 2 - 1; i >= 0; i--) {
+    sift_down(heap, i, n, comps);
   }
 
-  printf("\n  - Recomendación para arrays grandes (>1000 elementos):\n");
-  printf("    + Quick Sort: más rápido en promedio\n");
-  printf("    + Merge Sort: estable y predecible\n\n");
+  for (int end = n - 1; end > 0; end--) {
+    swap(&heap[0], &heap[end]);
+    sift_down(heap, 0, end, comps);
+  }
 }
 
-void print_array_preview(const int *arr, int size) {
-  printf("[");
-  if (size <= 10) {
-    for (int i = 0; i < size; i++) {
-      printf("%d%s", arr[i], (i < size - 1) ? ", " : "");
+void sift_down(int *heap, int root, int n, unsigned long long *comps) {
+  while (2 * root + 1 < n) {
+    int child = 2 * root + 1;
+
+    if (child + 1 < n) {
+      (*comps)++;
+      if (heap[child] < heap[child + 1]) {
+        child++;
+      }
     }
-  } else {
-    printf("%d, %d, %d, ..., %d", arr[0], arr[1], arr[2], arr[size - 1]);
+
+    (*comps)++;
+    if (heap[root] >= heap[child]) {
+      return;
+    }
+
+    swap(&heap[root], &heap[child]);
+    root = child;
   }
-  printf("]\n");
 }
 
-void copy_array(const int *src, int *dest, int size) {
-  for (int i = 0; i < size; i++) {
-    dest[i] = src[i];
+void sort_small_block(int *arr, int n) {
+  if (n < 2) {
+    return;
+  }
+#ifdef __x86_64__
+  simd_sort_block(arr, n);
+#else
+  unsigned long long comps = 0;
+  insertion_sort_range(arr, 0, n - 1, &comps);
+#endif
+}
+
+int cpu_has_avx2(void) {
+#ifdef __x86_64__
+  return __builtin_cpu_supports("avx2");
+#else
+  return FALSE;
+#endif
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) __m256i simd_sort8(__m256i v) {
+  __m256i p;
+
+  // Bitonic network for 8 lanes: each step is one compare-exchange layer
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+  p = simd_reverse8(v);
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+  return v;
+}
+
+__attribute__((target("avx2"))) __m256i simd_bitonic_merge8(__m256i v) {
+  __m256i p;
+
+  // Half-cleaners at distance 4, 2 and 1 sort a bitonic register
+  p = _mm256_permute2x128_si256(v, v, 0x01);
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xF0);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xCC);
+  p = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+  v = _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), 0xAA);
+  return v;
+}
+
+__attribute__((target("avx2"))) __m256i simd_reverse8(__m256i v) {
+  return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1,
+                                                          0));
+}
+
+__attribute__((target("avx2"))) void simd_sort_registers(__m256i *r, int k) {
+  for (int i = 0; i < k; i++) {
+    r[i] = simd_sort8(r[i]);
+  }
+
+  // Merge sorted groups of `width` registers into groups of 2 * width
+  for (int width = 1; width < k; width *= 2) {
+    for (int base = 0; base < k; base += 2 * width) {
+      __m256i *group = r + base;
+
+      for (int i = 0; i < width; i++) {
+        __m256i mirror = simd_reverse8(group[2 * width - 1 - i]);
+        __m256i lo = _mm256_min_epi32(group[i], mirror);
+        __m256i hi = _mm256_max_epi32(group[i], mirror);
+        group[i] = lo;
+        group[2 * width - 1 - i] = simd_reverse8(hi);
+      }
+
+      for (int stride = width / 2; stride > 0; stride /= 2) {
+        for (int i = 0; i < 2 * width; i++) {
+          if ((i & stride) == 0) {
+            __m256i lo = _mm256_min_epi32(group[i], group[i + stride]);
+            __m256i hi = _mm256_max_epi32(group[i], group[i + stride]);
+            group[i] = lo;
+            group[i + stride] = hi;
+          }
+        }
+      }
+
+      for (int i = 0; i < 2 * width; i++) {
+        group[i] = simd_bitonic_merge8(group[i]);
+      }
+    }
+  }
+}
+
+__attribute__((target("avx2"))) void simd_sort_block(int *arr, int n) {
+  int block[SIMD_BLOCK_MAX];
+  __m256i regs[SIMD_BLOCK_MAX / SIMD_WIDTH];
+  int k = 1;
+
+  // Round up to 8/16/32/64 lanes and pad with INT_MAX, which sorts last
+  while (k * SIMD_WIDTH < n) {
+    k *= 2;
+  }
+  memcpy(block, arr, n * sizeof(int));
+  for (int i = n; i < k * SIMD_WIDTH; i++) {
+    block[i] = INT_MAX;
+  }
+
+  for (int i = 0; i < k; i++) {
+    regs[i] = _mm256_loadu_si256((const __m256i *)(block + i * SIMD_WIDTH));
+  }
+  simd_sort_registers(regs, k);
+  for (int i = 0; i < k; i++) {
+    _mm256_storeu_si256((__m256i *)(block + i * SIMD_WIDTH), regs[i]);
+  }
+
+  memcpy(arr, block, n * sizeof(int));
+}
+
+__attribute__((target("avx2"))) void simd_merge_runs(const int *a, int na,
+                                                     const int *b, int nb,
+                                                     int *out) {
+  __m256i lo = _mm256_loadu_si256((const __m256i *)a);
+  __m256i hi = _mm256_loadu_si256((const __m256i *)b);
+  int i = SIMD_WIDTH;
+  int j = SIMD_WIDTH;
+  int k = 0;
+
+  // Keep 8 pending values in `hi`; each round emits the lowest 8 of 16
+  while (TRUE) {
+    __m256i mirror = simd_reverse8(hi);
+    __m256i mn = _mm256_min_epi32(lo, mirror);
+    __m256i mx = _mm256_max_epi32(lo, mirror);
+    _mm256_storeu_si256((__m256i *)(out + k), simd_bitonic_merge8(mn));
+    hi = simd_bitonic_merge8(mx);
+    k += SIMD_WIDTH;
+
+    // Only refill while both runs hold a full chunk, so that the chunk
+    // with the smaller head is always the next one to enter
+    if (i + SIMD_WIDTH > na || j + SIMD_WIDTH > nb) {
+      break;
+    }
+    if (a[i] <= b[j]) {
+      lo = _mm256_loadu_si256((const __m256i *)(a + i));
+      i += SIMD_WIDTH;
+    } else {
+      lo = _mm256_loadu_si256((const __m256i *)(b + j));
+      j += SIMD_WIDTH;
+    }
+  }
+
+  // Scalar 3-way merge of the pending register and both tails
+  int pending[SIMD_WIDTH];
+  int p = 0;
+  _mm256_storeu_si256((__m256i *)pending, hi);
+
+  while (p < SIMD_WIDTH || i < na || j < nb) {
+    int best = INT_MAX;
+    int from = -1;
+    if (p < SIMD_WIDTH) {
+      best = pending[p];
+      from = 0;
+    }
+    if (i < na && (from < 0 || a[i] < best)) {
+      best = a[i];
+      from = 1;
+    }
+    if (j < nb && (from < 0 || b[j] < best)) {
+      best = b[j];
+      from = 2;
+    }
+
+    out[k++] = best;
+    if (from == 0) {
+      p++;
+    } else if (from == 1) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+}
+#endif
+
+ssize_t read_full(int fd, char *buf, size_t count) {
+  size_t done = 0;
+  while (done < count) {
+    ssize_t n = read(fd, buf + done, count - done);
+    if (n < 0) {
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    done += (size_t)n;
+  }
+  return (ssize_t)done;
+}
+
+int write_all(int fd, const char *buf, size_t count) {
+  while (count > 0) {
+    ssize_t n = write(fd, buf, count);
+    if (n < 0) {
+      return FALSE;
+    }
+    buf += n;
+    count -= (size_t)n;
+  }
+  return TRUE;
+}
+
+int record_key(const char *record) {
+  int key;
+  memcpy(&key, record, sizeof(int));
+  return key;
+}
+
+Status generate_external_input(const char *path, long long count,
+                               int record_size) {
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return ERR_FILE_IO;
+  }
+
+  size_t batch = EXTERNAL_IO_BLOCK / record_size;
+  char *buf = (char *)malloc(batch * record_size);
+  if (buf == NULL) {
+    close(fd);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Keys span the whole signed range; the payload is the record number
+  for (long long done = 0; done < count;) {
+    size_t n = (count - done < (long long)batch) ? (size_t)(count - done)
+                                                 : batch;
+    for (size_t i = 0; i < n; i++) {
+      char *record = buf + i * record_size;
+      int key = (int)(((unsigned int)rand() << 16) ^ (unsigned int)rand());
+      memset(record, 0, record_size);
+      memcpy(record, &key, sizeof(int));
+      if (record_size >= (int)(sizeof(int) + sizeof(long long))) {
+        long long seq = done + (long long)i;
+        memcpy(record + sizeof(int), &seq, sizeof(long long));
+      }
+    }
+    if (!write_all(fd, buf, n * record_size)) {
+      free(buf);
+      close(fd);
+      return ERR_FILE_IO;
+    }
+    done += (long long)n;
+  }
+
+  free(buf);
+  close(fd);
+  return SUCCESS;
+}
+
+void run_file_path(char *path, int run) {
+  snprintf(path, MAX_PATH, "%s/run_%04d.bin", FILES_DIR, run);
+}
+
+void sort_chunk(char *records, int count, size_t record_size, char *scratch,
+                KeyValue *pairs) {
+  if (record_size == sizeof(int)) {
+    radix_sort_msd_parallel((int *)records, count, (int *)scratch);
+    return;
+  }
+
+  // Sort (key, index) pairs, then gather whole records in key order
+  KeyValue *pair_buffer = (KeyValue *)scratch;
+  for (int i = 0; i < count; i++) {
+    pairs[i].key = record_key(records + (size_t)i * record_size);
+    pairs[i].value = i;
+  }
+  radix_sort_pairs(pairs, count, pair_buffer);
+
+  char *gathered = (char *)(pair_buffer + count);
+  for (int i = 0; i < count; i++) {
+    memcpy(gathered + (size_t)i * record_size,
+           records + (size_t)pairs[i].value * record_size, record_size);
+  }
+  memcpy(records, gathered, (size_t)count * record_size);
+}
+
+Status create_sorted_runs(int in_fd, size_t record_size, size_t memory_bytes,
+                          ExternalStats *stats) {
+  // Ints need a ping-pong buffer; records also need two pair arrays
+  size_t per_record = (record_size == sizeof(int))
+                          ? 2 * record_size
+                          : 2 * record_size + 2 * sizeof(KeyValue);
+  size_t chunk_records = memory_bytes / per_record;
+  if (chunk_records > INT_MAX / 2) {
+    chunk_records = INT_MAX / 2;
+  }
+  if (chunk_records < SIMD_BLOCK_MAX) {
+    return ERR_INVALID_INPUT;
+  }
+
+  // Scratch is the radix ping-pong buffer, or pair buffer + gather area
+  size_t scratch_bytes = (record_size == sizeof(int))
+                             ? chunk_records * record_size
+                             : chunk_records * (sizeof(KeyValue) + record_size);
+  char *records = (char *)malloc(chunk_records * record_size);
+  char *scratch = (char *)malloc(scratch_bytes);
+  KeyValue *pairs = NULL;
+  if (record_size != sizeof(int)) {
+    pairs = (KeyValue *)malloc(chunk_records * sizeof(KeyValue));
+  }
+  if (records == NULL || scratch == NULL ||
+      (record_size != sizeof(int) && pairs == NULL)) {
+    free(records);
+    free(scratch);
+    free(pairs);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  Status status = SUCCESS;
+  while (TRUE) {
+    ssize_t bytes = read_full(in_fd, records, chunk_records * record_size);
+    if (bytes < 0) {
+      status = ERR_FILE_IO;
+      break;
+    }
+    // Chunks are whole records: a remainder is a truncated last record
+    if ((size_t)bytes % record_size != 0) {
+      status = ERR_PARTIAL_RECORD;
+      break;
+    }
+    int count = (int)((size_t)bytes / record_size);
+    if (count == 0) {
+      break;
+    }
+
+    sort_chunk(records, count, record_size, scratch, pairs);
+
+    char path[MAX_PATH];
+    run_file_path(path, stats->runs);
+    int run_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (run_fd < 0) {
+      status = ERR_FILE_IO;
+      break;
+    }
+    int written = write_all(run_fd, records, (size_t)count * record_size);
+    close(run_fd);
+    if (!written) {
+      status = ERR_FILE_IO;
+      break;
+    }
+
+    stats->runs++;
+    stats->records += count;
+  }
+
+  free(records);
+  free(scratch);
+  free(pairs);
+  return status;
+}
+
+void *io_worker(void *arg) {
+  IoScheduler *io = (IoScheduler *)arg;
+
+  pthread_mutex_lock(&io->lock);
+  while (TRUE) {
+    while (io->head == io->tail && !io->shutdown) {
+      pthread_cond_wait(&io->requested, &io->lock);
+    }
+    if (io->head == io->tail) {
+      break;
+    }
+
+    IoRequest req = io->queue[io->head % io->capacity];
+    io->head++;
+    RunReader *run = &io->runs[req.run];
+    pthread_mutex_unlock(&io->lock);
+
+    // Requests for one run are queued in order, so offsets stay sequential
+    ssize_t n = pread(run->fd, run->buffers[req.buffer], io->buffer_bytes,
+                      run->file_offset);
+    int failed = (n < 0);
+    if (failed) {
+      n = 0; // Ends the run so the merge can finish and report it
+    }
+    run->file_offset += n;
+
+    pthread_mutex_lock(&io->lock);
+    io->failed = io->failed || failed;
+    run->lengths[req.buffer] = (size_t)n;
+    run->ready[req.buffer] = TRUE;
+    pthread_cond_broadcast(&io->filled);
+  }
+  pthread_mutex_unlock(&io->lock);
+
+  return NULL;
+}
+
+void request_refill(IoScheduler *io, int run, int buffer) {
+  pthread_mutex_lock(&io->lock);
+  io->runs[run].ready[buffer] = FALSE;
+  io->queue[io->tail % io->capacity].run = run;
+  io->queue[io->tail % io->capacity].buffer = buffer;
+  io->tail++;
+  pthread_cond_signal(&io->requested);
+  pthread_mutex_unlock(&io->lock);
+}
+
+const char *run_head(IoScheduler *io, int run) {
+  RunReader *reader = &io->runs[run];
+
+  if (reader->pos < reader->available) {
+    return reader->buffers[reader->active] + reader->pos;
+  }
+
+  // Active buffer drained: refill it in the background, use the other one
+  if (reader->available > 0) {
+    request_refill(io, run, reader->active);
+    reader->active = 1 - reader->active;
+    reader->pos = 0;
+  }
+
+  pthread_mutex_lock(&io->lock);
+  while (!reader->ready[reader->active]) {
+    pthread_cond_wait(&io->filled, &io->lock);
+  }
+  reader->available = reader->lengths[reader->active];
+  pthread_mutex_unlock(&io->lock);
+
+  if (reader->available == 0) {
+    return NULL;
+  }
+  return reader->buffers[reader->active] + reader->pos;
+}
+
+void loser_tree_adjust(int *tree, const long long *keys, int k, int s) {
+  for (int parent = (s + k) / 2; parent > 0; parent /= 2) {
+    if (keys[s] > keys[tree[parent]]) {
+      int loser = s;
+      s = tree[parent];
+      tree[parent] = loser;
+    }
+  }
+  tree[0] = s;
+}
+
+// Smallest buffer that holds whole records and keeps reads page-aligned
+size_t merge_unit(size_t record_size) {
+  size_t a = record_size;
+  size_t b = EXTERNAL_ALIGN;
+  while (b != 0) {
+    size_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return record_size / a * EXTERNAL_ALIGN;
+}
+
+// Merges at most as many runs at once as the budget has buffers for; the
+// rest go through intermediate runs appended after the last one
+Status merge_all_runs(int num_runs, int out_fd, size_t record_size,
+                      size_t memory_bytes, int *extra_merges) {
+  size_t units = memory_bytes / merge_unit(record_size);
+  int fan_in = num_runs;
+  int first = 0;
+  int last = num_runs;
+  Status status = SUCCESS;
+
+  if (units <= 2 * (size_t)num_runs) {
+    fan_in = (units >= 3) ? (int)((units - 1) / 2) : 0;
+  }
+  *extra_merges = 0;
+  if (fan_in < 1 || (fan_in < 2 && num_runs > 1)) {
+    status = ERR_INVALID_INPUT;
+  }
+  while (status == SUCCESS && last - first > fan_in) {
+    char path[MAX_PATH];
+    run_file_path(path, last);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      status = ERR_FILE_IO;
+      break;
+    }
+    status = merge_runs(first, fan_in, fd, record_size, memory_bytes);
+    if (close(fd) != 0 && status == SUCCESS) {
+      status = ERR_FILE_IO;
+    }
+    first += fan_in;
+    last++;
+    (*extra_merges)++;
+  }
+
+  if (status == SUCCESS) {
+    return merge_runs(first, last - first, out_fd, record_size,
+                      memory_bytes);
+  }
+  // Including the intermediate run that was being written
+  remove_run_files(last + 1);
+  return status;
+}
+
+Status merge_runs(int first, int num_runs, int out_fd, size_t record_size,
+                  size_t memory_bytes) {
+  IoScheduler io;
+  int k = num_runs;
+
+  // Two read buffers per run plus one output buffer share the budget,
+  // which merge_all_runs made large enough for one unit each
+  size_t unit = merge_unit(record_size);
+  size_t buffer_bytes = memory_bytes / (2 * (size_t)k + 1);
+  buffer_bytes -= buffer_bytes % unit;
+  if (buffer_bytes == 0) {
+    return ERR_INVALID_INPUT;
+  }
+
+  memset(&io, 0, sizeof(io));
+  io.buffer_bytes = buffer_bytes;
+  io.capacity = 2 * k;
+  io.runs = (RunReader *)calloc(k, sizeof(RunReader));
+  io.queue = (IoRequest *)malloc(io.capacity * sizeof(IoRequest));
+  long long *keys = (long long *)malloc((k + 1) * sizeof(long long));
+  int *tree = (int *)calloc(k, sizeof(int));
+  char *out_buf = (char *)malloc(buffer_bytes);
+  if (io.runs == NULL || io.queue == NULL || keys == NULL || tree == NULL ||
+      out_buf == NULL) {
+    free(io.runs);
+    free(io.queue);
+    free(keys);
+    free(tree);
+    free(out_buf);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  Status status = SUCCESS;
+  for (int r = 0; r < k; r++) {
+    char path[MAX_PATH];
+    run_file_path(path, first + r);
+    io.runs[r].fd = open(path, O_RDONLY);
+    io.runs[r].buffers[0] = (char *)malloc(buffer_bytes);
+    io.runs[r].buffers[1] = (char *)malloc(buffer_bytes);
+    if (io.runs[r].fd < 0) {
+      status = ERR_FILE_IO;
+    } else if (io.runs[r].buffers[0] == NULL ||
+               io.runs[r].buffers[1] == NULL) {
+      status = ERR_MEMORY_ALLOCATION;
+    }
+  }
+
+  pthread_t io_thread;
+  pthread_mutex_init(&io.lock, NULL);
+  pthread_cond_init(&io.filled, NULL);
+  pthread_cond_init(&io.requested, NULL);
+  int io_started = FALSE;
+  if (status == SUCCESS) {
+    if (pthread_create(&io_thread, NULL, io_worker, &io) != 0) {
+      status = ERR_THREAD_CREATE;
+    } else {
+      io_started = TRUE;
+    }
+  }
+
+  if (status == SUCCESS) {
+    for (int r = 0; r < k; r++) {
+      request_refill(&io, r, 0);
+      request_refill(&io, r, 1);
+    }
+
+    // Loser tree: keys[k] is a -inf sentinel used only while building
+    for (int r = 0; r < k; r++) {
+      tree[r] = k;
+    }
+    keys[k] = LLONG_MIN;
+    for (int r = k - 1; r >= 0; r--) {
+      const char *head = run_head(&io, r);
+      keys[r] = (head != NULL) ? record_key(head) : LLONG_MAX;
+      loser_tree_adjust(tree, keys, k, r);
+    }
+
+    size_t out_len = 0;
+    while (keys[tree[0]] != LLONG_MAX) {
+      int winner = tree[0];
+      RunReader *run = &io.runs[winner];
+
+      memcpy(out_buf + out_len, run->buffers[run->active] + run->pos,
+             record_size);
+      out_len += record_size;
+      run->pos += record_size;
+      if (out_len == buffer_bytes) {
+        if (!write_all(out_fd, out_buf, out_len)) {
+          status = ERR_FILE_IO;
+          break;
+        }
+        out_len = 0;
+      }
+
+      const char *head = run_head(&io, winner);
+      keys[winner] = (head != NULL) ? record_key(head) : LLONG_MAX;
+      loser_tree_adjust(tree, keys, k, winner);
+    }
+
+    if (status == SUCCESS && !write_all(out_fd, out_buf, out_len)) {
+      status = ERR_FILE_IO;
+    }
+  }
+  if (status == SUCCESS && io.failed) {
+    status = ERR_FILE_IO;
+  }
+
+  if (io_started) {
+    pthread_mutex_lock(&io.lock);
+    io.shutdown = TRUE;
+    pthread_cond_signal(&io.requested);
+    pthread_mutex_unlock(&io.lock);
+    pthread_join(io_thread, NULL);
+  }
+  pthread_mutex_destroy(&io.lock);
+  pthread_cond_destroy(&io.filled);
+  pthread_cond_destroy(&io.requested);
+
+  for (int r = 0; r < k; r++) {
+    char path[MAX_PATH];
+    run_file_path(path, first + r);
+    if (io.runs[r].fd >= 0) {
+      close(io.runs[r].fd);
+    }
+    unlink(path);
+    free(io.runs[r].buffers[0]);
+    free(io.runs[r].buffers[1]);
+  }
+
+  free(io.runs);
+  free(io.queue);
+  free(keys);
+  free(tree);
+  free(out_buf);
+  return status;
+}
+
+Status external_sort_file(const char *in_path, const char *out_path,
+                          size_t record_size, size_t memory_bytes,
+                          ExternalStats *stats) {
+  int in_fd = open(in_path, O_RDONLY);
+  if (in_fd < 0) {
+    return ERR_FILE_IO;
+  }
+  posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  double start = bench_now();
+  Status status = create_sorted_runs(in_fd, record_size, memory_bytes, stats);
+  close(in_fd);
+  stats->split_time = bench_now() - start;
+  if (status != SUCCESS) {
+    // Including the run that was being written when phase 1 failed
+    remove_run_files(stats->runs + 1);
+    return status;
+  }
+
+  int out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0) {
+    remove_run_files(stats->runs);
+    return ERR_FILE_IO;
+  }
+
+  start = bench_now();
+  if (stats->runs > 0) {
+    status = merge_all_runs(stats->runs, out_fd, record_size, memory_bytes,
+                            &stats->extra_merges);
+  }
+  close(out_fd);
+  stats->merge_time = bench_now() - start;
+  return status;
+}
+
+void remove_run_files(int count) {
+  for (int r = 0; r < count; r++) {
+    char path[MAX_PATH];
+    run_file_path(path, r);
+    unlink(path);
+  }
+}
+
+// Sorted, readable to the end and exactly as many records as the input
+int verify_sorted_file(const char *path, size_t record_size,
+                       long long expected_records) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return FALSE;
+  }
+
+  size_t block = EXTERNAL_IO_BLOCK - EXTERNAL_IO_BLOCK % record_size;
+  char *buf = (char *)malloc(block);
+  if (buf == NULL) {
+    close(fd);
+    return FALSE;
+  }
+
+  long long prev = LLONG_MIN;
+  long long records = 0;
+  int ok = TRUE;
+  ssize_t n;
+  while (ok && (n = read_full(fd, buf, block)) > 0) {
+    if ((size_t)n % record_size != 0) {
+      ok = FALSE;
+      break;
+    }
+    for (size_t off = 0; off < (size_t)n; off += record_size) {
+      int key = record_key(buf + off);
+      if (key < prev) {
+        ok = FALSE;
+        break;
+      }
+      prev = key;
+    }
+    records += (long long)((size_t)n / record_size);
+  }
+  if (n < 0 || records != expected_records) {
+    ok = FALSE;
+  }
+
+  free(buf);
+  close(fd);
+  return ok;
+}
+
+void bench_sort_setup(void *ctx) {
+  SortBench *bench = (SortBench *)ctx;
+  copy_array(bench->master, bench->work, bench->size);
+  bench->comps = 0;
+}
+
+void bench_merge_kernel(void *ctx) {
+  SortBench *bench = (SortBench *)ctx;
+  merge_sort_recursive(bench->work, 0, bench->size - 1, bench->buffer,
+                       &bench->comps);
+}
+
+void bench_quick_kernel(void *ctx) {
+  SortBench *bench = (SortBench *)ctx;
+  int depth_limit = 0;
+  for (int n = bench->size; n > 1; n >>= 1) {
+    depth_limit += 2;
+  }
+  quick_sort_recursive(bench->work, 0, bench->size - 1, depth_limit,
+                       &bench->comps);
+}
+
+void bench_radix_kernel(void *ctx) {
+  SortBench *bench = (SortBench *)ctx;
+  radix_sort_lsd(bench->work, bench->size, bench->buffer);
+}
+
+void bench_parallel_radix_kernel(void *ctx) {
+  SortBench *bench = (SortBench *)ctx;
+  radix_sort_msd_parallel(bench->work, bench->size, bench->buffer);
+}
+
+void show_final_comparison(int size, SortStats merge_stats,
+                           SortStats quick_stats) {
+  double n = (double)size;
+  double log_n = log2(n);
+  double ratio = (n * n) / (n * log_n);
+  double base_time =
+      (quick_stats.time_taken > 0) ? quick_stats.time_taken : 0.000001;
+  double estimated_bubble_time = base_time * ratio * 0.5;
+
+  printf("\n=== Comparación con Bubble Sort (estimado) ===\n\n");
+  printf("  - Bubble Sort tomaría: ~%.4f segundos\n", estimated_bubble_time);
+
+  if (quick_stats.time_taken > 0) {
+    printf("  - Quick Sort es %.0fx más rápido que Bubble Sort\n",
+           estimated_bubble_time / quick_stats.time_taken);
+  }
+  if (merge_stats.time_taken > 0) {
+    printf("  - Merge Sort es %.0fx más rápido que Bubble Sort\n",
+           estimated_bubble_time / merge_stats.time_taken);
+  }
+
+  printf("\n  - Recomendación para arrays grandes (>1000 elementos):\n");
+  printf("    + Quick Sort: más rápido en promedio\n");
+  printf("    + Merge Sort: estable y predecible\n\n");
+}
+
+void run_radix_sort(int *arr, int size, SortStats *stats) {
+  PerfCounters counters;
+
+  printf("Ejecutando...\n");
+
+  perf_open(&counters);
+  perf_start(&counters);
+  Status status = measure_radix_sort(arr, size, stats);
+  perf_stop(&counters);
+  perf_close(&counters);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
+  printf("  - Pasadas:       %d de %d (dígitos constantes omitidos)\n",
+         stats->passes, RADIX_DIGITS);
+  printf("  - Complejidad:   O(w * n), w = %d bits por dígito\n", RADIX_BITS);
+  printf("  - Memoria extra: O(n) (buffer ping-pong)\n");
+  print_perf_counters(&counters);
+}
+
+void run_parallel_radix_sort(int *arr, int size, SortStats *stats) {
+  PerfCounters counters;
+
+  printf("Ejecutando con %d hilos...\n", RADIX_THREADS);
+
+  // Counters are inherited, so the worker threads are included
+  perf_open(&counters);
+  perf_start(&counters);
+  Status status = measure_parallel_radix_sort(arr, size, stats);
+  perf_stop(&counters);
+  perf_close(&counters);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("  - Tiempo:        %.6f segundos\n", stats->time_taken);
+  if (size < RADIX_PARALLEL_THRESHOLD) {
+    printf("  - Nota:          n < %d, se usó LSD secuencial\n",
+           RADIX_PARALLEL_THRESHOLD);
+  }
+  printf("  - Complejidad:   O(w * n / p)\n");
+  printf("  - Memoria extra: O(n) (buffer ping-pong)\n");
+  print_perf_counters(&counters);
+}
+
+Status measure_radix_sort(int *arr, int size, SortStats *stats) {
+  int *buffer = (int *)malloc(size * sizeof(int));
+  if (buffer == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  double start = bench_now();
+  stats->passes = radix_sort_lsd(arr, size, buffer);
+  stats->time_taken = bench_now() - start;
+  free(buffer);
+  return SUCCESS;
+}
+
+Status measure_parallel_radix_sort(int *arr, int size, SortStats *stats) {
+  int *buffer = (int *)malloc(size * sizeof(int));
+  if (buffer == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  double start = bench_now();
+  radix_sort_msd_parallel(arr, size, buffer);
+  stats->time_taken = bench_now() - start;
+  free(buffer);
+  return SUCCESS;
+}
+
+unsigned int radix_key(int value) {
+  // Flipping the sign bit makes signed ints sort correctly as unsigned
+  return (unsigned int)value ^ 0x80000000u;
+}
+
+void compute_histograms(const int *arr, int size, int digits,
+                        unsigned int hist[][RADIX_BUCKETS]) {
+  memset(hist, 0, digits * sizeof(hist[0]));
+
+  // One read pass builds the counts for every digit up front
+  for (int i = 0; i < size; i++) {
+    unsigned int key = radix_key(arr[i]);
+    for (int d = 0; d < digits; d++) {
+      hist[d][(key >> (d * RADIX_BITS)) & RADIX_MASK]++;
+    }
+  }
+}
+
+int digit_is_constant(const unsigned int *counts, int size) {
+  for (int b = 0; b < RADIX_BUCKETS; b++) {
+    if (counts[b] != 0) {
+      return counts[b] == (unsigned int)size;
+    }
+  }
+  return TRUE;
+}
+
+int *lsd_sort_digits(int *src, int *dst, int size, int digits,
+                     unsigned int hist[][RADIX_BUCKETS], int *passes) {
+  unsigned int offsets[RADIX_BUCKETS];
+
+  for (int d = 0; d < digits; d++) {
+    if (digit_is_constant(hist[d], size)) {
+      continue;
+    }
+
+    unsigned int sum = 0;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+      offsets[b] = sum;
+      sum += hist[d][b];
+    }
+
+    int shift = d * RADIX_BITS;
+    for (int i = 0; i < size; i++) {
+      unsigned int digit = (radix_key(src[i]) >> shift) & RADIX_MASK;
+      dst[offsets[digit]++] = src[i];
+    }
+
+    int *tmp = src;
+    src = dst;
+    dst = tmp;
+    if (passes != NULL) {
+      (*passes)++;
+    }
+  }
+
+  return src;
+}
+
+int radix_sort_lsd(int *arr, int size, int *buffer) {
+  unsigned int hist[RADIX_DIGITS][RADIX_BUCKETS];
+  int passes = 0;
+
+  compute_histograms(arr, size, RADIX_DIGITS, hist);
+  int *sorted = lsd_sort_digits(arr, buffer, size, RADIX_DIGITS, hist, &passes);
+  if (sorted != arr) {
+    memcpy(arr, sorted, size * sizeof(int));
+  }
+  return passes;
+}
+
+void radix_sort_pairs(KeyValue *pairs, int size, KeyValue *buffer) {
+  unsigned int hist[RADIX_DIGITS][RADIX_BUCKETS];
+  unsigned int offsets[RADIX_BUCKETS];
+  KeyValue *src = pairs;
+  KeyValue *dst = buffer;
+
+  memset(hist, 0, sizeof(hist));
+  for (int i = 0; i < size; i++) {
+    unsigned int key = radix_key(pairs[i].key);
+    for (int d = 0; d < RADIX_DIGITS; d++) {
+      hist[d][(key >> (d * RADIX_BITS)) & RADIX_MASK]++;
+    }
+  }
+
+  for (int d = 0; d < RADIX_DIGITS; d++) {
+    if (digit_is_constant(hist[d], size)) {
+      continue;
+    }
+
+    unsigned int sum = 0;
+    for (int b = 0; b < RADIX_BUCKETS; b++) {
+      offsets[b] = sum;
+      sum += hist[d][b];
+    }
+
+    int shift = d * RADIX_BITS;
+    for (int i = 0; i < size; i++) {
+      unsigned int digit = (radix_key(src[i].key) >> shift) & RADIX_MASK;
+      dst[offsets[digit]++] = src[i];
+    }
+
+    KeyValue *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != pairs) {
+    memcpy(pairs, src, size * sizeof(KeyValue));
+  }
+}
+
+void *radix_bucket_worker(void *arg) {
+  RadixJob *job = (RadixJob *)arg;
+  unsigned int hist[RADIX_DIGITS][RADIX_BUCKETS];
+
+  while (TRUE) {
+    pthread_mutex_lock(&job->lock);
+    int b = job->next_bucket++;
+    pthread_mutex_unlock(&job->lock);
+
+    if (b >= RADIX_BUCKETS) {
+      break;
+    }
+
+    // After the MSD scatter the bucket lives in buffer; finish it in arr
+    int start = job->bucket_start[b];
+    int n = job->bucket_start[b + 1] - start;
+    if (n == 0) {
+      continue;
+    }
+
+    int *src = job->buffer + start;
+    int *dst = job->arr + start;
+    compute_histograms(src, n, job->digits, hist);
+    int *sorted = lsd_sort_digits(src, dst, n, job->digits, hist, NULL);
+    if (sorted != dst) {
+      memcpy(dst, sorted, n * sizeof(int));
+    }
+  }
+
+  return NULL;
+}
+
+void radix_sort_msd_parallel(int *arr, int size, int *buffer) {
+  if (size < RADIX_PARALLEL_THRESHOLD) {
+    radix_sort_lsd(arr, size, buffer);
+    return;
+  }
+
+  unsigned int hist[RADIX_DIGITS][RADIX_BUCKETS];
+  compute_histograms(arr, size, RADIX_DIGITS, hist);
+
+  // Split on the most significant digit that actually varies
+  int msd = RADIX_DIGITS - 1;
+  while (msd >= 0 && digit_is_constant(hist[msd], size)) {
+    msd--;
+  }
+  if (msd < 0) {
+    return;
+  }
+
+  RadixJob job;
+  job.arr = arr;
+  job.buffer = buffer;
+  job.digits = msd;
+  job.next_bucket = 0;
+
+  int sum = 0;
+  for (int b = 0; b < RADIX_BUCKETS; b++) {
+    job.bucket_start[b] = sum;
+    sum += hist[msd][b];
+  }
+  job.bucket_start[RADIX_BUCKETS] = sum;
+
+  int offsets[RADIX_BUCKETS];
+  memcpy(offsets, job.bucket_start, sizeof(offsets));
+  int shift = msd * RADIX_BITS;
+  for (int i = 0; i < size; i++) {
+    unsigned int digit = (radix_key(arr[i]) >> shift) & RADIX_MASK;
+    buffer[offsets[digit]++] = arr[i];
+  }
+
+  pthread_t threads[RADIX_THREADS];
+  int created = 0;
+  pthread_mutex_init(&job.lock, NULL);
+
+  for (int t = 0; t < RADIX_THREADS; t++) {
+    if (pthread_create(&threads[t], NULL, radix_bucket_worker, &job) != 0) {
+      break;
+    }
+    created++;
+  }
+
+  // Whatever buckets are left (e.g. thread creation failed) run here
+  radix_bucket_worker(&job);
+
+  for (int t = 0; t < created; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  pthread_mutex_destroy(&job.lock);
+}
+
+Status verify_radix_pairs(const int *src, int size, int *is_stable) {
+  KeyValue *pairs = (KeyValue *)malloc(size * sizeof(KeyValue));
+  KeyValue *buffer = (KeyValue *)malloc(size * sizeof(KeyValue));
+  if (pairs == NULL || buffer == NULL) {
+    free(pairs);
+    free(buffer);
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Shift keys to include negatives; the value records the original index
+  for (int i = 0; i < size; i++) {
+    pairs[i].key = src[i] - 5000;
+    pairs[i].value = i;
+  }
+
+  radix_sort_pairs(pairs, size, buffer);
+
+  *is_stable = TRUE;
+  for (int i = 1; i < size; i++) {
+    if (pairs[i - 1].key > pairs[i].key ||
+        (pairs[i - 1].key == pairs[i].key &&
+         pairs[i - 1].value > pairs[i].value)) {
+      *is_stable = FALSE;
+      break;
+    }
+  }
+
+  free(pairs);
+  free(buffer);
+  return SUCCESS;
+}
+
+void show_radix_comparison(SortStats merge_stats, SortStats quick_stats,
+                           SortStats radix_stats, SortStats parallel_stats) {
+  double lsd = (radix_stats.time_taken > 0) ? radix_stats.time_taken : 0.000001;
+  double msd =
+      (parallel_stats.time_taken > 0) ? parallel_stats.time_taken : 0.000001;
+
+  printf("=== Radix Sort vs Ordenamientos por Comparación ===\n\n");
+  printf("  - Radix LSD es %.1fx más rápido que Merge Sort\n",
+         merge_stats.time_taken / lsd);
+  printf("  - Radix LSD es %.1fx más rápido que Quick Sort\n",
+         quick_stats.time_taken / lsd);
+  printf("  - Radix MSD paralelo es %.1fx más rápido que Quick Sort\n\n",
+         quick_stats.time_taken / msd);
+}
+
+void print_array_preview(const int *arr, int size) {
+  printf("[");
+  if (size <= 10) {
+    for (int i = 0; i < size; i++) {
+      printf("%d%s", arr[i], (i < size - 1) ? ", " : "");
+    }
+  } else {
+    printf("%d, %d, %d, ..., %d", arr[0], arr[1], arr[2], arr[size - 1]);
+  }
+  printf("]\n");
+}
+
+void copy_array(const int *src, int *dest, int size) {
+  for (int i = 0; i < size; i++) {
+    dest[i] = src[i];
+  }
+}
+
+void print_perf_counters(const PerfCounters *pc) {
+  char cycles[16], instructions[16], cache[16], branch[16];
+
+  if (pc->opened == 0) {
+    printf("  - Contadores HW: no disponibles (perf_event_open: %s)\n",
+           strerror(pc->error));
+    return;
+  }
+
+  perf_format_event(pc, PERF_CYCLES, cycles, sizeof(cycles));
+  perf_format_event(pc, PERF_INSTRUCTIONS, instructions,
+                    sizeof(instructions));
+  perf_format_event(pc, PERF_CACHE_MISSES, cache, sizeof(cache));
+  perf_format_event(pc, PERF_BRANCH_MISSES, branch, sizeof(branch));
+
+  printf("  - Ciclos:        %s\n", cycles);
+  printf("  - Instrucciones: %s (IPC %.2f)\n", instructions, perf_ipc(pc));
+  printf("  - Fallos caché:  %s (LLC)\n", cache);
+  printf("  - Fallos salto:  %s\n", branch);
+}
+
+int is_sorted(const int *arr, int size) {
+  for (int i = 1; i < size; i++) {
+    if (arr[i - 1] > arr[i]) {
+      return FALSE;
+    }
   }
+  return TRUE;
 }
 
 void swap(int *a, int *b) {
@@ -11,19 +11,27 @@
  - Performance tracking (Time, subproblems, iterations)
  - Estimation logic for pure recursion comparison
  - Interactive menu for repeated benchmarks
+ - Benchmark harness mode with repeated trials and CSV/JSON export
  ===============================================================================
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "bench_harness.h"
+
 #define TRUE 1
 #define FALSE 0
 #define RECURSION_LIMIT 45
+#define HARNESS_RECURSION_LIMIT 32
 #define MIN_OPTION 1
-#define MAX_OPTION 3
+#define MAX_OPTION 4
+#define FILES_DIR "files"
 
 typedef enum {
   SUCCESS,
@@ -40,10 +48,18 @@ typedef struct {
   int iterations;
 } DPStats;
 
+typedef struct {
+  int n;
+  unsigned long long *memo;
+  int counter;
+  unsigned long long sink;
+} FibBench;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_benchmark(void);
 void run_algorithm_info(void);
+void run_harness_benchmark(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
@@ -55,6 +71,9 @@ unsigned long long fib_iterative(int n, int *iterations);
 void show_comparison(int n, double est_pure_time, DPStats memo_stats,
                      DPStats iter_stats);
 void show_memo_table(const unsigned long long *memo, int n);
+void bench_pure_kernel(void *ctx);
+void bench_memo_kernel(void *ctx);
+void bench_iterative_kernel(void *ctx);
 
 int main(void) {
   int option = 0;
@@ -85,6 +104,9 @@ int main(void) {
     case 2:
       run_algorithm_info();
       break;
+    case 3:
+      run_harness_benchmark();
+      break;
     }
   }
 
@@ -95,7 +117,8 @@ void show_menu(void) {
   printf("=== Fibonacci Dynamic Programming ===\n\n");
   printf("1. Run Performance Benchmark\n");
   printf("2. Algorithm Information\n");
-  printf("3. Exit\n");
+  printf("3. Run Benchmark Harness (CSV/JSON)\n");
+  printf("4. Exit\n");
   printf("Option: ");
 }
 
@@ -146,40 +169,37 @@ void run_benchmark(void) {
     printf("  - Result: SKIPPED (Cutoff: n > %d)\n", RECURSION_LIMIT);
     printf("  - Est. Time: ~%.2f seconds\n", est_pure_time);
   } else {
-    clock_t start = clock();
+    double start = bench_now();
     unsigned long long res = fib_pure(n);
-    clock_t end = clock();
-    est_pure_time = ((double)(end - start)) / CLOCKS_PER_SEC;
+    est_pure_time = bench_now() - start;
     printf("  - Result: %llu\n", res);
     printf("  - Time:   %.6f seconds\n", est_pure_time);
   }
 
   // 2. Memoization
   printf("\n[2] Top-Down (Memoization):\n");
-  clock_t m_start = clock();
+  double m_start = bench_now();
   memo_stats.result =
       fib_memo(n, memo, &memo_stats.calculated, &memo_stats.reused);
-  clock_t m_end = clock();
-  memo_stats.time_taken = ((double)(m_end - m_start)) / CLOCKS_PER_SEC;
+  memo_stats.time_taken = bench_now() - m_start;
   if (memo_stats.time_taken <= 0.0)
-    memo_stats.time_taken = 0.000001;
+    memo_stats.time_taken = 0.000000001;
 
   printf("  - Result: %llu\n", memo_stats.result);
-  printf("  - Time:   %.6f seconds\n", memo_stats.time_taken);
+  printf("  - Time:   %.9f seconds\n", memo_stats.time_taken);
   printf("  - Stats:  Calculated: %d, Reused: %d\n", memo_stats.calculated,
          memo_stats.reused);
 
   // 3. Iterative
   printf("\n[3] Bottom-Up (Iterative):\n");
-  clock_t i_start = clock();
+  double i_start = bench_now();
   iter_stats.result = fib_iterative(n, &iter_stats.iterations);
-  clock_t i_end = clock();
-  iter_stats.time_taken = ((double)(i_end - i_start)) / CLOCKS_PER_SEC;
+  iter_stats.time_taken = bench_now() - i_start;
   if (iter_stats.time_taken <= 0.0)
-    iter_stats.time_taken = 0.000001;
+    iter_stats.time_taken = 0.000000001;
 
   printf("  - Result: %llu\n", iter_stats.result);
-  printf("  - Time:   %.6f seconds\n", iter_stats.time_taken);
+  printf("  - Time:   %.9f seconds\n", iter_stats.time_taken);
   printf("  - Stats:  Iterations: %d\n", iter_stats.iterations);
 
   show_comparison(n, est_pure_time, memo_stats, iter_stats);
@@ -189,6 +209,53 @@ void run_benchmark(void) {
   printf("\n");
 }
 
+void run_harness_benchmark(void) {
+  BenchRegistry reg;
+  FibBench bench = {0, NULL, 0, 0};
+
+  printf("\nEnter Fibonacci term to benchmark (e.g., 30, 90): ");
+  if (read_integer(&bench.n) != SUCCESS || bench.n < 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  bench.memo =
+      (unsigned long long *)calloc(bench.n + 1, sizeof(unsigned long long));
+  if (bench.memo == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  bench_init(&reg, "fibonacci");
+  // Every trial repeats the call, so pure recursion gets a tighter cutoff
+  if (bench.n <= HARNESS_RECURSION_LIMIT) {
+    bench_register(&reg, "fib_pure", NULL, bench_pure_kernel, &bench);
+  } else {
+    printf("\n  - fib_pure skipped (Cutoff: n > %d)\n",
+           HARNESS_RECURSION_LIMIT);
+  }
+  bench_register(&reg, "fib_memo", NULL, bench_memo_kernel, &bench);
+  bench_register(&reg, "fib_iterative", NULL, bench_iterative_kernel, &bench);
+
+  printf("\n=== Harness: n = %d, %d warmup, %d trials ===\n", bench.n,
+         reg.config.warmup, reg.config.trials);
+  if (!bench_run_all(&reg)) {
+    free(bench.memo);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  bench_print_table(&reg);
+  if (bench_export_csv(&reg, FILES_DIR "/bench_fibonacci.csv") &&
+      bench_export_json(&reg, FILES_DIR "/bench_fibonacci.json")) {
+    printf("\n  - Results: %s/bench_fibonacci.{csv,json}\n\n", FILES_DIR);
+  } else {
+    printf("\n  - Error: could not write to %s/\n\n", FILES_DIR);
+  }
+
+  free(bench.memo);
+}
+
 void run_algorithm_info(void) {
   printf("\n=== Algorithm Information ===\n\n");
   printf("1. Pure Recursion:\n");
@@ -276,6 +343,24 @@ void show_comparison(int n, double est_pure_time, DPStats memo_stats,
          memo_stats.time_taken / iter_stats.time_taken);
 }
 
+void bench_pure_kernel(void *ctx) {
+  FibBench *bench = (FibBench *)ctx;
+  bench->sink += fib_pure(bench->n);
+}
+
+void bench_memo_kernel(void *ctx) {
+  FibBench *bench = (FibBench *)ctx;
+  // A warm table would turn every call into a single lookup
+  memset(bench->memo, 0, (bench->n + 1) * sizeof(unsigned long long));
+  bench->sink += fib_memo(bench->n, bench->memo, &bench->counter,
+                          &bench->counter);
+}
+
+void bench_iterative_kernel(void *ctx) {
+  FibBench *bench = (FibBench *)ctx;
+  bench->sink += fib_iterative(bench->n, &bench->counter);
+}
+
 void show_memo_table(const unsigned long long *memo, int n) {
   printf("\nMemoization Table Preview (1st 10):\n  ");
   int limit = (n < 9) ? n + 1 : 10;
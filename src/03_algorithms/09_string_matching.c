@@ -1,27 +1,68 @@
 /*
  ===============================================================================
  Exercise: 09_string_matching.c
- Description: String Matching Algorithms (Brute Force vs KMP)
+ Description: String Matching Algorithms (Brute Force, KMP, Aho-Corasick)
  Platform: GNU/Linux (Arch/WSL) on x86_64
  ===============================================================================
  Features:
  - Brute Force substring search O(n*m)
  - KMP (Knuth-Morris-Pratt) optimal search O(n+m)
  - LPS (Longest Proper Prefix which is also Suffix) array construction
+ - Aho-Corasick multi-pattern automaton reporting all matches in one pass:
+   byte classes, dense DFA rows for the hot (shallow, BFS-first) states,
+   CSR sparse edges + failure links for the rest
+ - Throughput benchmark (MB/s) as the pattern count grows
+ - Single-pattern engine reporting all occurrences over large buffers:
+   SSE2/AVX2 first/last-byte filter, Boyer-Moore-Horspool and Two-Way,
+   picked by pattern length and alphabet
+ - Streaming search over read() chunks (file, FIFO, command pipe or TCP
+   socket) in a fixed buffer: KMP / Aho-Corasick state carries across
+   chunk boundaries and matches are reported at absolute offsets
  - Comparison counting and execution time tracking
+ - Hardware counters per search: cycles, IPC, cache and branch misses
+   (perf_event_open, perf_counters.h)
  - Interactive menu for repeated searches
+ - Benchmark harness mode with repeated trials and CSV/JSON export
  ===============================================================================
 */
 
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <time.h>
+#include <unistd.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "bench_harness.h"
+#include "perf_counters.h"
 
 #define MAX_TEXT 1000
 #define MAX_PATTERN 100
+#define BENCH_PATTERN 32
 #define MIN_OPTION 1
-#define MAX_OPTION 4
+#define MAX_OPTION 9
+#define AC_DENSE_STATES 2048
+#define AC_DEMO_PATTERNS 32
+#define AC_MAX_PATTERNS 10000
+#define AC_MIN_PATTERN_LEN 4
+#define AC_MAX_PATTERN_LEN 12
+#define AC_DEMO_MATCHES 20
+#define MB (1024 * 1024)
+#define SS_SMALL_ALPHABET 2   // Distinct pattern bytes at or below: Two-Way
+#define SS_TWO_WAY_MIN_LEN 4  // Shorter: the filter verify is cheap anyway
+#define SS_HORSPOOL_MIN_LEN 8 // Without SIMD, long patterns skip instead
+#define STREAM_CHUNK (64 * 1024)
+#define MAX_SOURCE 256
+#define FILES_DIR "files"
 #define TRUE 1
 #define FALSE 0
 
@@ -29,7 +70,8 @@ typedef enum {
   SUCCESS,
   ERR_INVALID_INPUT,
   ERR_INVALID_OPTION,
-  ERR_MEMORY_ALLOCATION
+  ERR_MEMORY_ALLOCATION,
+  ERR_FILE_IO
 } Status;
 
 typedef struct {
@@ -38,11 +80,99 @@ typedef struct {
   double time_taken;
 } MatchStats;
 
+typedef struct {
+  char *text;
+  int text_len;
+  char pattern[BENCH_PATTERN + 1];
+  int pattern_len;
+  int lps[BENCH_PATTERN];
+  int comparisons;
+  long sink;
+} MatchBench;
+
+typedef struct {
+  int states;
+  int classes;
+  int dense_states; // States [0, dense_states) have a full DFA row
+  int patterns;
+  unsigned short byte_class[256]; // 0 = byte used by no pattern
+  int *dense;                     // dense_states x classes
+  int *fail;
+  int *edge_start; // CSR: edges of s are [edge_start[s], edge_start[s+1])
+  unsigned short *edge_class;
+  int *edge_target;
+  int *output; // Pattern ending exactly at this state, or -1
+  int *report; // First state on the fail chain with an output, or -1
+  int *dict_link;
+  int *pattern_len;
+} AhoCorasick;
+
+typedef struct {
+  int *first_child;
+  int *next_sibling;
+  unsigned short *edge_class; // Class of the edge into this node
+  int *output;
+  int *order;  // BFS order: order[new id] = trie node
+  int *new_id; // Inverse of order
+  int count;
+} AcTrie;
+
+typedef void (*AcMatchFn)(int pattern, long start, void *ctx);
+
+typedef struct {
+  const char *text;
+  char **patterns;
+  int shown;
+} AcDemo;
+
+typedef enum { SS_AUTO, SS_SIMD, SS_HORSPOOL, SS_TWO_WAY } SsEngine;
+
+typedef struct {
+  const unsigned char *pattern;
+  long len;
+  SsEngine engine;
+  int avx2;
+  long shift[256]; // Horspool bad-character shift
+  long critical;   // Two-Way: last index of the left half (ell)
+  long period;
+  int periodic;
+} SubstringSearch;
+
+typedef void (*SsMatchFn)(long start, void *ctx);
+
+// Matchers keep their state between chunks; offsets are absolute
+typedef struct {
+  const char *pattern;
+  int len;
+  int *lps;
+  int matched; // Pattern bytes matched at the end of the last chunk
+  long offset; // Absolute offset of the next byte to be fed
+} KmpStream;
+
+typedef struct {
+  const AhoCorasick *ac;
+  int state;
+  long offset;
+} AcStream;
+
+typedef long (*StreamFeedFn)(void *stream, const char *chunk, long n,
+                             AcMatchFn on_match, void *ctx);
+
+typedef struct {
+  int fd;
+  FILE *pipe; // Set for "cmd:" sources, closed with pclose()
+} StreamSource;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_demo_search(void);
 void run_custom_search(void);
 void run_algorithm_info(void);
+void run_harness_benchmark(void);
+void run_multi_pattern_search(void);
+void run_aho_corasick_benchmark(void);
+void run_substring_benchmark(void);
+void run_stream_search(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
@@ -50,9 +180,64 @@ Status read_string(char *buffer, int max_len);
 
 void run_brute_force(const char *text, const char *pattern, MatchStats *stats);
 void run_kmp(const char *text, const char *pattern, MatchStats *stats);
+int brute_force_search(const char *text, int N, const char *pattern, int M,
+                       int *comparisons);
+int kmp_search(const char *text, int N, const char *pattern, int M,
+               const int *lps, int *comparisons);
 void compute_lps_array(const char *pattern, int M, int *lps);
 void print_lps_array(int *lps, int M);
 void show_comparison(MatchStats bf_stats, MatchStats kmp_stats);
+void print_perf_counters(const PerfCounters *pc);
+void bench_brute_force_kernel(void *ctx);
+void bench_kmp_kernel(void *ctx);
+
+Status ac_build(AhoCorasick *ac, char **patterns, int count);
+void ac_build_trie(AhoCorasick *ac, AcTrie *trie, char **patterns,
+                   int count);
+Status ac_alloc_tables(AhoCorasick *ac, int states);
+void ac_link(AhoCorasick *ac, const AcTrie *trie);
+int ac_trie_child(const AcTrie *trie, int node, int c);
+int ac_next(const AhoCorasick *ac, int state, int c);
+long ac_search(const AhoCorasick *ac, const char *text, long len,
+               AcMatchFn on_match, void *ctx);
+void ac_free(AhoCorasick *ac);
+void print_ac_match(int pattern, long start, void *ctx);
+void fill_random_text(char *text, long len);
+void fill_bench_text(char *text, long len, int kind);
+
+void ss_prepare(SubstringSearch *ss, const char *pattern, long len,
+                SsEngine engine);
+SsEngine ss_choose_engine(const unsigned char *pattern, long len);
+long ss_search(const SubstringSearch *ss, const char *text, long n,
+               SsMatchFn on_match, void *ctx);
+long ss_search_horspool(const SubstringSearch *ss, const unsigned char *s,
+                        long n, SsMatchFn on_match, void *ctx);
+long ss_search_two_way(const SubstringSearch *ss, const unsigned char *s,
+                       long n, SsMatchFn on_match, void *ctx);
+long ss_max_suffix(const unsigned char *x, long m, long *period,
+                   int reversed);
+long ss_search_simd(const SubstringSearch *ss, const unsigned char *s,
+                    long n, SsMatchFn on_match, void *ctx);
+#ifdef __x86_64__
+long ss_search_avx2(const SubstringSearch *ss, const unsigned char *s,
+                    long n, SsMatchFn on_match, void *ctx);
+#endif
+const char *ss_engine_name(const SubstringSearch *ss);
+void print_ss_match(long start, void *ctx);
+void run_all_occurrences(const char *text, const char *pattern);
+int cpu_has_avx2(void);
+
+Status kmp_stream_init(KmpStream *ks, const char *pattern);
+long kmp_stream_feed(void *stream, const char *chunk, long n,
+                     AcMatchFn on_match, void *ctx);
+void kmp_stream_free(KmpStream *ks);
+long ac_stream_feed(void *stream, const char *chunk, long n,
+                    AcMatchFn on_match, void *ctx);
+Status stream_open(StreamSource *src, const char *spec);
+int stream_connect(const char *address);
+void stream_close(StreamSource *src);
+long stream_search_fd(int fd, StreamFeedFn feed, void *stream,
+                      AcMatchFn on_match, void *ctx, long *matches);
 
 int main(void) {
   int option = 0;
@@ -85,6 +270,21 @@ int main(void) {
     case 3:
       run_algorithm_info();
       break;
+    case 4:
+      run_multi_pattern_search();
+      break;
+    case 5:
+      run_aho_corasick_benchmark();
+      break;
+    case 6:
+      run_substring_benchmark();
+      break;
+    case 7:
+      run_stream_search();
+      break;
+    case 8:
+      run_harness_benchmark();
+      break;
     }
   }
 
@@ -96,7 +296,12 @@ void show_menu(void) {
   printf("1. Run Demo (Brute Force vs KMP)\n");
   printf("2. Run Custom Search\n");
   printf("3. Algorithm Information\n");
-  printf("4. Exit\n");
+  printf("4. Multi-Pattern Search (Aho-Corasick)\n");
+  printf("5. Aho-Corasick Throughput Benchmark\n");
+  printf("6. Substring Engine Benchmark (SIMD/Horspool/Two-Way)\n");
+  printf("7. Streaming Search (file, FIFO, command or TCP socket)\n");
+  printf("8. Run Benchmark Harness (CSV/JSON)\n");
+  printf("9. Exit\n");
   printf("Option: ");
 }
 
@@ -111,6 +316,9 @@ void handle_error(Status status) {
   case ERR_MEMORY_ALLOCATION:
     printf("Error: Memory allocation failed.\n\n");
     break;
+  case ERR_FILE_IO:
+    printf("Error: Could not open or read the source.\n\n");
+    break;
   case SUCCESS:
     break;
   }
@@ -158,10 +366,382 @@ void run_custom_search(void) {
 
   run_brute_force(text, pattern, &bf_stats);
   run_kmp(text, pattern, &kmp_stats);
+  run_all_occurrences(text, pattern);
 
   show_comparison(bf_stats, kmp_stats);
 }
 
+void run_all_occurrences(const char *text, const char *pattern) {
+  SubstringSearch ss;
+  int shown = 0;
+
+  printf("\n[3] All Occurrences (substring engine):\n");
+  ss_prepare(&ss, pattern, (long)strlen(pattern), SS_AUTO);
+  printf("  - Engine:      %s\n", ss_engine_name(&ss));
+
+  double start = bench_now();
+  long matches = ss_search(&ss, text, (long)strlen(text), print_ss_match,
+                           &shown);
+  double elapsed = bench_now() - start;
+
+  if (matches > AC_DEMO_MATCHES) {
+    printf("    ... (%ld more)\n", matches - AC_DEMO_MATCHES);
+  }
+  printf("  - Matches:     %ld\n", matches);
+  printf("  - Time:        %.9f seconds\n", elapsed);
+}
+
+void run_harness_benchmark(void) {
+  BenchRegistry reg;
+  MatchBench bench;
+
+  printf("\nEnter text size in bytes (e.g., 100000, 10000000): ");
+  if (read_integer(&bench.text_len) != SUCCESS ||
+      bench.text_len <= BENCH_PATTERN) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  bench.text = (char *)malloc(bench.text_len + 1);
+  if (bench.text == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  // Worst case for brute force: "AAA...AB" against a run of 'A' that only
+  // matches at the very end, so every alignment compares M characters
+  memset(bench.text, 'A', bench.text_len);
+  bench.text[bench.text_len - 1] = 'B';
+  bench.text[bench.text_len] = '\0';
+  bench.pattern_len = BENCH_PATTERN;
+  memset(bench.pattern, 'A', BENCH_PATTERN - 1);
+  bench.pattern[BENCH_PATTERN - 1] = 'B';
+  bench.pattern[BENCH_PATTERN] = '\0';
+  compute_lps_array(bench.pattern, bench.pattern_len, bench.lps);
+  bench.comparisons = 0;
+  bench.sink = 0;
+
+  bench_init(&reg, "string_matching");
+  bench_register(&reg, "brute_force", NULL, bench_brute_force_kernel, &bench);
+  bench_register(&reg, "kmp", NULL, bench_kmp_kernel, &bench);
+
+  printf("\n=== Harness: %d bytes, pattern %d, %d warmup, %d trials ===\n",
+         bench.text_len, bench.pattern_len, reg.config.warmup,
+         reg.config.trials);
+  if (!bench_run_all(&reg)) {
+    free(bench.text);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  bench_print_table(&reg);
+  if (bench_export_csv(&reg, FILES_DIR "/bench_string_matching.csv") &&
+      bench_export_json(&reg, FILES_DIR "/bench_string_matching.json")) {
+    printf("\n  - Results: %s/bench_string_matching.{csv,json}\n\n",
+           FILES_DIR);
+  } else {
+    printf("\n  - Error: could not write to %s/\n\n", FILES_DIR);
+  }
+
+  free(bench.text);
+}
+
+void run_multi_pattern_search(void) {
+  char text[MAX_TEXT];
+  char line[MAX_TEXT];
+  char *patterns[AC_DEMO_PATTERNS];
+  int count = 0;
+  AhoCorasick ac;
+
+  printf("\nEnter text to search in:\n  > ");
+  if (read_string(text, MAX_TEXT) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter patterns separated by spaces (max %d):\n  > ",
+         AC_DEMO_PATTERNS);
+  if (read_string(line, MAX_TEXT) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  char *token = strtok(line, " ");
+  while (token != NULL && count < AC_DEMO_PATTERNS) {
+    patterns[count++] = token;
+    token = strtok(NULL, " ");
+  }
+  if (count == 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  if (ac_build(&ac, patterns, count) != SUCCESS) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  AcDemo demo = {text, patterns, 0};
+  printf("\n=== Aho-Corasick ===\n");
+  printf("  - Patterns: %d, States: %d, Byte classes: %d\n", count,
+         ac.states, ac.classes);
+
+  double start = bench_now();
+  long matches = ac_search(&ac, text, (long)strlen(text), print_ac_match,
+                           &demo);
+  double elapsed = bench_now() - start;
+
+  if (matches > AC_DEMO_MATCHES) {
+    printf("    ... (%ld more)\n", matches - AC_DEMO_MATCHES);
+  }
+  printf("  - Total matches: %ld (single pass)\n", matches);
+  printf("  - Time:          %.9f seconds\n\n", elapsed);
+
+  ac_free(&ac);
+}
+
+void run_aho_corasick_benchmark(void) {
+  static const int counts[] = {1, 10, 100, 1000, AC_MAX_PATTERNS};
+  int text_mb = 0;
+  char *text = NULL;
+  char *pool = NULL;
+  char **patterns = NULL;
+
+  printf("\nEnter text size in MB (e.g., 16, 256): ");
+  if (read_integer(&text_mb) != SUCCESS || text_mb <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  long len = (long)text_mb * MB;
+  text = (char *)malloc(len);
+  pool = (char *)malloc(AC_MAX_PATTERNS * (AC_MAX_PATTERN_LEN + 1));
+  patterns = (char **)malloc(AC_MAX_PATTERNS * sizeof(char *));
+  if (text == NULL || pool == NULL || patterns == NULL) {
+    free(text);
+    free(pool);
+    free(patterns);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  // Patterns are cut from the text itself, so every one of them matches
+  fill_random_text(text, len);
+  for (int i = 0; i < AC_MAX_PATTERNS; i++) {
+    int plen = AC_MIN_PATTERN_LEN +
+               rand() % (AC_MAX_PATTERN_LEN - AC_MIN_PATTERN_LEN + 1);
+    long pos = ((long)rand() * RAND_MAX + rand()) % (len - plen);
+    patterns[i] = pool + i * (AC_MAX_PATTERN_LEN + 1);
+    memcpy(patterns[i], text + pos, plen);
+    patterns[i][plen] = '\0';
+  }
+
+  printf("\n=== Aho-Corasick Throughput: %d MB random words ===\n\n",
+         text_mb);
+  printf("%-8s | %-8s | %-6s | %-10s | %-9s | %s\n", "Patterns", "States",
+         "Dense", "Build (ms)", "MB/s", "Matches");
+  printf("---------|----------|--------|------------|-----------|---------\n");
+
+  for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+    AhoCorasick ac;
+
+    double start = bench_now();
+    if (ac_build(&ac, patterns, counts[i]) != SUCCESS) {
+      handle_error(ERR_MEMORY_ALLOCATION);
+      break;
+    }
+    double build = bench_now() - start;
+
+    start = bench_now();
+    long matches = ac_search(&ac, text, len, NULL, NULL);
+    double elapsed = bench_now() - start;
+    if (elapsed <= 0.0) {
+      elapsed = 0.000000001;
+    }
+
+    printf("%-8d | %-8d | %-6d | %10.2f | %9.1f | %ld\n", counts[i],
+           ac.states, ac.dense_states, build * 1000.0,
+           (double)len / MB / elapsed, matches);
+    fflush(stdout);
+    ac_free(&ac);
+  }
+
+  printf("\n  - One pass over the text regardless of the pattern count\n");
+  printf("  - Dense rows cover the first %d BFS states\n\n",
+         AC_DENSE_STATES);
+
+  free(text);
+  free(pool);
+  free(patterns);
+}
+
+void run_substring_benchmark(void) {
+  static const long lengths[] = {1, 4, 8, 16, 32, 64, 256};
+  static const char *kinds[] = {"words", "dna", "repeat"};
+  static const SsEngine engines[] = {SS_SIMD, SS_HORSPOOL, SS_TWO_WAY};
+  const int num_engines = (int)(sizeof(engines) / sizeof(engines[0]));
+  int text_mb = 0;
+
+  printf("\nEnter text size in MB (e.g., 256, 1024): ");
+  if (read_integer(&text_mb) != SUCCESS || text_mb <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  long len = (long)text_mb * MB;
+  char *text = (char *)malloc(len);
+  char pattern[256 + 1];
+  if (text == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  printf("\n=== Substring Engines: %d MB, all occurrences (MB/s) ===\n",
+         text_mb);
+  printf("  - SIMD filter: %s\n\n", cpu_has_avx2() ? "AVX2" : "SSE2");
+  printf("%-6s | %-4s | %-9s | %9s | %9s | %9s | %s\n", "Text", "Len",
+         "Auto", "SIMD", "Horspool", "Two-Way", "Matches");
+  printf("-------|------|-----------|-----------|-----------|-----------|"
+         "---------\n");
+
+  for (int k = 0; k < (int)(sizeof(kinds) / sizeof(kinds[0])); k++) {
+    fill_bench_text(text, len, k);
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+      long m = lengths[i];
+      SubstringSearch ss;
+      double mbps[3];
+      long matches[3];
+
+      // Cut from the text so there is at least one match; on the repeat
+      // text "a...ab" + "a" is the worst case of the first/last filter
+      if (k == 2) {
+        memset(pattern, 'a', m);
+        if (m > 1) {
+          pattern[m - 2] = 'b';
+        }
+      } else {
+        long pos = ((long)rand() * RAND_MAX + rand()) % (len - m);
+        memcpy(pattern, text + pos, m);
+      }
+      pattern[m] = '\0';
+
+      for (int e = 0; e < num_engines; e++) {
+        ss_prepare(&ss, pattern, m, engines[e]);
+        double start = bench_now();
+        matches[e] = ss_search(&ss, text, len, NULL, NULL);
+        double elapsed = bench_now() - start;
+        if (elapsed <= 0.0) {
+          elapsed = 0.000000001;
+        }
+        mbps[e] = (double)len / MB / elapsed;
+      }
+
+      ss_prepare(&ss, pattern, m, SS_AUTO);
+      printf("%-6s | %-4ld | %-9s | %9.1f | %9.1f | %9.1f | %ld%s\n",
+             kinds[k], m, ss_engine_name(&ss), mbps[0], mbps[1], mbps[2],
+             matches[0],
+             (matches[1] != matches[0] || matches[2] != matches[0])
+                 ? " MISMATCH"
+                 : "");
+      fflush(stdout);
+    }
+  }
+
+  printf("\n  - Auto: Two-Way for patterns of %d+ bytes over at most %d "
+         "distinct\n    bytes, SIMD filter otherwise (Horspool from %d bytes "
+         "without SIMD)\n\n",
+         SS_TWO_WAY_MIN_LEN, SS_SMALL_ALPHABET, SS_HORSPOOL_MIN_LEN);
+  free(text);
+}
+
+void run_stream_search(void) {
+  char spec[MAX_SOURCE];
+  char line[MAX_TEXT];
+  char *patterns[AC_DEMO_PATTERNS];
+  int count = 0;
+  StreamSource src;
+  KmpStream kmp;
+  AhoCorasick ac;
+  AcStream acs;
+
+  printf("\nSource: file or FIFO path, cmd:COMMAND or tcp:HOST:PORT\n  > ");
+  if (read_string(spec, MAX_SOURCE) != SUCCESS || spec[0] == '\0') {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter patterns separated by spaces (1 = KMP, more = "
+         "Aho-Corasick):\n  > ");
+  if (read_string(line, MAX_TEXT) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  char *token = strtok(line, " ");
+  while (token != NULL && count < AC_DEMO_PATTERNS) {
+    patterns[count++] = token;
+    token = strtok(NULL, " ");
+  }
+  if (count == 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  Status status = (count == 1) ? kmp_stream_init(&kmp, patterns[0])
+                               : ac_build(&ac, patterns, count);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  StreamFeedFn feed = (count == 1) ? kmp_stream_feed : ac_stream_feed;
+  void *stream = &kmp;
+  if (count > 1) {
+    acs.ac = &ac;
+    acs.state = 0;
+    acs.offset = 0;
+    stream = &acs;
+  }
+
+  status = stream_open(&src, spec);
+  if (status == SUCCESS) {
+    AcDemo demo = {NULL, patterns, 0};
+    long matches = 0;
+
+    printf("\n=== Streaming %s: %d KB chunks ===\n",
+           (count == 1) ? "KMP" : "Aho-Corasick", STREAM_CHUNK / 1024);
+    double start = bench_now();
+    long bytes =
+        stream_search_fd(src.fd, feed, stream, print_ac_match, &demo, &matches);
+    double elapsed = bench_now() - start;
+    if (elapsed <= 0.0) {
+      elapsed = 0.000000001;
+    }
+
+    if (matches > AC_DEMO_MATCHES) {
+      printf("    ... (%ld more)\n", matches - AC_DEMO_MATCHES);
+    }
+    if (bytes < 0) {
+      printf("  - Read error: %s\n", strerror(errno));
+    }
+    printf("  - Bytes read:    %ld\n", (bytes < 0) ? 0 : bytes);
+    printf("  - Total matches: %ld\n", matches);
+    printf("  - Throughput:    %.1f MB/s\n\n",
+           (bytes < 0 ? 0.0 : (double)bytes) / MB / elapsed);
+    stream_close(&src);
+  } else {
+    printf("\n  - %s: %s\n", spec, strerror(errno));
+    handle_error(status);
+  }
+
+  if (count == 1) {
+    kmp_stream_free(&kmp);
+  } else {
+    ac_free(&ac);
+  }
+}
+
 void run_algorithm_info(void) {
   printf("\n=== Algorithm Information ===\n\n");
   printf("1. Brute Force O(n*m):\n");
@@ -171,6 +751,24 @@ void run_algorithm_info(void) {
   printf("   - Precomputes LPS (Longest Prefix Suffix) table.\n");
   printf("   - Avoids redundant comparisons using earlier match info.\n");
   printf("   - Optimal for long texts with repetitive patterns.\n\n");
+  printf("3. Aho-Corasick O(n + m + matches):\n");
+  printf("   - Trie of all patterns + failure links = one automaton.\n");
+  printf("   - Finds every occurrence of every pattern in one pass.\n");
+  printf("   - Shallow states get full transition rows (cache-hot);\n");
+  printf("     deep states keep only their real edges.\n\n");
+  printf("4. Substring engine (all occurrences):\n");
+  printf("   - SIMD: compare first and last pattern byte at 16/32\n");
+  printf("     positions at once, verify only the candidates.\n");
+  printf("   - Horspool: skips up to m bytes on a mismatch (long "
+         "patterns).\n");
+  printf("   - Two-Way: O(n) worst case, O(1) memory (repetitive "
+         "patterns).\n\n");
+  printf("5. Streaming search:\n");
+  printf("   - KMP and Aho-Corasick only ever move forward, so their\n");
+  printf("     state (matched length / automaton state) is all that\n");
+  printf("     has to survive between read() chunks.\n");
+  printf("   - Memory stays at one %d KB buffer for any input size.\n\n",
+         STREAM_CHUNK / 1024);
 }
 
 void clear_input_buffer(void) {
@@ -205,27 +803,18 @@ void run_brute_force(const char *text, const char *pattern, MatchStats *stats) {
 
   int N = strlen(text);
   int M = strlen(pattern);
+  PerfCounters counters;
 
-  clock_t start = clock();
-
-  for (int i = 0; i <= N - M; i++) {
-    int j;
-    for (j = 0; j < M; j++) {
-      stats->comparisons++;
-      if (text[i + j] != pattern[j]) {
-        break;
-      }
-    }
-    if (j == M) {
-      stats->found_index = i;
-      break;
-    }
-  }
-
-  clock_t end = clock();
-  stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
+  perf_open(&counters);
+  perf_start(&counters);
+  double start = bench_now();
+  stats->found_index =
+      brute_force_search(text, N, pattern, M, &stats->comparisons);
+  stats->time_taken = bench_now() - start;
+  perf_stop(&counters);
+  perf_close(&counters);
   if (stats->time_taken <= 0.0)
-    stats->time_taken = 0.000001;
+    stats->time_taken = 0.000000001;
 
   if (stats->found_index != -1) {
     printf("  - Found at index: %d\n", stats->found_index);
@@ -233,8 +822,9 @@ void run_brute_force(const char *text, const char *pattern, MatchStats *stats) {
     printf("  - Status: Not Found\n");
   }
   printf("  - Comparisons: %d\n", stats->comparisons);
-  printf("  - Time:        %.6f seconds\n", stats->time_taken);
+  printf("  - Time:        %.9f seconds\n", stats->time_taken);
   printf("  - Complexity:  O(n*m)\n");
+  print_perf_counters(&counters);
 }
 
 void run_kmp(const char *text, const char *pattern, MatchStats *stats) {
@@ -252,21 +842,62 @@ void run_kmp(const char *text, const char *pattern, MatchStats *stats) {
   compute_lps_array(pattern, M, lps);
   print_lps_array(lps, M);
 
-  clock_t start = clock();
+  PerfCounters counters;
+  perf_open(&counters);
+  perf_start(&counters);
+  double start = bench_now();
+  stats->found_index =
+      kmp_search(text, N, pattern, M, lps, &stats->comparisons);
+  stats->time_taken = bench_now() - start;
+  perf_stop(&counters);
+  perf_close(&counters);
+  if (stats->time_taken <= 0.0)
+    stats->time_taken = 0.000000001;
+
+  free(lps);
 
+  if (stats->found_index != -1) {
+    printf("  - Found at index: %d\n", stats->found_index);
+  } else {
+    printf("  - Status: Not Found\n");
+  }
+  printf("  - Comparisons: %d\n", stats->comparisons);
+  printf("  - Time:        %.9f seconds\n", stats->time_taken);
+  printf("  - Complexity:  O(n+m)\n");
+  print_perf_counters(&counters);
+}
+
+int brute_force_search(const char *text, int N, const char *pattern, int M,
+                       int *comparisons) {
+  for (int i = 0; i <= N - M; i++) {
+    int j;
+    for (j = 0; j < M; j++) {
+      (*comparisons)++;
+      if (text[i + j] != pattern[j]) {
+        break;
+      }
+    }
+    if (j == M) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int kmp_search(const char *text, int N, const char *pattern, int M,
+               const int *lps, int *comparisons) {
   int i = 0;
   int j = 0;
 
   while (i < N) {
-    stats->comparisons++;
+    (*comparisons)++;
     if (pattern[j] == text[i]) {
       j++;
       i++;
     }
 
     if (j == M) {
-      stats->found_index = i - j;
-      break;
+      return i - j;
     } else if (i < N && pattern[j] != text[i]) {
       if (j != 0) {
         j = lps[j - 1];
@@ -275,22 +906,7 @@ void run_kmp(const char *text, const char *pattern, MatchStats *stats) {
       }
     }
   }
-
-  clock_t end = clock();
-  stats->time_taken = ((double)(end - start)) / CLOCKS_PER_SEC;
-  if (stats->time_taken <= 0.0)
-    stats->time_taken = 0.000001;
-
-  free(lps);
-
-  if (stats->found_index != -1) {
-    printf("  - Found at index: %d\n", stats->found_index);
-  } else {
-    printf("  - Status: Not Found\n");
-  }
-  printf("  - Comparisons: %d\n", stats->comparisons);
-  printf("  - Time:        %.6f seconds\n", stats->time_taken);
-  printf("  - Complexity:  O(n+m)\n");
+  return -1;
 }
 
 void compute_lps_array(const char *pattern, int M, int *lps) {
@@ -322,6 +938,739 @@ void print_lps_array(int *lps, int M) {
   printf("]\n");
 }
 
+void bench_brute_force_kernel(void *ctx) {
+  MatchBench *bench = (MatchBench *)ctx;
+  bench->comparisons = 0;
+  bench->sink += brute_force_search(bench->text, bench->text_len,
+                                    bench->pattern, bench->pattern_len,
+                                    &bench->comparisons);
+}
+
+void bench_kmp_kernel(void *ctx) {
+  MatchBench *bench = (MatchBench *)ctx;
+  bench->comparisons = 0;
+  bench->sink += kmp_search(bench->text, bench->text_len, bench->pattern,
+                            bench->pattern_len, bench->lps,
+                            &bench->comparisons);
+}
+
+Status ac_build(AhoCorasick *ac, char **patterns, int count) {
+  AcTrie trie;
+  int max_states = 1;
+
+  memset(ac, 0, sizeof(*ac));
+  for (int i = 0; i < count; i++) {
+    max_states += (int)strlen(patterns[i]);
+  }
+
+  // Byte classes: only bytes used by some pattern get their own column
+  for (int i = 0; i < count; i++) {
+    for (const unsigned char *p = (const unsigned char *)patterns[i]; *p;
+         p++) {
+      if (ac->byte_class[*p] == 0) {
+        ac->byte_class[*p] = (unsigned short)(++ac->classes);
+      }
+    }
+  }
+  ac->classes++;
+  ac->patterns = count;
+
+  trie.first_child = (int *)malloc(max_states * sizeof(int));
+  trie.next_sibling = (int *)malloc(max_states * sizeof(int));
+  trie.edge_class = (unsigned short *)malloc(max_states * sizeof(short));
+  trie.output = (int *)malloc(max_states * sizeof(int));
+  trie.order = (int *)malloc(max_states * sizeof(int));
+  trie.new_id = (int *)malloc(max_states * sizeof(int));
+  ac->pattern_len = (int *)malloc(count * sizeof(int));
+
+  Status status = SUCCESS;
+  if (trie.first_child == NULL || trie.next_sibling == NULL ||
+      trie.edge_class == NULL || trie.output == NULL || trie.order == NULL ||
+      trie.new_id == NULL || ac->pattern_len == NULL) {
+    status = ERR_MEMORY_ALLOCATION;
+  }
+
+  if (status == SUCCESS) {
+    ac_build_trie(ac, &trie, patterns, count);
+    status = ac_alloc_tables(ac, trie.count);
+  }
+  if (status == SUCCESS) {
+    ac_link(ac, &trie);
+  }
+
+  free(trie.first_child);
+  free(trie.next_sibling);
+  free(trie.edge_class);
+  free(trie.output);
+  free(trie.order);
+  free(trie.new_id);
+  if (status != SUCCESS) {
+    ac_free(ac);
+  }
+  return status;
+}
+
+void ac_build_trie(AhoCorasick *ac, AcTrie *trie, char **patterns,
+                   int count) {
+  // 1. Plain trie with first-child / next-sibling lists
+  trie->count = 1;
+  trie->first_child[0] = -1;
+  trie->next_sibling[0] = -1;
+  trie->output[0] = -1;
+  for (int i = 0; i < count; i++) {
+    int node = 0;
+    ac->pattern_len[i] = (int)strlen(patterns[i]);
+    if (ac->pattern_len[i] == 0) {
+      continue;
+    }
+
+    for (const unsigned char *p = (const unsigned char *)patterns[i]; *p;
+         p++) {
+      int c = ac->byte_class[*p];
+      int child = ac_trie_child(trie, node, c);
+      if (child < 0) {
+        child = trie->count++;
+        trie->first_child[child] = -1;
+        trie->output[child] = -1;
+        trie->edge_class[child] = (unsigned short)c;
+        trie->next_sibling[child] = trie->first_child[node];
+        trie->first_child[node] = child;
+      }
+      node = child;
+    }
+    // Duplicate patterns share a state: the first one is reported
+    if (trie->output[node] < 0) {
+      trie->output[node] = i;
+    }
+  }
+
+  // 2. Renumber in BFS order so shallow (hot) states come first
+  int head = 0;
+  int tail = 0;
+  trie->order[tail++] = 0;
+  while (head < tail) {
+    int node = trie->order[head];
+    trie->new_id[node] = head++;
+    for (int c = trie->first_child[node]; c >= 0;
+         c = trie->next_sibling[c]) {
+      trie->order[tail++] = c;
+    }
+  }
+}
+
+Status ac_alloc_tables(AhoCorasick *ac, int states) {
+  ac->states = states;
+  ac->dense_states = (states < AC_DENSE_STATES) ? states : AC_DENSE_STATES;
+  ac->dense = (int *)malloc((size_t)ac->dense_states * ac->classes *
+                            sizeof(int));
+  ac->fail = (int *)malloc(states * sizeof(int));
+  ac->edge_start = (int *)malloc((states + 1) * sizeof(int));
+  ac->edge_class = (unsigned short *)malloc(states * sizeof(short));
+  ac->edge_target = (int *)malloc(states * sizeof(int));
+  ac->output = (int *)malloc(states * sizeof(int));
+  ac->report = (int *)malloc(states * sizeof(int));
+  ac->dict_link = (int *)malloc(states * sizeof(int));
+
+  if (ac->dense == NULL || ac->fail == NULL || ac->edge_start == NULL ||
+      ac->edge_class == NULL || ac->edge_target == NULL ||
+      ac->output == NULL || ac->report == NULL || ac->dict_link == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  return SUCCESS;
+}
+
+void ac_link(AhoCorasick *ac, const AcTrie *trie) {
+  // 3. CSR edge arrays in the new numbering
+  int edges = 0;
+  for (int s = 0; s < ac->states; s++) {
+    int node = trie->order[s];
+    ac->edge_start[s] = edges;
+    ac->output[s] = trie->output[node];
+    for (int c = trie->first_child[node]; c >= 0;
+         c = trie->next_sibling[c]) {
+      ac->edge_class[edges] = trie->edge_class[c];
+      ac->edge_target[edges] = trie->new_id[c];
+      edges++;
+    }
+  }
+  ac->edge_start[ac->states] = edges;
+
+  // 4. Failure links, dense rows and output chains, in BFS order: every
+  //    fail target is shallower, so it is always complete when needed
+  ac->fail[0] = 0;
+  ac->dict_link[0] = -1;
+  for (int s = 0; s < ac->states; s++) {
+    if (s < ac->dense_states) {
+      int *row = ac->dense + (size_t)s * ac->classes;
+      const int *fail_row = ac->dense + (size_t)ac->fail[s] * ac->classes;
+      for (int c = 0; c < ac->classes; c++) {
+        row[c] = (s == 0) ? 0 : fail_row[c];
+      }
+      for (int e = ac->edge_start[s]; e < ac->edge_start[s + 1]; e++) {
+        row[ac->edge_class[e]] = ac->edge_target[e];
+      }
+    }
+
+    for (int e = ac->edge_start[s]; e < ac->edge_start[s + 1]; e++) {
+      int child = ac->edge_target[e];
+      int fail = (s == 0) ? 0 : ac_next(ac, ac->fail[s], ac->edge_class[e]);
+      ac->fail[child] = fail;
+      ac->dict_link[child] =
+          (ac->output[fail] >= 0) ? fail : ac->dict_link[fail];
+    }
+
+    ac->report[s] = (ac->output[s] >= 0) ? s : ac->dict_link[s];
+  }
+}
+
+int ac_trie_child(const AcTrie *trie, int node, int c) {
+  for (int child = trie->first_child[node]; child >= 0;
+       child = trie->next_sibling[child]) {
+    if (trie->edge_class[child] == c) {
+      return child;
+    }
+  }
+  return -1;
+}
+
+int ac_next(const AhoCorasick *ac, int state, int c) {
+  // Sparse states: own edges, else follow failure links to a dense state
+  while (state >= ac->dense_states) {
+    for (int e = ac->edge_start[state]; e < ac->edge_start[state + 1]; e++) {
+      if (ac->edge_class[e] == c) {
+        return ac->edge_target[e];
+      }
+    }
+    state = ac->fail[state];
+  }
+  return ac->dense[(size_t)state * ac->classes + c];
+}
+
+long ac_search(const AhoCorasick *ac, const char *text, long len,
+               AcMatchFn on_match, void *ctx) {
+  AcStream stream = {ac, 0, 0};
+  return ac_stream_feed(&stream, text, len, on_match, ctx);
+}
+
+long ac_stream_feed(void *stream, const char *chunk, long n,
+                    AcMatchFn on_match, void *ctx) {
+  AcStream *as = (AcStream *)stream;
+  const AhoCorasick *ac = as->ac;
+  const unsigned char *p = (const unsigned char *)chunk;
+  long matches = 0;
+  int state = as->state;
+
+  for (long i = 0; i < n; i++) {
+    int c = ac->byte_class[p[i]];
+    state = (state < ac->dense_states)
+                ? ac->dense[(size_t)state * ac->classes + c]
+                : ac_next(ac, state, c);
+
+    // Every pattern that ends here: this state plus its dictionary chain
+    for (int r = ac->report[state]; r >= 0; r = ac->dict_link[r]) {
+      matches++;
+      if (on_match != NULL) {
+        int pattern = ac->output[r];
+        on_match(pattern, as->offset + i - ac->pattern_len[pattern] + 1,
+                 ctx);
+      }
+    }
+  }
+
+  as->state = state;
+  as->offset += n;
+  return matches;
+}
+
+void ac_free(AhoCorasick *ac) {
+  free(ac->dense);
+  free(ac->fail);
+  free(ac->edge_start);
+  free(ac->edge_class);
+  free(ac->edge_target);
+  free(ac->output);
+  free(ac->report);
+  free(ac->dict_link);
+  free(ac->pattern_len);
+  memset(ac, 0, sizeof(*ac));
+}
+
+void print_ac_match(int pattern, long start, void *ctx) {
+  AcDemo *demo = (AcDemo *)ctx;
+  if (demo->shown++ < AC_DEMO_MATCHES) {
+    printf("    [%ld] \"%s\"\n", start, demo->patterns[pattern]);
+  }
+}
+
+void fill_random_text(char *text, long len) {
+  // Lowercase words of 2-9 letters separated by single spaces
+  long i = 0;
+  while (i < len) {
+    int word = 2 + rand() % 8;
+    for (int j = 0; j < word && i < len; j++) {
+      text[i++] = (char)('a' + rand() % 26);
+    }
+    if (i < len) {
+      text[i++] = ' ';
+    }
+  }
+}
+
+void fill_bench_text(char *text, long len, int kind) {
+  static const char dna[] = "ACGT";
+
+  if (kind == 0) {
+    fill_random_text(text, len);
+  } else if (kind == 1) {
+    for (long i = 0; i < len; i++) {
+      text[i] = dna[rand() % 4];
+    }
+  } else {
+    memset(text, 'a', len);
+  }
+}
+
+void ss_prepare(SubstringSearch *ss, const char *pattern, long len,
+                SsEngine engine) {
+  const unsigned char *x = (const unsigned char *)pattern;
+
+  memset(ss, 0, sizeof(*ss));
+  ss->pattern = x;
+  ss->len = len;
+  ss->avx2 = cpu_has_avx2();
+  ss->engine = (engine == SS_AUTO) ? ss_choose_engine(x, len) : engine;
+  if (len == 0) {
+    return;
+  }
+
+  // Horspool: distance from the last occurrence of each byte to the end
+  for (int c = 0; c < 256; c++) {
+    ss->shift[c] = len;
+  }
+  for (long i = 0; i < len - 1; i++) {
+    ss->shift[x[i]] = len - 1 - i;
+  }
+
+  // Two-Way: critical factorization from the two maximal suffixes
+  long p, q;
+  long i = ss_max_suffix(x, len, &p, FALSE);
+  long j = ss_max_suffix(x, len, &q, TRUE);
+  ss->critical = (i > j) ? i : j;
+  ss->period = (i > j) ? p : q;
+  ss->periodic = ss->critical + 1 + ss->period <= len &&
+                 memcmp(x, x + ss->period, ss->critical + 1) == 0;
+  if (!ss->periodic) {
+    long left = ss->critical + 1;
+    long right = len - ss->critical - 1;
+    ss->period = ((left > right) ? left : right) + 1;
+  }
+}
+
+SsEngine ss_choose_engine(const unsigned char *pattern, long len) {
+  int seen[256] = {0};
+  int distinct = 0;
+
+  for (long i = 0; i < len; i++) {
+    if (!seen[pattern[i]]) {
+      seen[pattern[i]] = TRUE;
+      distinct++;
+    }
+  }
+
+  // Tiny alphabets make first/last-byte candidates verify deep into the
+  // pattern and Horspool shifts short: only Two-Way stays linear
+  if (distinct <= SS_SMALL_ALPHABET && len >= SS_TWO_WAY_MIN_LEN) {
+    return SS_TWO_WAY;
+  }
+#ifdef __x86_64__
+  // The vector filter runs at memory bandwidth for any length; Horspool's
+  // skips never catch up with it once 16-32 positions go per compare
+  return SS_SIMD;
+#else
+  return (len >= SS_HORSPOOL_MIN_LEN) ? SS_HORSPOOL : SS_SIMD;
+#endif
+}
+
+long ss_search(const SubstringSearch *ss, const char *text, long n,
+               SsMatchFn on_match, void *ctx) {
+  const unsigned char *s = (const unsigned char *)text;
+
+  if (ss->len == 0 || ss->len > n) {
+    return 0;
+  }
+
+  switch (ss->engine) {
+  case SS_HORSPOOL:
+    return ss_search_horspool(ss, s, n, on_match, ctx);
+  case SS_TWO_WAY:
+    return ss_search_two_way(ss, s, n, on_match, ctx);
+  default:
+    return ss_search_simd(ss, s, n, on_match, ctx);
+  }
+}
+
+long ss_search_horspool(const SubstringSearch *ss, const unsigned char *s,
+                        long n, SsMatchFn on_match, void *ctx) {
+  const unsigned char *x = ss->pattern;
+  long m = ss->len;
+  long matches = 0;
+  unsigned char last = x[m - 1];
+
+  for (long j = 0; j <= n - m; j += ss->shift[s[j + m - 1]]) {
+    if (s[j + m - 1] == last && memcmp(s + j, x, m - 1) == 0) {
+      matches++;
+      if (on_match != NULL) {
+        on_match(j, ctx);
+      }
+    }
+  }
+  return matches;
+}
+
+long ss_search_two_way(const SubstringSearch *ss, const unsigned char *s,
+                       long n, SsMatchFn on_match, void *ctx) {
+  const unsigned char *x = ss->pattern;
+  long m = ss->len;
+  long ell = ss->critical;
+  long matches = 0;
+  long memory = -1; // Prefix already known to match (periodic case)
+
+  for (long j = 0; j <= n - m;) {
+    // Right half left to right, then left half right to left
+    long i = ((ell > memory) ? ell : memory) + 1;
+    while (i < m && x[i] == s[i + j]) {
+      i++;
+    }
+    if (i < m) {
+      j += i - ell;
+      memory = -1;
+      continue;
+    }
+
+    i = ell;
+    while (i > memory && x[i] == s[i + j]) {
+      i--;
+    }
+    if (i <= memory) {
+      matches++;
+      if (on_match != NULL) {
+        on_match(j, ctx);
+      }
+    }
+    j += ss->period;
+    memory = ss->periodic ? m - ss->period - 1 : -1;
+  }
+  return matches;
+}
+
+long ss_max_suffix(const unsigned char *x, long m, long *period,
+                   int reversed) {
+  long ms = -1;
+  long j = 0;
+  long k = 1;
+
+  *period = 1;
+  while (j + k < m) {
+    unsigned char a = x[j + k];
+    unsigned char b = x[ms + k];
+    if (a == b) {
+      if (k == *period) {
+        j += *period;
+        k = 1;
+      } else {
+        k++;
+      }
+    } else if ((a < b) != reversed) {
+      j += k;
+      k = 1;
+      *period = j - ms;
+    } else {
+      ms = j;
+      j = ms + 1;
+      k = 1;
+      *period = 1;
+    }
+  }
+  return ms;
+}
+
+long ss_search_simd(const SubstringSearch *ss, const unsigned char *s,
+                    long n, SsMatchFn on_match, void *ctx) {
+  const unsigned char *x = ss->pattern;
+  long m = ss->len;
+  long matches = 0;
+  long i = 0;
+
+#ifdef __x86_64__
+  if (ss->avx2) {
+    return ss_search_avx2(ss, s, n, on_match, ctx);
+  }
+
+  // SSE2 is part of x86_64: 16 candidate positions per step
+  __m128i first = _mm_set1_epi8((char)x[0]);
+  __m128i last = _mm_set1_epi8((char)x[m - 1]);
+  for (; i + m + 15 <= n; i += 16) {
+    __m128i block_first = _mm_loadu_si128((const __m128i *)(s + i));
+    __m128i block_last = _mm_loadu_si128((const __m128i *)(s + i + m - 1));
+    unsigned mask = (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                      _mm_cmpeq_epi8(last, block_last)));
+    while (mask != 0) {
+      long pos = i + __builtin_ctz(mask);
+      if (m < 3 || memcmp(s + pos + 1, x + 1, m - 2) == 0) {
+        matches++;
+        if (on_match != NULL) {
+          on_match(pos, ctx);
+        }
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  for (; i <= n - m; i++) {
+    if (s[i] == x[0] && s[i + m - 1] == x[m - 1] &&
+        memcmp(s + i, x, m) == 0) {
+      matches++;
+      if (on_match != NULL) {
+        on_match(i, ctx);
+      }
+    }
+  }
+  return matches;
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) long
+ss_search_avx2(const SubstringSearch *ss, const unsigned char *s, long n,
+               SsMatchFn on_match, void *ctx) {
+  const unsigned char *x = ss->pattern;
+  long m = ss->len;
+  long matches = 0;
+  long i = 0;
+
+  __m256i first = _mm256_set1_epi8((char)x[0]);
+  __m256i last = _mm256_set1_epi8((char)x[m - 1]);
+  for (; i + m + 31 <= n; i += 32) {
+    __m256i block_first = _mm256_loadu_si256((const __m256i *)(s + i));
+    __m256i block_last =
+        _mm256_loadu_si256((const __m256i *)(s + i + m - 1));
+    unsigned mask = (unsigned)_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                         _mm256_cmpeq_epi8(last, block_last)));
+    while (mask != 0) {
+      long pos = i + __builtin_ctz(mask);
+      if (m < 3 || memcmp(s + pos + 1, x + 1, m - 2) == 0) {
+        matches++;
+        if (on_match != NULL) {
+          on_match(pos, ctx);
+        }
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  for (; i <= n - m; i++) {
+    if (s[i] == x[0] && s[i + m - 1] == x[m - 1] &&
+        memcmp(s + i, x, m) == 0) {
+      matches++;
+      if (on_match != NULL) {
+        on_match(i, ctx);
+      }
+    }
+  }
+  return matches;
+}
+#endif
+
+const char *ss_engine_name(const SubstringSearch *ss) {
+  switch (ss->engine) {
+  case SS_HORSPOOL:
+    return "Horspool";
+  case SS_TWO_WAY:
+    return "Two-Way";
+  default:
+#ifdef __x86_64__
+    return ss->avx2 ? "SIMD-AVX2" : "SIMD-SSE2";
+#else
+    return "Filter";
+#endif
+  }
+}
+
+void print_ss_match(long start, void *ctx) {
+  int *shown = (int *)ctx;
+  if ((*shown)++ < AC_DEMO_MATCHES) {
+    printf("    [%ld]\n", start);
+  }
+}
+
+int cpu_has_avx2(void) {
+#ifdef __x86_64__
+  return __builtin_cpu_supports("avx2");
+#else
+  return FALSE;
+#endif
+}
+
+Status kmp_stream_init(KmpStream *ks, const char *pattern) {
+  ks->pattern = pattern;
+  ks->len = (int)strlen(pattern);
+  ks->matched = 0;
+  ks->offset = 0;
+  ks->lps = (int *)malloc((ks->len > 0 ? ks->len : 1) * sizeof(int));
+  if (ks->lps == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  if (ks->len > 0) {
+    compute_lps_array(pattern, ks->len, ks->lps);
+  }
+  return SUCCESS;
+}
+
+long kmp_stream_feed(void *stream, const char *chunk, long n,
+                     AcMatchFn on_match, void *ctx) {
+  KmpStream *ks = (KmpStream *)stream;
+  long matches = 0;
+  int j = ks->matched;
+
+  if (ks->len == 0) {
+    return 0;
+  }
+
+  for (long i = 0; i < n; i++) {
+    while (j > 0 && chunk[i] != ks->pattern[j]) {
+      j = ks->lps[j - 1];
+    }
+    if (chunk[i] == ks->pattern[j]) {
+      j++;
+    }
+    if (j == ks->len) {
+      // The match may have started in an earlier chunk
+      matches++;
+      if (on_match != NULL) {
+        on_match(0, ks->offset + i - ks->len + 1, ctx);
+      }
+      j = ks->lps[j - 1];
+    }
+  }
+
+  ks->matched = j;
+  ks->offset += n;
+  return matches;
+}
+
+void kmp_stream_free(KmpStream *ks) {
+  free(ks->lps);
+  ks->lps = NULL;
+}
+
+Status stream_open(StreamSource *src, const char *spec) {
+  src->pipe = NULL;
+  src->fd = -1;
+
+  if (strncmp(spec, "cmd:", 4) == 0) {
+    src->pipe = popen(spec + 4, "r");
+    if (src->pipe != NULL) {
+      src->fd = fileno(src->pipe);
+    }
+  } else if (strncmp(spec, "tcp:", 4) == 0) {
+    src->fd = stream_connect(spec + 4);
+  } else {
+    src->fd = open(spec, O_RDONLY);
+  }
+  return (src->fd >= 0) ? SUCCESS : ERR_FILE_IO;
+}
+
+int stream_connect(const char *address) {
+  char host[MAX_SOURCE];
+  struct addrinfo hints;
+  struct addrinfo *list = NULL;
+
+  // HOST:PORT, split on the last ':' so the port is always the tail
+  const char *colon = strrchr(address, ':');
+  if (colon == NULL || colon == address ||
+      (size_t)(colon - address) >= sizeof(host)) {
+    errno = EINVAL;
+    return -1;
+  }
+  memcpy(host, address, colon - address);
+  host[colon - address] = '\0';
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  int rc = getaddrinfo(host, colon + 1, &hints, &list);
+  if (rc != 0) {
+    fprintf(stderr, "  - getaddrinfo: %s\n", gai_strerror(rc));
+    errno = EINVAL;
+    return -1;
+  }
+
+  int fd = -1;
+  for (struct addrinfo *ai = list; ai != NULL && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+      int saved = errno;
+      close(fd);
+      fd = -1;
+      errno = saved;
+    }
+  }
+  freeaddrinfo(list);
+  return fd;
+}
+
+void stream_close(StreamSource *src) {
+  if (src->pipe != NULL) {
+    pclose(src->pipe);
+  } else if (src->fd >= 0) {
+    close(src->fd);
+  }
+  src->pipe = NULL;
+  src->fd = -1;
+}
+
+long stream_search_fd(int fd, StreamFeedFn feed, void *stream,
+                      AcMatchFn on_match, void *ctx, long *matches) {
+  static char buffer[STREAM_CHUNK];
+  long total = 0;
+
+  *matches = 0;
+  while (TRUE) {
+    // Pipes and sockets return short reads; any size is a valid chunk
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n == 0) {
+      break;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    *matches += feed(stream, buffer, (long)n, on_match, ctx);
+    total += n;
+  }
+  return total;
+}
+
+void print_perf_counters(const PerfCounters *pc) {
+  char cycles[16], cache[16], branch[16];
+
+  if (pc->opened == 0) {
+    printf("  - HW Counters: unavailable (perf_event_open: %s)\n",
+           strerror(pc->error));
+    return;
+  }
+
+  perf_format_event(pc, PERF_CYCLES, cycles, sizeof(cycles));
+  perf_format_event(pc, PERF_CACHE_MISSES, cache, sizeof(cache));
+  perf_format_event(pc, PERF_BRANCH_MISSES, branch, sizeof(branch));
+  printf("  - HW Cycles:   %s (IPC %.2f)\n", cycles, perf_ipc(pc));
+  printf("  - HW Misses:   %s cache, %s branch\n", cache, branch);
+}
+
 void show_comparison(MatchStats bf_stats, MatchStats kmp_stats) {
   printf("\n=== Comparison ===\n");
 
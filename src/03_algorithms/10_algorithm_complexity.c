@@ -6,22 +6,33 @@
  ===============================================================================
  Features:
  - Operation counting and timing for multiple algorithms
+ - Hardware counters for Bubble Sort: cycles, IPC, cache and branch misses
+   (perf_event_open, perf_counters.h)
  - Bubble Sort O(n²) vs Binary Search O(log n) demonstration
  - ASCII bar chart for visual complexity representation
  - Configurable array sizes for benchmarking
  - Interactive menu for repeated analysis
+ - Benchmark harness mode with repeated trials and CSV/JSON export
  ===============================================================================
 */
 
+#define _GNU_SOURCE
+
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "bench_harness.h"
+#include "perf_counters.h"
+
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 4
+#define MAX_OPTION 5
+#define NUM_TESTS 5
+#define FILES_DIR "files"
 
 typedef enum {
   SUCCESS,
@@ -36,11 +47,18 @@ typedef struct {
   long long operations;
 } TestResult;
 
+typedef struct {
+  int *arr;
+  int size;
+  long long sink;
+} ComplexityBench;
+
 void show_menu(void);
 void handle_error(Status status);
 void run_bubble_sort_analysis(void);
 void run_binary_search_analysis(void);
 void run_complexity_info(void);
+void run_harness_benchmark(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
@@ -48,7 +66,10 @@ Status read_integer(int *value);
 long long algo_bubble_sort(int *arr, int n);
 long long algo_binary_search(int *arr, int n, int target);
 void print_graph(TestResult *results, int count, const char *label);
-void print_operations(long long ops);
+void format_operations(long long ops, char *buf, size_t len);
+void bench_bubble_setup(void *ctx);
+void bench_bubble_kernel(void *ctx);
+void bench_binary_kernel(void *ctx);
 
 int main(void) {
   int option = 0;
@@ -82,6 +103,9 @@ int main(void) {
     case 3:
       run_complexity_info();
       break;
+    case 4:
+      run_harness_benchmark();
+      break;
     }
   }
 
@@ -93,7 +117,8 @@ void show_menu(void) {
   printf("1. Analyze Bubble Sort   O(n²)\n");
   printf("2. Analyze Binary Search O(log n)\n");
   printf("3. Big O Complexity Info\n");
-  printf("4. Exit\n");
+  printf("4. Run Benchmark Harness (CSV/JSON)\n");
+  printf("5. Exit\n");
   printf("Option: ");
 }
 
@@ -117,15 +142,22 @@ void run_bubble_sort_analysis(void) {
   int sizes[] = {100, 200, 400, 800, 1600};
   int num_tests = sizeof(sizes) / sizeof(sizes[0]);
   TestResult results[5];
+  PerfCounters counters;
+  char operations[16], cycles[16], ipc[16], cache[16], branch[16];
+
+  perf_open(&counters);
 
   printf("\n=== Bubble Sort O(n²) Analysis ===\n\n");
-  printf("%-6s | %-12s | %s\n", "Size", "Time (ms)", "Operations");
-  printf("-------|--------------|------------\n");
+  printf("%-6s | %-12s | %-10s | %-8s | %-4s | %-8s | %s\n", "Size",
+         "Time (ms)", "Operations", "Cycles", "IPC", "LLC miss", "Br miss");
+  printf("-------|--------------|------------|----------|------|----------|"
+         "---------\n");
 
   for (int i = 0; i < num_tests; i++) {
     int n = sizes[i];
     int *arr = (int *)malloc(n * sizeof(int));
     if (arr == NULL) {
+      perf_close(&counters);
       handle_error(ERR_MEMORY_ALLOCATION);
       return;
     }
@@ -135,25 +167,38 @@ void run_bubble_sort_analysis(void) {
       arr[j] = n - j;
     }
 
-    clock_t start = clock();
+    perf_start(&counters);
+    double start = bench_now();
     long long ops = algo_bubble_sort(arr, n);
-    clock_t end = clock();
-
-    double time_ms = ((double)(end - start)) / CLOCKS_PER_SEC * 1000.0;
-    if (time_ms <= 0.0)
-      time_ms = 0.001;
+    double time_ms = (bench_now() - start) * 1000.0;
+    perf_stop(&counters);
 
     results[i].size = n;
     results[i].time_ms = time_ms;
     results[i].operations = ops;
 
-    printf("%-6d | %9.3f    | ", n, time_ms);
-    print_operations(ops);
-    printf("\n");
+    perf_format_event(&counters, PERF_CYCLES, cycles, sizeof(cycles));
+    perf_format_event(&counters, PERF_CACHE_MISSES, cache, sizeof(cache));
+    perf_format_event(&counters, PERF_BRANCH_MISSES, branch, sizeof(branch));
+    if (perf_ipc(&counters) > 0.0) {
+      snprintf(ipc, sizeof(ipc), "%.2f", perf_ipc(&counters));
+    } else {
+      snprintf(ipc, sizeof(ipc), "n/a");
+    }
+
+    format_operations(ops, operations, sizeof(operations));
+    printf("%-6d | %9.3f    | %-10s | %-8s | %-4s | %-8s | %s\n", n, time_ms,
+           operations, cycles, ipc, cache, branch);
 
     free(arr);
   }
 
+  if (counters.opened == 0) {
+    printf("\n  - HW counters unavailable (perf_event_open: %s)\n",
+           strerror(counters.error));
+  }
+  perf_close(&counters);
+
   print_graph(results, num_tests, "n²");
 
   printf("\n  - Complexity Detected: O(n²)\n");
@@ -184,13 +229,9 @@ void run_binary_search_analysis(void) {
 
     int target = arr[n - 1]; // Worst case: last element
 
-    clock_t start = clock();
+    double start = bench_now();
     long long ops = algo_binary_search(arr, n, target);
-    clock_t end = clock();
-
-    double time_ms = ((double)(end - start)) / CLOCKS_PER_SEC * 1000.0;
-    if (time_ms <= 0.0)
-      time_ms = 0.001;
+    double time_ms = (bench_now() - start) * 1000.0;
 
     results[i].size = n;
     results[i].time_ms = time_ms;
@@ -205,6 +246,63 @@ void run_binary_search_analysis(void) {
   printf("  - Growth Rate: Multiplying n×10 → only ~3 more operations.\n\n");
 }
 
+void run_harness_benchmark(void) {
+  int bubble_sizes[NUM_TESTS] = {100, 200, 400, 800, 1600};
+  int search_sizes[NUM_TESTS] = {100, 1000, 10000, 100000, 1000000};
+  ComplexityBench bubble[NUM_TESTS];
+  ComplexityBench search[NUM_TESTS];
+  BenchRegistry reg;
+  char name[BENCH_NAME_LEN];
+  Status status = SUCCESS;
+
+  bench_init(&reg, "complexity");
+  for (int i = 0; i < NUM_TESTS; i++) {
+    bubble[i].size = bubble_sizes[i];
+    bubble[i].sink = 0;
+    bubble[i].arr = (int *)malloc(bubble_sizes[i] * sizeof(int));
+    search[i].size = search_sizes[i];
+    search[i].sink = 0;
+    search[i].arr = (int *)malloc(search_sizes[i] * sizeof(int));
+    if (bubble[i].arr == NULL || search[i].arr == NULL) {
+      status = ERR_MEMORY_ALLOCATION;
+      continue;
+    }
+
+    for (int j = 0; j < search_sizes[i]; j++) {
+      search[i].arr[j] = j * 2;
+    }
+
+    snprintf(name, sizeof(name), "bubble_sort_n%d", bubble_sizes[i]);
+    bench_register(&reg, name, bench_bubble_setup, bench_bubble_kernel,
+                   &bubble[i]);
+    snprintf(name, sizeof(name), "binary_search_n%d", search_sizes[i]);
+    bench_register(&reg, name, NULL, bench_binary_kernel, &search[i]);
+  }
+
+  if (status == SUCCESS) {
+    printf("\n=== Harness: %d warmup, %d trials ===\n", reg.config.warmup,
+           reg.config.trials);
+    if (bench_run_all(&reg)) {
+      bench_print_table(&reg);
+      if (bench_export_csv(&reg, FILES_DIR "/bench_complexity.csv") &&
+          bench_export_json(&reg, FILES_DIR "/bench_complexity.json")) {
+        printf("\n  - Results: %s/bench_complexity.{csv,json}\n\n",
+               FILES_DIR);
+      } else {
+        printf("\n  - Error: could not write to %s/\n\n", FILES_DIR);
+      }
+    } else {
+      status = ERR_MEMORY_ALLOCATION;
+    }
+  }
+
+  for (int i = 0; i < NUM_TESTS; i++) {
+    free(bubble[i].arr);
+    free(search[i].arr);
+  }
+  handle_error(status);
+}
+
 void run_complexity_info(void) {
   printf("\n=== Big O Complexity Reference ===\n\n");
   printf("  Notation   | Name          | Example\n");
@@ -284,12 +382,32 @@ void print_graph(TestResult *results, int count, const char *label) {
   }
 }
 
-void print_operations(long long ops) {
+void bench_bubble_setup(void *ctx) {
+  ComplexityBench *bench = (ComplexityBench *)ctx;
+  // Worst case: reverse sorted array
+  for (int j = 0; j < bench->size; j++) {
+    bench->arr[j] = bench->size - j;
+  }
+}
+
+void bench_bubble_kernel(void *ctx) {
+  ComplexityBench *bench = (ComplexityBench *)ctx;
+  bench->sink += algo_bubble_sort(bench->arr, bench->size);
+}
+
+void bench_binary_kernel(void *ctx) {
+  ComplexityBench *bench = (ComplexityBench *)ctx;
+  // Worst case: last element
+  bench->sink += algo_binary_search(bench->arr, bench->size,
+                                    bench->arr[bench->size - 1]);
+}
+
+void format_operations(long long ops, char *buf, size_t len) {
   if (ops >= 1000000) {
-    printf("%.2fM", (double)ops / 1000000.0);
+    snprintf(buf, len, "%.2fM", (double)ops / 1000000.0);
   } else if (ops >= 1000) {
-    printf("%.1fK", (double)ops / 1000.0);
+    snprintf(buf, len, "%.1fK", (double)ops / 1000.0);
   } else {
-    printf("%lld", ops);
+    snprintf(buf, len, "%lld", ops);
   }
 }
@@ -0,0 +1,358 @@
+/*
+ ===============================================================================
+ Header: bench_harness.h
+ Description: Shared benchmark harness for the algorithm exercises
+ Platform: GNU/Linux (Arch/WSL) on x86_64
+ ===============================================================================
+ Features:
+ - Monotonic wall-clock timing (clock_gettime) plus TSC ticks (rdtsc)
+ - Warmup runs and automatic batching of sub-millisecond kernels
+ - Repeated trials with MAD-based outlier rejection
+ - Median, mean, standard deviation and 95% confidence interval
+ - Kernel registry per exercise with CSV (appended) and JSON export
+ ===============================================================================
+ Usage:
+ - Define _POSIX_C_SOURCE 200809L before any #include, then include this
+   header after the system headers. Every exercise is a single translation
+   unit, so the definitions live here.
+ - Register kernels with bench_register(), run them with bench_run_all()
+   and export with bench_export_csv()/bench_export_json().
+ - Set BENCH_LABEL (e.g. the short commit hash) to tag exported results.
+ ===============================================================================
+*/
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+
+#define BENCH_MAX_CASES 32
+#define BENCH_NAME_LEN 64
+#define BENCH_WARMUP 3
+#define BENCH_TRIALS 15
+#define BENCH_OUTLIER_K 3.0
+#define BENCH_MIN_TRIAL_SEC 0.001
+#define BENCH_MAX_BATCH (1L << 24)
+
+typedef void (*BenchFn)(void *ctx);
+
+typedef struct {
+  int warmup;
+  int trials;
+  double outlier_k;
+} BenchConfig;
+
+typedef struct {
+  char name[BENCH_NAME_LEN];
+  BenchFn setup;  // Untimed, runs before every trial (may be NULL)
+  BenchFn kernel; // Timed region
+  void *ctx;
+  long batch; // Kernel calls per trial (1 when setup is present)
+  int trials;
+  int kept;
+  double median; // All times are seconds per kernel call
+  double mean;
+  double stddev;
+  double min;
+  double max;
+  double ci_low;
+  double ci_high;
+  double ticks; // Median TSC ticks per kernel call
+} BenchCase;
+
+typedef struct {
+  const char *suite;
+  BenchConfig config;
+  BenchCase cases[BENCH_MAX_CASES];
+  int count;
+} BenchRegistry;
+
+void bench_init(BenchRegistry *reg, const char *suite);
+int bench_register(BenchRegistry *reg, const char *name, BenchFn setup,
+                   BenchFn kernel, void *ctx);
+double bench_now(void);
+unsigned long long bench_ticks(void);
+int bench_run_case(BenchCase *bc, const BenchConfig *cfg);
+int bench_run_all(BenchRegistry *reg);
+void bench_print_table(const BenchRegistry *reg);
+int bench_export_csv(const BenchRegistry *reg, const char *path);
+int bench_export_json(const BenchRegistry *reg, const char *path);
+void bench_format_time(double seconds, char *buf, size_t len);
+int bench_compare_doubles(const void *a, const void *b);
+double bench_median(double *values, int n);
+double bench_t_critical(int df);
+
+void bench_init(BenchRegistry *reg, const char *suite) {
+  memset(reg, 0, sizeof(*reg));
+  reg->suite = suite;
+  reg->config.warmup = BENCH_WARMUP;
+  reg->config.trials = BENCH_TRIALS;
+  reg->config.outlier_k = BENCH_OUTLIER_K;
+}
+
+int bench_register(BenchRegistry *reg, const char *name, BenchFn setup,
+                   BenchFn kernel, void *ctx) {
+  if (reg->count >= BENCH_MAX_CASES) {
+    return 0;
+  }
+
+  BenchCase *bc = &reg->cases[reg->count++];
+  memset(bc, 0, sizeof(*bc));
+  snprintf(bc->name, BENCH_NAME_LEN, "%s", name);
+  bc->setup = setup;
+  bc->kernel = kernel;
+  bc->ctx = ctx;
+  return 1;
+}
+
+double bench_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+unsigned long long bench_ticks(void) {
+#ifdef __x86_64__
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+int bench_run_case(BenchCase *bc, const BenchConfig *cfg) {
+  double *samples = (double *)malloc(cfg->trials * sizeof(double));
+  double *ticks = (double *)malloc(cfg->trials * sizeof(double));
+  double *deviations = (double *)malloc(cfg->trials * sizeof(double));
+  if (samples == NULL || ticks == NULL || deviations == NULL) {
+    free(samples);
+    free(ticks);
+    free(deviations);
+    return 0;
+  }
+
+  for (int w = 0; w < cfg->warmup; w++) {
+    if (bc->setup != NULL) {
+      bc->setup(bc->ctx);
+    }
+    bc->kernel(bc->ctx);
+  }
+
+  // Batch fast kernels so each trial is well above the timer resolution.
+  // Kernels that need a fresh input every call cannot be batched.
+  bc->batch = 1;
+  if (bc->setup == NULL) {
+    while (bc->batch < BENCH_MAX_BATCH) {
+      double start = bench_now();
+      for (long b = 0; b < bc->batch; b++) {
+        bc->kernel(bc->ctx);
+      }
+      if (bench_now() - start >= BENCH_MIN_TRIAL_SEC) {
+        break;
+      }
+      bc->batch *= 2;
+    }
+  }
+
+  for (int t = 0; t < cfg->trials; t++) {
+    if (bc->setup != NULL) {
+      bc->setup(bc->ctx);
+    }
+
+    unsigned long long tick_start = bench_ticks();
+    double start = bench_now();
+    for (long b = 0; b < bc->batch; b++) {
+      bc->kernel(bc->ctx);
+    }
+    double end = bench_now();
+    unsigned long long tick_end = bench_ticks();
+
+    samples[t] = (end - start) / (double)bc->batch;
+    ticks[t] = (double)(tick_end - tick_start) / (double)bc->batch;
+  }
+
+  bc->trials = cfg->trials;
+  bc->ticks = bench_median(ticks, cfg->trials);
+  double median = bench_median(samples, cfg->trials);
+
+  // Median absolute deviation, scaled to estimate sigma for normal data
+  for (int t = 0; t < cfg->trials; t++) {
+    deviations[t] = fabs(samples[t] - median);
+  }
+  double mad = 1.4826 * bench_median(deviations, cfg->trials);
+  double limit = cfg->outlier_k * mad;
+
+  double sum = 0.0;
+  bc->kept = 0;
+  bc->min = INFINITY;
+  bc->max = 0.0;
+  for (int t = 0; t < cfg->trials; t++) {
+    if (mad > 0.0 && fabs(samples[t] - median) > limit) {
+      continue;
+    }
+    samples[bc->kept++] = samples[t];
+    sum += samples[t];
+  }
+
+  bc->mean = sum / bc->kept;
+  double var = 0.0;
+  for (int t = 0; t < bc->kept; t++) {
+    var += (samples[t] - bc->mean) * (samples[t] - bc->mean);
+    bc->min = (samples[t] < bc->min) ? samples[t] : bc->min;
+    bc->max = (samples[t] > bc->max) ? samples[t] : bc->max;
+  }
+  bc->stddev = (bc->kept > 1) ? sqrt(var / (bc->kept - 1)) : 0.0;
+  bc->median = bench_median(samples, bc->kept);
+
+  double half =
+      bench_t_critical(bc->kept - 1) * bc->stddev / sqrt((double)bc->kept);
+  bc->ci_low = bc->mean - half;
+  bc->ci_high = bc->mean + half;
+
+  free(samples);
+  free(ticks);
+  free(deviations);
+  return 1;
+}
+
+int bench_run_all(BenchRegistry *reg) {
+  for (int i = 0; i < reg->count; i++) {
+    if (!bench_run_case(&reg->cases[i], &reg->config)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+void bench_print_table(const BenchRegistry *reg) {
+  char median[16], low[16], high[16];
+
+  printf("\n%-26s | %-10s | %-23s | %-7s | %s\n", "Kernel", "Median",
+         "95% CI (mean)", "Kept", "Ticks/call");
+  printf("---------------------------|------------|-------------------------|"
+         "---------|-----------\n");
+
+  for (int i = 0; i < reg->count; i++) {
+    const BenchCase *bc = &reg->cases[i];
+    bench_format_time(bc->median, median, sizeof(median));
+    bench_format_time(bc->ci_low, low, sizeof(low));
+    bench_format_time(bc->ci_high, high, sizeof(high));
+    printf("%-26s | %10s | %10s - %10s | %3d/%-3d | %.0f\n", bc->name, median,
+           low, high, bc->kept, bc->trials, bc->ticks);
+  }
+}
+
+int bench_export_csv(const BenchRegistry *reg, const char *path) {
+  FILE *probe = fopen(path, "r");
+  int needs_header = (probe == NULL);
+  if (probe != NULL) {
+    fclose(probe);
+  }
+
+  // Append so that results from successive commits accumulate in one file
+  FILE *file = fopen(path, "a");
+  if (file == NULL) {
+    return 0;
+  }
+
+  const char *label = getenv("BENCH_LABEL");
+  long stamp = (long)time(NULL);
+
+  if (needs_header) {
+    fprintf(file, "timestamp,label,suite,kernel,batch,trials,kept,median_s,"
+                  "mean_s,stddev_s,ci95_low_s,ci95_high_s,min_s,max_s,"
+                  "median_ticks\n");
+  }
+  for (int i = 0; i < reg->count; i++) {
+    const BenchCase *bc = &reg->cases[i];
+    fprintf(file, "%ld,%s,%s,%s,%ld,%d,%d,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,%.9e,"
+                  "%.0f\n",
+            stamp, label ? label : "", reg->suite, bc->name, bc->batch,
+            bc->trials, bc->kept, bc->median, bc->mean, bc->stddev,
+            bc->ci_low, bc->ci_high, bc->min, bc->max, bc->ticks);
+  }
+
+  fclose(file);
+  return 1;
+}
+
+int bench_export_json(const BenchRegistry *reg, const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    return 0;
+  }
+
+  const char *label = getenv("BENCH_LABEL");
+
+  fprintf(file, "{\n  \"suite\": \"%s\",\n  \"label\": \"%s\",\n", reg->suite,
+          label ? label : "");
+  fprintf(file, "  \"timestamp\": %ld,\n  \"warmup\": %d,\n", (long)time(NULL),
+          reg->config.warmup);
+  fprintf(file, "  \"kernels\": [\n");
+  for (int i = 0; i < reg->count; i++) {
+    const BenchCase *bc = &reg->cases[i];
+    fprintf(file,
+            "    {\"name\": \"%s\", \"batch\": %ld, \"trials\": %d, "
+            "\"kept\": %d, \"median_s\": %.9e, \"mean_s\": %.9e, "
+            "\"stddev_s\": %.9e, \"ci95_s\": [%.9e, %.9e], "
+            "\"min_s\": %.9e, \"max_s\": %.9e, \"median_ticks\": %.0f}%s\n",
+            bc->name, bc->batch, bc->trials, bc->kept, bc->median, bc->mean,
+            bc->stddev, bc->ci_low, bc->ci_high, bc->min, bc->max, bc->ticks,
+            (i < reg->count - 1) ? "," : "");
+  }
+  fprintf(file, "  ]\n}\n");
+
+  fclose(file);
+  return 1;
+}
+
+void bench_format_time(double seconds, char *buf, size_t len) {
+  if (seconds < 1e-6) {
+    snprintf(buf, len, "%.1f ns", seconds * 1e9);
+  } else if (seconds < 1e-3) {
+    snprintf(buf, len, "%.2f us", seconds * 1e6);
+  } else if (seconds < 1.0) {
+    snprintf(buf, len, "%.3f ms", seconds * 1e3);
+  } else {
+    snprintf(buf, len, "%.3f s", seconds);
+  }
+}
+
+int bench_compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+double bench_median(double *values, int n) {
+  qsort(values, n, sizeof(double), bench_compare_doubles);
+  if (n % 2 == 1) {
+    return values[n / 2];
+  }
+  return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+double bench_t_critical(int df) {
+  // Two-sided 95% Student t quantiles; normal approximation past 30
+  static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447,
+                                 2.365,  2.306, 2.262, 2.228, 2.201, 2.179,
+                                 2.160,  2.145, 2.131, 2.120, 2.110, 2.101,
+                                 2.093,  2.086, 2.080, 2.074, 2.069, 2.064,
+                                 2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+  if (df < 1) {
+    return 0.0;
+  }
+  if (df <= 30) {
+    return table[df - 1];
+  }
+  return 1.960;
+}
+
+#endif
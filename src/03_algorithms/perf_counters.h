@@ -0,0 +1,164 @@
+/*
+ ===============================================================================
+ Header: perf_counters.h
+ Description: Hardware performance counters around a code region
+ Platform: GNU/Linux (Arch/WSL) on x86_64
+ ===============================================================================
+ Features:
+ - perf_event_open counters: cycles, instructions, cache misses (LLC) and
+   branch misses, user space only, inherited by threads created later
+ - Multiplexing correction (time_enabled / time_running scaling)
+ - Derived IPC and per-counter availability (VMs often lack some events)
+ - Graceful fallback when perf is unavailable: perf_open() returns 0 and
+   keeps the errno so the caller can explain why
+ ===============================================================================
+ Usage:
+ - Define _GNU_SOURCE before any #include (syscall() is not POSIX), then
+   include this header after the system headers.
+ - perf_open() once, then perf_start()/perf_stop() around the region and
+   read values[] or perf_ipc(). perf_close() releases the descriptors.
+ - Access is governed by /proc/sys/kernel/perf_event_paranoid (<= 2 is
+   enough for user-space counting of the own process).
+ ===============================================================================
+*/
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+typedef enum {
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_MISSES,
+  PERF_BRANCH_MISSES,
+  PERF_EVENT_COUNT
+} PerfEvent;
+
+typedef struct {
+  int fds[PERF_EVENT_COUNT];
+  int valid[PERF_EVENT_COUNT]; // Counter opened and ran during the region
+  unsigned long long values[PERF_EVENT_COUNT];
+  int opened;
+  int error; // errno of the first failed perf_event_open
+} PerfCounters;
+
+int perf_open(PerfCounters *pc);
+void perf_start(PerfCounters *pc);
+void perf_stop(PerfCounters *pc);
+void perf_close(PerfCounters *pc);
+double perf_ipc(const PerfCounters *pc);
+void perf_format_event(const PerfCounters *pc, PerfEvent event, char *buf,
+                       size_t len);
+
+int perf_open(PerfCounters *pc) {
+  static const unsigned long long configs[PERF_EVENT_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+  memset(pc, 0, sizeof(*pc));
+  for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // Own process, any CPU, no group: each event survives on its own
+    pc->fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (pc->fds[i] < 0) {
+      if (pc->error == 0) {
+        pc->error = errno;
+      }
+      continue;
+    }
+    pc->opened++;
+  }
+  return pc->opened;
+}
+
+void perf_start(PerfCounters *pc) {
+  for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+    pc->valid[i] = 0;
+    pc->values[i] = 0;
+    if (pc->fds[i] >= 0) {
+      ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void perf_stop(PerfCounters *pc) {
+  // Disable everything first so the reads are not counted
+  for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+    if (pc->fds[i] >= 0) {
+      ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+
+  for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+    unsigned long long data[3]; // value, time_enabled, time_running
+    if (pc->fds[i] < 0 ||
+        read(pc->fds[i], data, sizeof(data)) != (ssize_t)sizeof(data) ||
+        data[2] == 0) {
+      continue;
+    }
+
+    // The PMU may have time-shared this counter with other events
+    pc->values[i] = data[0];
+    if (data[2] < data[1]) {
+      pc->values[i] =
+          (unsigned long long)((double)data[0] * data[1] / data[2]);
+    }
+    pc->valid[i] = 1;
+  }
+}
+
+void perf_close(PerfCounters *pc) {
+  for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+    if (pc->fds[i] >= 0) {
+      close(pc->fds[i]);
+    }
+    pc->fds[i] = -1;
+  }
+}
+
+double perf_ipc(const PerfCounters *pc) {
+  if (!pc->valid[PERF_CYCLES] || !pc->valid[PERF_INSTRUCTIONS] ||
+      pc->values[PERF_CYCLES] == 0) {
+    return 0.0;
+  }
+  return (double)pc->values[PERF_INSTRUCTIONS] /
+         (double)pc->values[PERF_CYCLES];
+}
+
+void perf_format_event(const PerfCounters *pc, PerfEvent event, char *buf,
+                       size_t len) {
+  unsigned long long value = pc->values[event];
+
+  if (!pc->valid[event]) {
+    snprintf(buf, len, "n/a");
+  } else if (value >= 1000000000ULL) {
+    snprintf(buf, len, "%.2fG", (double)value / 1e9);
+  } else if (value >= 1000000ULL) {
+    snprintf(buf, len, "%.2fM", (double)value / 1e6);
+  } else if (value >= 1000ULL) {
+    snprintf(buf, len, "%.1fK", (double)value / 1e3);
+  } else {
+    snprintf(buf, len, "%llu", value);
+  }
+}
+
+#endif
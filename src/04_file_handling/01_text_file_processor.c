@@ -7,33 +7,119 @@
  Features:
  - File I/O operations (fopen, fgets, fputs, etc.)
  - Substring search within lines
- - Word replacement and file updating
- - File statistics calculation
+ - Word replacement and file updating: streaming engine with large aligned
+   buffers, matches across buffer boundaries, writev() / copy_file_range()
+   output and an atomic O_TMPFILE + linkat() swap
+ - File statistics: SSE2/AVX2 bulk counter over large read() blocks, and
+   a multi-threaded mmap mode merging the word state at chunk boundaries
+ - Parallel grep: mmap'd file split at newline boundaries across threads,
+   SSE2/AVX2 first/last-byte substring kernel, line numbers of any length
+ - Large test file generator for the benchmarks
+ - Replace benchmark: line-based stdio engine vs streaming engine
+ - Statistics benchmark: fgetc() vs SIMD blocks vs threads
  - Interactive menu and error handling
  ===============================================================================
 */
 
+#define _GNU_SOURCE
+
 #include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 #define MAX_LINE 1024
+#define MAX_PATH 256
 #define FILENAME "datos.txt"
-#define TEMP_FILENAME "temp.txt"
+#define BIG_FILENAME "big.txt"
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 7
+#define MAX_OPTION 11
+#define MAX_THREADS 16
+#define MAX_REPORTED 20 // Matching lines printed by the parallel search
+#define LINE_PREVIEW 120
+#define IO_BUFFER (1 << 20)
+#define REPLACE_BUFFER (8 << 20)
+#define BUFFER_ALIGN 4096
+#define IOV_BATCH 256
+#define COPY_RANGE_MIN (64 * 1024) // Shorter unchanged spans go via writev
+#define MB (1024 * 1024)
 
 typedef enum {
   SUCCESS,
   ERR_INVALID_INPUT,
   ERR_INVALID_OPTION,
   ERR_FILE_NOT_FOUND,
-  ERR_FILE_CREATE_FAILED
+  ERR_FILE_CREATE_FAILED,
+  ERR_MEMORY_ALLOCATION,
+  ERR_THREAD_CREATE,
+  ERR_FILE_IO
 } Status;
 
+typedef struct {
+  long line;     // Line number inside the chunk (0-based)
+  size_t offset; // Absolute offset of the line start
+} LineHit;
+
+typedef struct {
+  const char *data;
+  size_t start; // Chunk [start, end), both on line starts
+  size_t end;
+  const char *word;
+  size_t word_len;
+  long occurrences;
+  long matched_lines;
+  long newlines;
+  int reported;
+  LineHit hits[MAX_REPORTED];
+} SearchJob;
+
+typedef struct {
+  long long replacements;
+  long long bytes_in;
+  long long written; // Bytes written with writev()
+  long long copied;  // Bytes copied in the kernel with copy_file_range()
+} ReplaceStats;
+
+// Counts for one span of text, assuming whitespace right before it
+typedef struct {
+  long long chars;
+  long long words; // Runs of non-space bytes
+  long long newlines;
+  int starts_in_word; // First byte is not whitespace
+  int ends_in_word;   // Last byte is not whitespace
+  int ends_newline;
+} TextCounts;
+
+typedef struct {
+  const char *data;
+  size_t start;
+  size_t end;
+  TextCounts counts;
+} CountJob;
+
+typedef struct {
+  int in_fd;
+  int out_fd;
+  int copy_range; // Cleared once copy_file_range() is not supported
+  int count;
+  struct iovec iov[IOV_BATCH];
+  ReplaceStats *stats;
+} ReplaceWriter;
+
 void show_menu(void);
 void handle_error(Status status);
 
@@ -43,18 +129,70 @@ void run_append_file(void);
 void run_search_word(void);
 void run_replace_word(void);
 void run_statistics(void);
+void run_parallel_search(void);
+void run_generate_file(void);
+void run_replace_benchmark(void);
+void run_statistics_benchmark(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 Status read_string(char *buffer, int max_len);
 
 void create_dummy_file(void);
+Status read_path(char *path, int max_len, const char *fallback);
+double now_seconds(void);
+int online_cpus(void);
+
+const char *map_file(const char *path, size_t *size);
+size_t find_word(const char *hay, size_t n, const char *word, size_t m);
+size_t find_word_scalar(const char *hay, size_t n, const char *word,
+                        size_t m);
+size_t count_newlines(const char *p, size_t n);
+#ifdef __x86_64__
+size_t find_word_avx2(const char *hay, size_t n, const char *word,
+                      size_t m);
+size_t count_newlines_avx2(const char *p, size_t n);
+#endif
+void *search_worker(void *arg);
+double cat_baseline(const char *path);
+void print_line_hit(const char *data, size_t size, size_t offset, long line);
+
+
+long replace_stdio(FILE *in, FILE *out, const char *old_word,
+                   const char *new_word);
+Status replace_stream(int in_fd, int out_fd, const char *old_word,
+                      const char *new_word, ReplaceStats *stats);
+Status replace_file_atomic(const char *path, const char *old_word,
+                           const char *new_word, ReplaceStats *stats);
+ssize_t read_full(int fd, char *buffer, size_t len);
+Status writer_add(ReplaceWriter *w, const char *data, size_t len);
+Status writer_span(ReplaceWriter *w, long long offset, const char *data,
+                   size_t len);
+Status writer_flush(ReplaceWriter *w);
+
+
+void count_stdio(FILE *file, TextCounts *counts);
+Status count_blocks(const char *path, TextCounts *counts);
+Status count_parallel(const char *path, TextCounts *counts);
+void count_text(const char *p, size_t n, TextCounts *counts);
+#ifdef __x86_64__
+size_t count_text_avx2(const char *p, size_t n, TextCounts *counts,
+                       unsigned *in_word);
+#endif
+void merge_counts(TextCounts *total, const TextCounts *part);
+long long total_lines(const TextCounts *counts);
+void *count_worker(void *arg);
+
+int use_avx2 = FALSE;
 
 int main(void) {
   int option = 0;
 
   // Initialize a demo file if it doesn't exist
   create_dummy_file();
+#ifdef __x86_64__
+  use_avx2 = __builtin_cpu_supports("avx2");
+#endif
 
   while (TRUE) {
     show_menu();
@@ -93,6 +231,18 @@ int main(void) {
     case 6:
       run_statistics();
       break;
+    case 7:
+      run_parallel_search();
+      break;
+    case 8:
+      run_generate_file();
+      break;
+    case 9:
+      run_replace_benchmark();
+      break;
+    case 10:
+      run_statistics_benchmark();
+      break;
     }
   }
 
@@ -107,7 +257,11 @@ void show_menu(void) {
   printf("4. Search Word\n");
   printf("5. Replace Word\n");
   printf("6. File Statistics\n");
-  printf("7. Exit\n");
+  printf("7. Parallel Search (mmap, multi-threaded)\n");
+  printf("8. Generate Large Test File\n");
+  printf("9. Replace Benchmark (stdio vs streaming)\n");
+  printf("10. Statistics Benchmark (fgetc vs SIMD vs threads)\n");
+  printf("11. Exit\n");
   printf("Option: ");
 }
 
@@ -125,6 +279,15 @@ void handle_error(Status status) {
   case ERR_FILE_CREATE_FAILED:
     printf("Error: Could not create or open file for writing.\n\n");
     break;
+  case ERR_MEMORY_ALLOCATION:
+    printf("Error: Memory allocation failed.\n\n");
+    break;
+  case ERR_THREAD_CREATE:
+    printf("Error: Could not create worker thread.\n\n");
+    break;
+  case ERR_FILE_IO:
+    printf("Error: Reading or writing the file failed.\n\n");
+    break;
   case SUCCESS:
     break;
   }
@@ -263,6 +426,7 @@ void run_search_word(void) {
 
 void run_replace_word(void) {
   char old_word[256], new_word[256];
+  ReplaceStats stats;
 
   printf("\nEnter word to replace: ");
   if (read_string(old_word, sizeof(old_word)) != SUCCESS ||
@@ -277,55 +441,301 @@ void run_replace_word(void) {
     return;
   }
 
-  FILE *file = fopen(FILENAME, "r");
-  if (!file) {
-    handle_error(ERR_FILE_NOT_FOUND);
+  Status status = replace_file_atomic(FILENAME, old_word, new_word, &stats);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
 
-  FILE *temp_file = fopen(TEMP_FILENAME, "w");
-  if (!temp_file) {
-    fclose(file);
-    handle_error(ERR_FILE_CREATE_FAILED);
-    return;
-  }
+  printf("\n  - Replacements made: %lld\n", stats.replacements);
+  printf("  - File updated successfully.\n\n");
+}
 
+long replace_stdio(FILE *in, FILE *out, const char *old_word,
+                   const char *new_word) {
   char buffer[MAX_LINE];
-  int replacements = 0;
+  long replacements = 0;
 
-  while (fgets(buffer, sizeof(buffer), file)) {
+  while (fgets(buffer, sizeof(buffer), in)) {
     char *pos, *start = buffer;
     while ((pos = strstr(start, old_word)) != NULL) {
       // Print everything before old_word
-      fwrite(start, 1, pos - start, temp_file);
+      fwrite(start, 1, pos - start, out);
       // Print new_word
-      fputs(new_word, temp_file);
+      fputs(new_word, out);
       replacements++;
       start = pos + strlen(old_word);
     }
     // Print the rest of the line
-    fputs(start, temp_file);
+    fputs(start, out);
   }
+  return replacements;
+}
 
-  fclose(file);
-  fclose(temp_file);
+Status replace_file_atomic(const char *path, const char *old_word,
+                           const char *new_word, ReplaceStats *stats) {
+  char dir[MAX_PATH];
+  char tmp[MAX_PATH + 32];
+  struct stat st;
 
-  remove(FILENAME);
-  rename(TEMP_FILENAME, FILENAME);
+  int in_fd = open(path, O_RDONLY);
+  if (in_fd < 0 || fstat(in_fd, &st) != 0) {
+    if (in_fd >= 0) {
+      close(in_fd);
+    }
+    return ERR_FILE_NOT_FOUND;
+  }
 
-  printf("\n  - Replacements made: %d\n", replacements);
-  printf("  - File updated successfully.\n\n");
+  // Unnamed file in the target's directory: it only gets a name once it
+  // is complete, so a crash never leaves a half-written file behind
+  const char *slash = strrchr(path, '/');
+  if (slash == NULL) {
+    strcpy(dir, ".");
+  } else if (slash == path) {
+    strcpy(dir, "/");
+  } else {
+    snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+  }
+  snprintf(tmp, sizeof(tmp), "%s.replace.%ld", path, (long)getpid());
+
+  int named = FALSE;
+  int out_fd = open(dir, O_TMPFILE | O_WRONLY, st.st_mode & 0777);
+  if (out_fd < 0) {
+    // Filesystem without O_TMPFILE: a named temporary file instead
+    named = TRUE;
+    out_fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, st.st_mode & 0777);
+  }
+  if (out_fd < 0) {
+    close(in_fd);
+    return ERR_FILE_CREATE_FAILED;
+  }
+
+  Status status = replace_stream(in_fd, out_fd, old_word, new_word, stats);
+  if (status == SUCCESS && fsync(out_fd) != 0) {
+    status = ERR_FILE_IO;
+  }
+
+  if (status == SUCCESS && !named) {
+    char proc[64];
+    snprintf(proc, sizeof(proc), "/proc/self/fd/%d", out_fd);
+    if (linkat(AT_FDCWD, proc, AT_FDCWD, tmp, AT_SYMLINK_FOLLOW) != 0) {
+      status = ERR_FILE_CREATE_FAILED;
+    }
+  }
+  // linkat() cannot replace a file, rename() can, and does so atomically
+  if (status == SUCCESS && rename(tmp, path) != 0) {
+    status = ERR_FILE_CREATE_FAILED;
+  }
+  if (status != SUCCESS) {
+    unlink(tmp);
+  }
+
+  // The new name only survives a crash once the directory is on disk
+  if (status == SUCCESS) {
+    int dir_fd = open(dir, O_RDONLY);
+    if (dir_fd < 0 || fsync(dir_fd) != 0) {
+      status = ERR_FILE_IO;
+    }
+    if (dir_fd >= 0) {
+      close(dir_fd);
+    }
+  }
+
+  close(out_fd);
+  close(in_fd);
+  return status;
+}
+
+Status replace_stream(int in_fd, int out_fd, const char *old_word,
+                      const char *new_word, ReplaceStats *stats) {
+  size_t m = strlen(old_word);
+  size_t r = strlen(new_word);
+  char *buffer = NULL;
+  ReplaceWriter w;
+
+  memset(stats, 0, sizeof(*stats));
+  if (m == 0 || posix_memalign((void **)&buffer, BUFFER_ALIGN,
+                               REPLACE_BUFFER) != 0) {
+    return (m == 0) ? ERR_INVALID_INPUT : ERR_MEMORY_ALLOCATION;
+  }
+  posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  w.in_fd = in_fd;
+  w.out_fd = out_fd;
+  w.copy_range = TRUE;
+  w.count = 0;
+  w.stats = stats;
+
+  Status status = SUCCESS;
+  long long base = 0; // File offset of buffer[0]
+  size_t carry = 0;   // Bytes kept from the previous block
+  int eof = FALSE;
+
+  while (status == SUCCESS && !eof) {
+    ssize_t n = read_full(in_fd, buffer + carry, REPLACE_BUFFER - carry);
+    if (n < 0) {
+      status = ERR_FILE_IO;
+      break;
+    }
+    stats->bytes_in += n;
+    size_t filled = carry + (size_t)n;
+    eof = (size_t)n < REPLACE_BUFFER - carry;
+
+    // A match may start in the last m - 1 bytes and end in the next
+    // block: those bytes stay behind unless this is the end of the file
+    size_t safe = filled;
+    if (!eof) {
+      safe = (filled > m - 1) ? filled - (m - 1) : 0;
+    }
+
+    size_t pos = 0;
+    while (status == SUCCESS) {
+      size_t off = find_word(buffer + pos, filled - pos, old_word, m);
+      if (off == filled - pos) {
+        break;
+      }
+      status = writer_span(&w, base + pos, buffer + pos, off);
+      if (status == SUCCESS) {
+        status = writer_add(&w, new_word, r);
+      }
+      if (status == SUCCESS) {
+        stats->replacements++;
+      }
+      pos += off + m;
+    }
+
+    size_t end = (pos > safe) ? pos : safe;
+    if (status == SUCCESS) {
+      status = writer_span(&w, base + pos, buffer + pos, end - pos);
+    }
+    // The iovecs point into the buffer: flush before it is reused
+    if (status == SUCCESS) {
+      status = writer_flush(&w);
+    }
+
+    carry = filled - end;
+    memmove(buffer, buffer + end, carry);
+    base += (long long)end;
+  }
+
+  free(buffer);
+  return status;
+}
+
+ssize_t read_full(int fd, char *buffer, size_t len) {
+  size_t total = 0;
+
+  while (total < len) {
+    ssize_t n = read(fd, buffer + total, len - total);
+    if (n == 0) {
+      break;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    total += (size_t)n;
+  }
+  return (ssize_t)total;
+}
+
+Status writer_add(ReplaceWriter *w, const char *data, size_t len) {
+  if (len == 0) {
+    return SUCCESS;
+  }
+  if (w->count == IOV_BATCH && writer_flush(w) != SUCCESS) {
+    return ERR_FILE_IO;
+  }
+  w->iov[w->count].iov_base = (void *)data;
+  w->iov[w->count].iov_len = len;
+  w->count++;
+  return SUCCESS;
+}
+
+Status writer_span(ReplaceWriter *w, long long offset, const char *data,
+                   size_t len) {
+  if (len < COPY_RANGE_MIN || !w->copy_range) {
+    return writer_add(w, data, len);
+  }
+
+  // Long unchanged span: let the kernel copy it from the input file
+  if (writer_flush(w) != SUCCESS) {
+    return ERR_FILE_IO;
+  }
+  loff_t in_off = (loff_t)offset;
+  size_t done = 0;
+  while (done < len) {
+    ssize_t n = copy_file_range(w->in_fd, &in_off, w->out_fd, NULL,
+                                len - done, 0);
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      // Not supported here (old kernel, pipe, cross-device): writev
+      w->copy_range = FALSE;
+      return writer_add(w, data + done, len - done);
+    }
+    done += (size_t)n;
+    w->stats->copied += n;
+  }
+  return SUCCESS;
+}
+
+Status writer_flush(ReplaceWriter *w) {
+  struct iovec *iov = w->iov;
+  int count = w->count;
+
+  while (count > 0) {
+    ssize_t n = writev(w->out_fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ERR_FILE_IO;
+    }
+    w->stats->written += n;
+
+    // Partial write: drop the iovecs fully written, trim the next one
+    while (count > 0 && (size_t)n >= iov->iov_len) {
+      n -= (ssize_t)iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= (size_t)n;
+    }
+  }
+  w->count = 0;
+  return SUCCESS;
 }
 
 void run_statistics(void) {
-  FILE *file = fopen(FILENAME, "r");
-  if (!file) {
-    handle_error(ERR_FILE_NOT_FOUND);
+  TextCounts counts;
+
+  Status status = count_blocks(FILENAME, &counts);
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
 
-  int chars = 0, words = 0, lines = 0;
-  char ch, prev_ch = ' ';
+  long long lines = total_lines(&counts);
+  printf("\n=== Statistics for '%s' ===\n", FILENAME);
+  printf("  - Total Characters: %lld\n", counts.chars);
+  printf("  - Total Words:      %lld\n", counts.words);
+  printf("  - Total Lines:      %lld\n", lines);
+
+  if (lines > 0) {
+    printf("  - Avg Words/Line:   %.2f\n", (double)counts.words / lines);
+  }
+  printf("\n");
+}
+
+void count_stdio(FILE *file, TextCounts *counts) {
+  long long chars = 0, words = 0, lines = 0;
+  int ch, prev_ch = ' ';
 
   while ((ch = fgetc(file)) != EOF) {
     chars++;
@@ -343,21 +753,735 @@ void run_statistics(void) {
   if (chars > 0 && !isspace(prev_ch)) {
     words++;
   }
-  if (chars > 0 && prev_ch != '\n') {
-    lines++;
+
+  memset(counts, 0, sizeof(*counts));
+  counts->chars = chars;
+  counts->words = words;
+  counts->newlines = lines;
+  counts->ends_newline = (prev_ch == '\n');
+}
+
+Status count_blocks(const char *path, TextCounts *counts) {
+  char *buffer = NULL;
+  TextCounts part;
+
+  memset(counts, 0, sizeof(*counts));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  if (posix_memalign((void **)&buffer, BUFFER_ALIGN, REPLACE_BUFFER) != 0) {
+    close(fd);
+    return ERR_MEMORY_ALLOCATION;
   }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
 
-  printf("\n=== Statistics for '%s' ===\n", FILENAME);
-  printf("  - Total Characters: %d\n", chars);
-  printf("  - Total Words:      %d\n", words);
-  printf("  - Total Lines:      %d\n", lines);
+  // Each block is counted on its own; merging fixes words split across
+  ssize_t n;
+  while ((n = read_full(fd, buffer, REPLACE_BUFFER)) > 0) {
+    count_text(buffer, (size_t)n, &part);
+    merge_counts(counts, &part);
+  }
 
-  if (lines > 0) {
-    printf("  - Avg Words/Line:   %.2f\n", (double)words / lines);
+  free(buffer);
+  close(fd);
+  return (n < 0) ? ERR_FILE_IO : SUCCESS;
+}
+
+Status count_parallel(const char *path, TextCounts *counts) {
+  pthread_t threads[MAX_THREADS];
+  CountJob jobs[MAX_THREADS];
+  int running[MAX_THREADS] = {FALSE};
+  size_t size = 0;
+
+  memset(counts, 0, sizeof(*counts));
+  const char *data = map_file(path, &size);
+  if (data == NULL) {
+    return ERR_FILE_NOT_FOUND;
+  }
+
+  int num_threads = online_cpus();
+  if (num_threads > MAX_THREADS) {
+    num_threads = MAX_THREADS;
+  }
+
+  // Cuts can land anywhere, even inside a word: the merge handles it
+  for (int t = 0; t < num_threads; t++) {
+    jobs[t].data = data;
+    jobs[t].start = size / num_threads * t;
+    jobs[t].end = (t == num_threads - 1) ? size : size / num_threads * (t + 1);
+    running[t] =
+        t > 0 && pthread_create(&threads[t], NULL, count_worker, &jobs[t]) == 0;
+    if (t > 0 && !running[t]) {
+      count_worker(&jobs[t]);
+    }
+  }
+  count_worker(&jobs[0]);
+
+  for (int t = 0; t < num_threads; t++) {
+    if (running[t]) {
+      pthread_join(threads[t], NULL);
+    }
+    merge_counts(counts, &jobs[t].counts);
+  }
+
+  if (size > 0) {
+    munmap((void *)data, size);
+  }
+  return SUCCESS;
+}
+
+void *count_worker(void *arg) {
+  CountJob *job = (CountJob *)arg;
+  count_text(job->data + job->start, job->end - job->start, &job->counts);
+  return NULL;
+}
+
+void count_text(const char *p, size_t n, TextCounts *counts) {
+  unsigned in_word = 0; // Previous byte was not whitespace
+  size_t i = 0;
+
+  memset(counts, 0, sizeof(*counts));
+  counts->chars = (long long)n;
+  if (n == 0) {
+    return;
+  }
+
+#ifdef __x86_64__
+  if (use_avx2) {
+    i = count_text_avx2(p, n, counts, &in_word);
+  } else {
+    // Whitespace = ' ' or '\t'..'\r': (byte - 9) <= 4 as unsigned
+    __m128i space = _mm_set1_epi8(' ');
+    __m128i tab = _mm_set1_epi8('\t');
+    __m128i four = _mm_set1_epi8(4);
+    __m128i nl = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+      __m128i ctl = _mm_sub_epi8(v, tab);
+      __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, space),
+                                _mm_cmpeq_epi8(_mm_min_epu8(ctl, four), ctl));
+      unsigned word = ~(unsigned)_mm_movemask_epi8(ws) & 0xFFFFu;
+
+      // A word starts where a non-space byte follows a space byte
+      unsigned starts = word & ~((word << 1) | in_word);
+      counts->words += __builtin_popcount(starts);
+      counts->newlines += __builtin_popcount(
+          (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+      in_word = (word >> 15) & 1u;
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    unsigned char c = (unsigned char)p[i];
+    unsigned word = !(c == ' ' || (unsigned char)(c - '\t') <= 4);
+    counts->words += word & ~in_word;
+    counts->newlines += (c == '\n');
+    in_word = word;
+  }
+
+  unsigned char first = (unsigned char)p[0];
+  counts->starts_in_word =
+      !(first == ' ' || (unsigned char)(first - '\t') <= 4);
+  counts->ends_in_word = (int)in_word;
+  counts->ends_newline = (p[n - 1] == '\n');
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) size_t
+count_text_avx2(const char *p, size_t n, TextCounts *counts,
+                unsigned *in_word) {
+  __m256i space = _mm256_set1_epi8(' ');
+  __m256i tab = _mm256_set1_epi8('\t');
+  __m256i four = _mm256_set1_epi8(4);
+  __m256i nl = _mm256_set1_epi8('\n');
+  unsigned prev = *in_word;
+  long long words = 0;
+  long long newlines = 0;
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+    __m256i ctl = _mm256_sub_epi8(v, tab);
+    __m256i ws =
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, space),
+                        _mm256_cmpeq_epi8(_mm256_min_epu8(ctl, four), ctl));
+    unsigned word = ~(unsigned)_mm256_movemask_epi8(ws);
+
+    unsigned starts = word & ~((word << 1) | prev);
+    words += __builtin_popcount(starts);
+    newlines += __builtin_popcount(
+        (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+    prev = word >> 31;
+  }
+
+  counts->words += words;
+  counts->newlines += newlines;
+  *in_word = prev;
+  return i;
+}
+#endif
+
+void merge_counts(TextCounts *total, const TextCounts *part) {
+  if (part->chars == 0) {
+    return;
+  }
+  // A word cut in two by the chunk boundary was counted by both sides
+  if (total->chars > 0 && total->ends_in_word && part->starts_in_word) {
+    total->words--;
+  }
+  if (total->chars == 0) {
+    total->starts_in_word = part->starts_in_word;
+  }
+  total->chars += part->chars;
+  total->words += part->words;
+  total->newlines += part->newlines;
+  total->ends_in_word = part->ends_in_word;
+  total->ends_newline = part->ends_newline;
+}
+
+long long total_lines(const TextCounts *counts) {
+  // A last line without '\n' still counts
+  if (counts->chars > 0 && !counts->ends_newline) {
+    return counts->newlines + 1;
+  }
+  return counts->newlines;
+}
+
+void run_parallel_search(void) {
+  char path[MAX_PATH];
+  char word[256];
+  pthread_t threads[MAX_THREADS];
+  SearchJob jobs[MAX_THREADS];
+  size_t size = 0;
+
+  printf("\nEnter file path (leave empty for default '%s'): ", FILENAME);
+  if (read_path(path, sizeof(path), FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter word to search for: ");
+  if (read_string(word, sizeof(word)) != SUCCESS || strlen(word) == 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  // Same file through read() into one buffer: the cat > /dev/null floor
+  double cat_time = cat_baseline(path);
+
+  // Mapping is part of the cost (page tables), so it is timed too
+  double start = now_seconds();
+  const char *data = map_file(path, &size);
+  if (data == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+
+  int num_threads = online_cpus();
+  if (num_threads > MAX_THREADS) {
+    num_threads = MAX_THREADS;
+  }
+
+  size_t chunk_start = 0;
+  int running[MAX_THREADS] = {FALSE};
+  for (int t = 0; t < num_threads; t++) {
+    // Move every cut forward past the next '\n' so no line is split
+    size_t end = (t == num_threads - 1) ? size : size / num_threads * (t + 1);
+    if (end < chunk_start) {
+      end = chunk_start;
+    }
+    if (end < size) {
+      const char *nl = memchr(data + end, '\n', size - end);
+      end = (nl != NULL) ? (size_t)(nl - data) + 1 : size;
+    }
+
+    SearchJob *job = &jobs[t];
+    memset(job, 0, sizeof(*job));
+    job->data = data;
+    job->start = chunk_start;
+    job->end = end;
+    job->word = word;
+    job->word_len = strlen(word);
+    chunk_start = end;
+
+    // Chunk 0 runs on the calling thread, as does any failed spawn
+    running[t] =
+        t > 0 && pthread_create(&threads[t], NULL, search_worker, job) == 0;
+    if (t > 0 && !running[t]) {
+      search_worker(job);
+    }
+  }
+  search_worker(&jobs[0]);
+  for (int t = 1; t < num_threads; t++) {
+    if (running[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+  double elapsed = now_seconds() - start;
+
+  printf("\n=== Parallel Search for \"%s\" in '%s' ===\n", word, path);
+  long occurrences = 0;
+  long matched_lines = 0;
+  long lines_before = 0;
+  int shown = 0;
+  for (int t = 0; t < num_threads; t++) {
+    for (int h = 0; h < jobs[t].reported && shown < MAX_REPORTED; h++) {
+      print_line_hit(data, size, jobs[t].hits[h].offset,
+                     lines_before + jobs[t].hits[h].line + 1);
+      shown++;
+    }
+    occurrences += jobs[t].occurrences;
+    matched_lines += jobs[t].matched_lines;
+    lines_before += jobs[t].newlines;
+  }
+  if (matched_lines > shown) {
+    printf("    ... (%ld more lines)\n", matched_lines - shown);
+  }
+  if (size > 0 && data[size - 1] != '\n') {
+    lines_before++;
+  }
+
+  printf("\n  - Total occurrences: %ld\n", occurrences);
+  printf("  - Matching lines:    %ld of %ld\n", matched_lines, lines_before);
+  printf("  - Threads:           %d (%s kernel)\n", num_threads,
+         use_avx2 ? "AVX2" : "SSE2");
+  printf("  - Search time:       %.3f s (%.1f MB/s)\n", elapsed,
+         elapsed > 0.0 ? (double)size / MB / elapsed : 0.0);
+  if (cat_time > 0.0) {
+    printf("  - read() baseline:   %.3f s (%.1f MB/s), %.2fx\n", cat_time,
+           (double)size / MB / cat_time, elapsed / cat_time);
+  }
+  printf("\n");
+
+  if (size > 0) {
+    munmap((void *)data, size);
+  }
+}
+
+void *search_worker(void *arg) {
+  SearchJob *job = (SearchJob *)arg;
+  const char *data = job->data;
+  size_t pos = job->start;
+  size_t counted = job->start; // Newlines before this are in job->newlines
+  long last_line = -1;
+
+  while (pos < job->end) {
+    size_t off = find_word(data + pos, job->end - pos, job->word,
+                           job->word_len);
+    if (off == job->end - pos) {
+      break;
+    }
+
+    size_t match = pos + off;
+    job->newlines += (long)count_newlines(data + counted, match - counted);
+    counted = match;
+    job->occurrences++;
+
+    if (job->newlines != last_line) {
+      last_line = job->newlines;
+      job->matched_lines++;
+      if (job->reported < MAX_REPORTED) {
+        const char *nl = memrchr(data + job->start, '\n', match - job->start);
+        job->hits[job->reported].line = job->newlines;
+        job->hits[job->reported].offset =
+            (nl != NULL) ? (size_t)(nl - data) + 1 : job->start;
+        job->reported++;
+      }
+    }
+    // Non-overlapping, like the strstr() loop of the line-based search
+    pos = match + job->word_len;
+  }
+
+  job->newlines += (long)count_newlines(data + counted, job->end - counted);
+  return NULL;
+}
+
+void print_line_hit(const char *data, size_t size, size_t offset, long line) {
+  const char *nl = memchr(data + offset, '\n', size - offset);
+  size_t len = (nl != NULL) ? (size_t)(nl - data) - offset : size - offset;
+
+  if (len > LINE_PREVIEW) {
+    printf("  - Line %ld: %.*s... (%zu bytes)\n", line, LINE_PREVIEW,
+           data + offset, len);
+  } else {
+    printf("  - Line %ld: %.*s\n", line, (int)len, data + offset);
+  }
+}
+
+const char *map_file(const char *path, size_t *size) {
+  struct stat st;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+
+  *size = (size_t)st.st_size;
+  if (*size == 0) {
+    close(fd);
+    return ""; // Nothing to map; callers skip munmap for size 0
+  }
+
+  // MAP_POPULATE maps the cached pages in one go instead of one fault
+  // per 4 KB page as the threads walk the file
+  void *data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return NULL;
+  }
+  madvise(data, *size, MADV_SEQUENTIAL);
+  return (const char *)data;
+}
+
+size_t find_word(const char *hay, size_t n, const char *word, size_t m) {
+  if (m > n) {
+    return n;
+  }
+#ifdef __x86_64__
+  if (use_avx2) {
+    return find_word_avx2(hay, n, word, m);
+  }
+
+  // SSE2 (always present on x86_64): 16 first/last-byte candidates a step
+  __m128i first = _mm_set1_epi8(word[0]);
+  __m128i last = _mm_set1_epi8(word[m - 1]);
+  size_t i = 0;
+  for (; i + m + 15 <= n; i += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(hay + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(hay + i + m - 1));
+    unsigned mask = (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, a), _mm_cmpeq_epi8(last, b)));
+    while (mask != 0) {
+      size_t pos = i + __builtin_ctz(mask);
+      if (m < 3 || memcmp(hay + pos + 1, word + 1, m - 2) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  size_t tail = find_word_scalar(hay + i, n - i, word, m);
+  return (tail == n - i) ? n : i + tail;
+#else
+  return find_word_scalar(hay, n, word, m);
+#endif
+}
+
+size_t find_word_scalar(const char *hay, size_t n, const char *word,
+                        size_t m) {
+  for (size_t i = 0; i + m <= n; i++) {
+    if (hay[i] == word[0] && memcmp(hay + i, word, m) == 0) {
+      return i;
+    }
+  }
+  return n;
+}
+
+size_t count_newlines(const char *p, size_t n) {
+  size_t count = 0;
+  size_t i = 0;
+
+#ifdef __x86_64__
+  if (use_avx2) {
+    return count_newlines_avx2(p, n);
+  }
+
+  __m128i nl = _mm_set1_epi8('\n');
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+    count += __builtin_popcount(
+        (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+  }
+#endif
+  for (; i < n; i++) {
+    count += (p[i] == '\n');
+  }
+  return count;
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) size_t
+find_word_avx2(const char *hay, size_t n, const char *word, size_t m) {
+  __m256i first = _mm256_set1_epi8(word[0]);
+  __m256i last = _mm256_set1_epi8(word[m - 1]);
+  size_t i = 0;
+
+  for (; i + m + 31 <= n; i += 32) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(hay + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(hay + i + m - 1));
+    unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(first, a), _mm256_cmpeq_epi8(last, b)));
+    while (mask != 0) {
+      size_t pos = i + __builtin_ctz(mask);
+      if (m < 3 || memcmp(hay + pos + 1, word + 1, m - 2) == 0) {
+        return pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  size_t tail = find_word_scalar(hay + i, n - i, word, m);
+  return (tail == n - i) ? n : i + tail;
+}
+
+__attribute__((target("avx2"))) size_t count_newlines_avx2(const char *p,
+                                                           size_t n) {
+  __m256i nl = _mm256_set1_epi8('\n');
+  size_t count = 0;
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+    count += __builtin_popcount(
+        (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+  }
+  for (; i < n; i++) {
+    count += (p[i] == '\n');
+  }
+  return count;
+}
+#endif
+
+double cat_baseline(const char *path) {
+  char *buffer = (char *)malloc(IO_BUFFER);
+  int fd = open(path, O_RDONLY);
+  if (buffer == NULL || fd < 0) {
+    free(buffer);
+    if (fd >= 0) {
+      close(fd);
+    }
+    return 0.0;
+  }
+
+  double start = now_seconds();
+  while (read(fd, buffer, IO_BUFFER) > 0) {
+    ;
+  }
+  double elapsed = now_seconds() - start;
+
+  close(fd);
+  free(buffer);
+  return elapsed;
+}
+
+void run_generate_file(void) {
+  static const char *words[] = {"the",  "quick", "brown",  "fox",
+                                "jumps", "over", "lazy",   "dog",
+                                "error", "warn", "kernel", "C",
+                                "file",  "data", "search", "line"};
+  const int num_words = (int)(sizeof(words) / sizeof(words[0]));
+  char path[MAX_PATH];
+  int size_mb = 0;
+
+  printf("\nEnter file path (leave empty for default '%s'): ",
+         BIG_FILENAME);
+  if (read_path(path, sizeof(path), BIG_FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter size in MB (e.g., 1024): ");
+  if (read_integer(&size_mb) != SUCCESS || size_mb <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  FILE *file = fopen(path, "w");
+  char *buffer = (char *)malloc(IO_BUFFER + MAX_LINE * 8);
+  if (file == NULL || buffer == NULL) {
+    if (file != NULL) {
+      fclose(file);
+    }
+    free(buffer);
+    handle_error(buffer == NULL ? ERR_MEMORY_ALLOCATION
+                                : ERR_FILE_CREATE_FAILED);
+    return;
+  }
+
+  long long target = (long long)size_mb * MB;
+  long long written = 0;
+  long lines = 0;
+  double start = now_seconds();
+  while (written < target) {
+    size_t used = 0;
+    while (used < IO_BUFFER) {
+      // Mostly short lines, with an occasional very long one
+      int count = (rand() % 1000 == 0) ? 1000 : 3 + rand() % 12;
+      for (int w = 0; w < count; w++) {
+        const char *word = words[rand() % num_words];
+        size_t len = strlen(word);
+        memcpy(buffer + used, word, len);
+        used += len;
+        buffer[used++] = (w == count - 1) ? '\n' : ' ';
+      }
+      lines++;
+    }
+    if ((long long)used > target - written) {
+      used = (size_t)(target - written);
+    }
+    if (fwrite(buffer, 1, used, file) != used) {
+      break;
+    }
+    written += (long long)used;
+  }
+
+  fclose(file);
+  free(buffer);
+  printf("\n  - Wrote %lld bytes (~%ld lines) to '%s' in %.2f s\n\n",
+         written, lines, path, now_seconds() - start);
+}
+
+void run_replace_benchmark(void) {
+  char path[MAX_PATH];
+  char out_path[MAX_PATH + 32];
+  char old_word[256], new_word[256];
+  ReplaceStats stats;
+
+  printf("\nEnter file path (leave empty for default '%s'): ",
+         BIG_FILENAME);
+  if (read_path(path, sizeof(path), BIG_FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter word to replace: ");
+  if (read_string(old_word, sizeof(old_word)) != SUCCESS ||
+      strlen(old_word) == 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  printf("Enter new word: ");
+  if (read_string(new_word, sizeof(new_word)) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  // Outputs go next to the input and are removed; the input is untouched
+  snprintf(out_path, sizeof(out_path), "%s.bench.out", path);
+
+  FILE *in = fopen(path, "r");
+  FILE *out = fopen(out_path, "w");
+  if (in == NULL || out == NULL) {
+    if (in != NULL) {
+      fclose(in);
+    }
+    if (out != NULL) {
+      fclose(out);
+    }
+    handle_error(in == NULL ? ERR_FILE_NOT_FOUND : ERR_FILE_CREATE_FAILED);
+    return;
+  }
+  double start = now_seconds();
+  long stdio_count = replace_stdio(in, out, old_word, new_word);
+  fflush(out);
+  fsync(fileno(out));
+  double stdio_time = now_seconds() - start;
+  fclose(in);
+  fclose(out);
+
+  int in_fd = open(path, O_RDONLY);
+  int out_fd = open(out_path, O_WRONLY | O_TRUNC);
+  if (in_fd < 0 || out_fd < 0) {
+    if (in_fd >= 0) {
+      close(in_fd);
+    }
+    if (out_fd >= 0) {
+      close(out_fd);
+    }
+    unlink(out_path);
+    handle_error(ERR_FILE_IO);
+    return;
+  }
+  start = now_seconds();
+  Status status = replace_stream(in_fd, out_fd, old_word, new_word, &stats);
+  fsync(out_fd);
+  double stream_time = now_seconds() - start;
+  close(in_fd);
+  close(out_fd);
+  unlink(out_path);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  double mb = (double)stats.bytes_in / MB;
+  printf("\n=== Replace \"%s\" -> \"%s\" in '%s' (%.1f MB) ===\n\n",
+         old_word, new_word, path, mb);
+  printf("%-18s | %-9s | %-9s | %s\n", "Engine", "Time (s)", "MB/s",
+         "Replacements");
+  printf("-------------------|-----------|-----------|-------------\n");
+  printf("%-18s | %9.3f | %9.1f | %ld\n", "stdio (fgets)", stdio_time,
+         stdio_time > 0.0 ? mb / stdio_time : 0.0, stdio_count);
+  printf("%-18s | %9.3f | %9.1f | %lld\n", "streaming", stream_time,
+         stream_time > 0.0 ? mb / stream_time : 0.0, stats.replacements);
+  printf("\n  - writev():          %lld bytes\n", stats.written);
+  printf("  - copy_file_range(): %lld bytes\n", stats.copied);
+  if (stats.replacements != stdio_count) {
+    printf("  - stdio missed %lld matches split across %d-byte reads\n",
+           stats.replacements - stdio_count, MAX_LINE);
   }
   printf("\n");
+}
+
+void run_statistics_benchmark(void) {
+  static const char *modes[] = {"fgetc", "SIMD blocks", "threads (mmap)"};
+  char path[MAX_PATH];
+  TextCounts counts[3];
+  double times[3];
+
+  printf("\nEnter file path (leave empty for default '%s'): ",
+         BIG_FILENAME);
+  if (read_path(path, sizeof(path), BIG_FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
 
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+  double start = now_seconds();
+  count_stdio(file, &counts[0]);
+  times[0] = now_seconds() - start;
   fclose(file);
+
+  start = now_seconds();
+  Status status = count_blocks(path, &counts[1]);
+  times[1] = now_seconds() - start;
+  if (status == SUCCESS) {
+    start = now_seconds();
+    status = count_parallel(path, &counts[2]);
+    times[2] = now_seconds() - start;
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  double mb = (double)counts[0].chars / MB;
+  printf("\n=== Statistics Benchmark: '%s' (%.1f MB, %d threads, %s) ===\n\n",
+         path, mb, online_cpus() < MAX_THREADS ? online_cpus() : MAX_THREADS,
+         use_avx2 ? "AVX2" : "SSE2");
+  printf("%-15s | %-9s | %-9s | %-12s | %-12s | %s\n", "Mode", "Time (s)",
+         "MB/s", "Lines", "Words", "Chars");
+  printf("----------------|-----------|-----------|--------------|"
+         "--------------|-------------\n");
+  for (int i = 0; i < 3; i++) {
+    int same = counts[i].words == counts[0].words &&
+               counts[i].chars == counts[0].chars &&
+               total_lines(&counts[i]) == total_lines(&counts[0]);
+    printf("%-15s | %9.3f | %9.1f | %-12lld | %-12lld | %lld%s\n", modes[i],
+           times[i], times[i] > 0.0 ? mb / times[i] : 0.0,
+           total_lines(&counts[i]), counts[i].words, counts[i].chars,
+           same ? "" : " MISMATCH");
+  }
+  printf("\n");
 }
 
 void clear_input_buffer(void) {
@@ -389,6 +1513,27 @@ Status read_string(char *buffer, int max_len) {
   return SUCCESS;
 }
 
+Status read_path(char *path, int max_len, const char *fallback) {
+  if (read_string(path, max_len) != SUCCESS) {
+    return ERR_INVALID_INPUT;
+  }
+  if (strlen(path) == 0) {
+    strcpy(path, fallback);
+  }
+  return SUCCESS;
+}
+
+double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int online_cpus(void) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return (cpus > 0) ? (int)cpus : 1;
+}
+
 void create_dummy_file(void) {
   FILE *check = fopen(FILENAME, "r");
   if (check) {
@@ -5,24 +5,76 @@
  Platform: GNU/Linux (Arch/WSL) on x86_64
  ===============================================================================
  Features:
- - Binary File I/O (rb, wb, ab, r+b)
+ - Memory-mapped record store: the data file is mapped MAP_SHARED and slot
+   i is records[i]; no fopen/fread/fseek per access
+ - Growth with ftruncate() + mremap() (mapping capacity doubles, the file
+   stays exactly count * 32 bytes) and madvise() hints (random for
+   lookups, sequential for scans)
+ - Write-ahead log (estudiantes.wal): every change is appended as a
+   checksummed after-image and made durable with fdatasync() before the
+   mapping is touched; replayed at startup after a crash
+ - Group commit: a batch of changes shares one write() and one
+   fdatasync(); checkpoints (msync() of the data file, then truncating the
+   log) bound the log size and the replay time
+ - Typed record iterator over live records: listing, statistics, index
+   rebuilds and compaction all run at memory speed
  - Fixed-size record structures (Exactly 32 bytes)
- - Direct access using fseek() and ftell()
- - Data statistics calculation directly from binary stream
- - Fully implemented Delete operation using temp file
+ - O(1) deletes: the record becomes a tombstone (id = INT_MIN) linked into
+   a free-slot list that Create reuses before growing the file
+ - Compaction (explicit, or automatic once half the slots are free):
+   live records copied to a temp file, fsync()ed and renamed over the data
+   file, so a crash leaves either the old or the new file
+ - B+-tree index on Student.id (estudiantes.idx): 4 KB nodes, leaves
+   chained for range scans, pages cached in an LRU buffer pool; lookups,
+   updates and duplicate checks take O(log n) page reads instead of a scan
+ - Index kept consistent with the data file: the meta page records the
+   data file's size and mtime, and a mismatch triggers a bulk rebuild
+ - Random record generator and lookup benchmark (index vs full scan)
+ - Batch GPA update benchmark: one fdatasync() per update vs group commit
  ===============================================================================
 */
 
+#define _GNU_SOURCE // mremap, pread/pwrite, st_mtim
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #define FILENAME "estudiantes.dat"
 #define TEMP_FILENAME "estudiantes_tmp.dat"
+#define INDEX_FILENAME "estudiantes.idx"
+#define WAL_FILENAME "estudiantes.wal"
+#define WAL_MAGIC "STUWAL1" // 8 bytes with the NUL
+#define WAL_VERSION 1
+#define WAL_GROUP_RECORDS 4096 // Changes per write() + fdatasync()
+#define WAL_CHECKPOINT_BYTES (8 << 20) // Log size that forces a checkpoint
+#define SYNC_EACH_LIMIT 1000 // Updates timed with one fdatasync() each
+#define INDEX_MAGIC "STUBPT1" // 8 bytes with the NUL
+#define INDEX_VERSION 3
+#define PAGE_BYTES 4096
+#define LEAF_KEYS 510  // (PAGE_BYTES - 16) / (4-byte key + 4-byte slot)
+#define INNER_KEYS 509 // Keys plus one more child fit in the same page
+#define BULK_FILL 90   // Percent of each node filled by a rebuild
+#define POOL_FRAMES 256
+#define NO_PAGE 0 // Page 0 is the meta page, never a node
+#define IO_RECORDS 4096
+#define STORE_MIN_SLOTS 1024 // Smallest mapping, in records
+#define LOOKUP_PROBES 1000
+#define MAX_HEIGHT 32 // Deeper than any real tree: a cycle means corruption
+#define TOMBSTONE_ID INT_MIN // Deleted record; 'edad' links the free list
+#define FREE_END 0xffffffffu
+#define COMPACT_MIN_SLOTS 64 // Automatic compaction threshold
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 7
+#define MAX_OPTION 11
 
 typedef enum {
   SUCCESS,
@@ -30,7 +82,12 @@ typedef enum {
   ERR_INVALID_OPTION,
   ERR_FILE_NOT_FOUND,
   ERR_FILE_CREATE_FAILED,
-  ERR_RECORD_NOT_FOUND
+  ERR_RECORD_NOT_FOUND,
+  ERR_DUPLICATE_ID,
+  ERR_INDEX_IO,
+  ERR_MEMORY_ALLOCATION,
+  ERR_MAP_FAILED,
+  ERR_WAL_IO
 } Status;
 
 /*
@@ -46,25 +103,217 @@ typedef struct {
   int edad;
   float promedio;
 } Student;
+
+// One log entry: the full new contents of a slot (redo only). Entries are
+// valid while 'lsn' counts up from the header's start_lsn and the
+// checksum matches; the first one that does not is a torn tail.
+typedef struct {
+  uint64_t lsn;
+  uint32_t slot;
+  uint32_t checksum; // FNV-1a over the other fields
+  Student after;
+} LogRecord;
 #pragma pack(pop)
 
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t start_lsn; // LSN of the first entry after the last checkpoint
+  uint64_t data_ino;  // The log only applies to this data file
+} WalHeader;
+
+typedef struct {
+  int fd;
+  WalHeader header;
+  uint64_t next_lsn;
+  off_t size;         // Bytes of the log file holding valid entries
+  LogRecord *pending; // Logged but not yet written and synced
+  size_t count;
+  uint32_t end;       // Slots including pending appends
+  long syncs;
+  uint64_t recovered; // Entries replayed at startup
+  int broken;         // A failed group left a gap: no appends until a
+                      // checkpoint succeeds
+} WriteAheadLog;
+
+typedef struct {
+  int fd;
+  Student *records; // Slot i is records[i]
+  size_t count;     // Slots in the file, tombstones included
+  size_t capacity;  // Slots mapped; only [0, count) is backed by the file
+  uint64_t ino;
+} RecordStore;
+
+typedef struct {
+  const RecordStore *store;
+  size_t next;
+} RecordIterator;
+
+// Page 0 of the index file
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t page_bytes;
+  uint32_t root;
+  uint32_t num_pages;
+  uint64_t keys;
+  uint64_t data_size; // Data file this index describes
+  int64_t data_mtime_sec;
+  int64_t data_mtime_nsec;
+  uint64_t free_slots; // Tombstones in the data file
+  uint32_t free_head;  // Most recent tombstone, FREE_END if none
+  uint32_t dirty;      // Pages written since the last commit: rebuild
+  uint64_t wal_lsn; // Log position the data file was at when committed
+} IndexMeta;
+
+// One 4 KB page. Inner nodes: children[i] holds keys in
+// [keys[i - 1], keys[i]). Leaves map each key to a record slot.
+typedef struct {
+  uint32_t is_leaf;
+  uint32_t count;
+  uint32_t next; // Right sibling leaf, NO_PAGE for the last one
+  uint32_t reserved;
+  union {
+    struct {
+      int32_t keys[LEAF_KEYS];
+      uint32_t slots[LEAF_KEYS];
+    } leaf;
+    struct {
+      int32_t keys[INNER_KEYS];
+      uint32_t children[INNER_KEYS + 1];
+    } inner;
+  } u;
+} BNode;
+
+typedef struct {
+  BNode node; // First member: a node pointer is also its frame pointer
+  uint32_t page;
+  int dirty;
+  int pins;
+  uint64_t last_used;
+} Frame;
+
+typedef struct {
+  int fd;
+  IndexMeta meta;
+  Frame *frames;
+  uint64_t clock;
+  uint64_t lsn; // Log position the data file is at now
+  long hits;    // Buffer pool statistics
+  long misses;
+} BTree;
+
+typedef struct {
+  BTree *tree;
+  uint32_t page;
+  uint32_t pos;
+} IndexCursor;
+
+typedef struct {
+  int32_t key;
+  uint32_t slot;
+} KeySlot;
+
+typedef struct {
+  RecordStore store;
+  WriteAheadLog wal;
+  BTree index;
+} StudentDb;
+
 void show_menu(void);
 void handle_error(Status status);
 
-void run_create_record(void);
-void run_read_all_records(void);
-void run_search_record(void);
-void run_update_record(void);
-void run_delete_record(void);
-void run_show_statistics(void);
+void run_create_record(StudentDb *db);
+void run_read_all_records(StudentDb *db);
+void run_search_record(StudentDb *db);
+void run_update_record(StudentDb *db);
+void run_delete_record(StudentDb *db);
+void run_show_statistics(StudentDb *db);
+void run_range_scan(StudentDb *db);
+void run_generate_records(StudentDb *db);
+void run_compact(StudentDb *db);
+void run_batch_update(StudentDb *db);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 Status read_float(float *value);
 Status read_string(char *buffer, int max_len);
+double now_seconds(void);
+int sample_ids(BTree *tree, int *ids, int count);
+
+Status db_open(StudentDb *db);
+void db_close(StudentDb *db);
+Status db_sync(StudentDb *db);
+Status db_commit(StudentDb *db);
+Status db_rollback(StudentDb *db);
+Status db_find(StudentDb *db, int id, uint32_t *slot);
+Status db_log(StudentDb *db, uint32_t slot, const Student *s);
+Status store_record(StudentDb *db, const Student *s, uint32_t *slot);
+Status delete_slot(StudentDb *db, uint32_t slot);
+Status compact_data(StudentDb *db, uint64_t *reclaimed);
+
+Status store_open(RecordStore *store);
+void store_close(RecordStore *store);
+Status store_refresh(RecordStore *store);
+Status store_resize(RecordStore *store, size_t count);
+Student *store_get(const RecordStore *store, uint32_t slot);
+void store_touch(RecordStore *store);
+void store_stat(const RecordStore *store, uint64_t *size, int64_t *sec,
+                int64_t *nsec);
+void store_iter_begin(RecordIterator *it, const RecordStore *store);
+const Student *store_iter_next(RecordIterator *it, uint32_t *slot);
+
+Status wal_open(WriteAheadLog *wal, RecordStore *store);
+void wal_close(WriteAheadLog *wal, RecordStore *store);
+Status wal_replay(WriteAheadLog *wal, RecordStore *store);
+Status wal_log(WriteAheadLog *wal, RecordStore *store, uint32_t slot,
+               const Student *s);
+Status wal_flush(WriteAheadLog *wal, RecordStore *store);
+void wal_discard(WriteAheadLog *wal, const RecordStore *store);
+Status wal_checkpoint(WriteAheadLog *wal, RecordStore *store);
+uint32_t wal_checksum(const LogRecord *record);
+
+Status index_open(BTree *tree, RecordStore *store, uint64_t lsn);
+void index_close(BTree *tree);
+Status index_sync(BTree *tree, RecordStore *store);
+Status index_commit(BTree *tree, const RecordStore *store);
+Status index_rebuild(BTree *tree, RecordStore *store);
+Status index_bulk_load(BTree *tree, KeySlot *pairs, uint64_t count);
+Status index_find(BTree *tree, int id, uint32_t *slot);
+Status index_insert(BTree *tree, int id, uint32_t slot);
+Status index_remove(BTree *tree, int id);
+Status index_insert_into(BTree *tree, uint32_t page, int id, uint32_t slot,
+                         int *split, int32_t *split_key,
+                         uint32_t *split_page);
+Status index_find_leaf(BTree *tree, int id, uint32_t *leaf);
+Status index_seek(IndexCursor *cursor, BTree *tree, int id);
+int index_next(IndexCursor *cursor, int *id, uint32_t *slot);
+uint32_t leaf_lower_bound(const BNode *node, int id);
+uint32_t inner_child(const BNode *node, int id);
+int compare_key_slots(const void *a, const void *b);
+
+BNode *pool_fetch(BTree *tree, uint32_t page);
+BNode *pool_new(BTree *tree, uint32_t *page, int is_leaf);
+void pool_release(BTree *tree, BNode *node, int dirty);
+Frame *pool_victim(BTree *tree);
+Status pool_mark(BTree *tree);
+Status pool_write_meta(BTree *tree);
+Status pool_flush(BTree *tree, int commit);
 
 int main(void) {
   int option = 0;
+  StudentDb db;
+
+  Status status = db_open(&db);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return 1;
+  }
+  if (db.wal.recovered > 0) {
+    printf("Recovered %llu committed changes from %s\n\n",
+           (unsigned long long)db.wal.recovered, WAL_FILENAME);
+  }
 
   while (TRUE) {
     show_menu();
@@ -86,26 +335,39 @@ int main(void) {
 
     switch (option) {
     case 1:
-      run_create_record();
+      run_create_record(&db);
       break;
     case 2:
-      run_read_all_records();
+      run_read_all_records(&db);
       break;
     case 3:
-      run_search_record();
+      run_search_record(&db);
       break;
     case 4:
-      run_update_record();
+      run_update_record(&db);
       break;
     case 5:
-      run_delete_record();
+      run_delete_record(&db);
       break;
     case 6:
-      run_show_statistics();
+      run_show_statistics(&db);
+      break;
+    case 7:
+      run_range_scan(&db);
+      break;
+    case 8:
+      run_generate_records(&db);
+      break;
+    case 9:
+      run_compact(&db);
+      break;
+    case 10:
+      run_batch_update(&db);
       break;
     }
   }
 
+  db_close(&db);
   return 0;
 }
 
@@ -118,7 +380,11 @@ void show_menu(void) {
   printf("4. Update Record\n");
   printf("5. Delete Record\n");
   printf("6. Statistics\n");
-  printf("7. Exit\n");
+  printf("7. Range Scan by ID\n");
+  printf("8. Generate Random Records\n");
+  printf("9. Compact Data File\n");
+  printf("10. Batch Update GPAs (group commit)\n");
+  printf("11. Exit\n");
   printf("Option: ");
 }
 
@@ -139,68 +405,104 @@ void handle_error(Status status) {
   case ERR_RECORD_NOT_FOUND:
     printf("Error: Record not found.\n\n");
     break;
+  case ERR_DUPLICATE_ID:
+    printf("Error: A record with this ID already exists.\n\n");
+    break;
+  case ERR_INDEX_IO:
+    printf("Error: Could not read or write the index file.\n\n");
+    break;
+  case ERR_MEMORY_ALLOCATION:
+    printf("Error: Memory allocation failed.\n\n");
+    break;
+  case ERR_MAP_FAILED:
+    printf("Error: Could not map or resize the data file.\n\n");
+    break;
+  case ERR_WAL_IO:
+    printf("Error: Could not write or sync the write-ahead log.\n\n");
+    break;
   case SUCCESS:
     break;
   }
 }
 
-void run_create_record(void) {
+void run_create_record(StudentDb *db) {
   Student s;
-  FILE *file = fopen(FILENAME, "ab");
-  if (!file) {
-    handle_error(ERR_FILE_CREATE_FAILED);
-    return;
-  }
 
   printf("\n--- Create New Record ---\n");
   printf("ID: ");
-  if (read_integer(&s.id) != SUCCESS) {
-    fclose(file);
+  if (read_integer(&s.id) != SUCCESS || s.id == TOMBSTONE_ID) {
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
+  // IDs are unique: the index answers without scanning the file. Only
+  // "not found" lets the record through; an index error is reported.
+  uint32_t existing;
+  Status status = db_sync(db);
+  if (status == SUCCESS) {
+    status = db_find(db, s.id, &existing);
+    if (status == SUCCESS) {
+      status = ERR_DUPLICATE_ID;
+    } else if (status == ERR_RECORD_NOT_FOUND) {
+      status = SUCCESS;
+    }
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
   printf("Name: ");
   if (read_string(s.nombre, sizeof(s.nombre)) != SUCCESS) {
-    fclose(file);
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
   printf("Age: ");
   if (read_integer(&s.edad) != SUCCESS) {
-    fclose(file);
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
   printf("GPA (Promedio): ");
   if (read_float(&s.promedio) != SUCCESS) {
-    fclose(file);
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
-  fwrite(&s, sizeof(Student), 1, file);
-  fclose(file);
+  uint32_t slot;
+  status = store_record(db, &s, &slot);
+  if (status == SUCCESS) {
+    status = index_insert(&db->index, s.id, slot);
+  }
+  if (status == SUCCESS) {
+    status = db_commit(db);
+  }
+  if (status != SUCCESS) {
+    db_rollback(db);
+    handle_error(status);
+    return;
+  }
 
-  printf("\n  - Record saved successfully to %s\n\n", FILENAME);
+  printf("\n  - Record saved successfully to %s (slot %u)\n\n", FILENAME,
+         slot);
 }
 
-void run_read_all_records(void) {
-  Student s;
-  FILE *file = fopen(FILENAME, "rb");
-  if (!file) {
+void run_read_all_records(StudentDb *db) {
+  if (db_sync(db) != SUCCESS) {
     handle_error(ERR_FILE_NOT_FOUND);
     return;
   }
 
   printf("\n--- All Records (%s) ---\n", FILENAME);
 
+  RecordIterator it;
+  const Student *s;
   int count = 0;
-  while (fread(&s, sizeof(Student), 1, file)) {
+  store_iter_begin(&it, &db->store);
+  while ((s = store_iter_next(&it, NULL)) != NULL) {
     printf("  [%d] ID: %-5d | Name: %-15s | Age: %-3d | GPA: %.1f\n", count + 1,
-           s.id, s.nombre, s.edad, s.promedio);
+           s->id, s->nombre, s->edad, s->promedio);
     count++;
   }
 
@@ -208,14 +510,11 @@ void run_read_all_records(void) {
     printf("  (No records found)\n");
   }
 
-  fseek(file, 0, SEEK_END);
-  long total_bytes = ftell(file);
-  fclose(file);
-
-  printf("\n  - Total: %d records (%ld bytes)\n\n", count, total_bytes);
+  printf("\n  - Total: %d records (%zu bytes, %zu deleted slots)\n\n", count,
+         db->store.count * sizeof(Student), db->store.count - (size_t)count);
 }
 
-void run_search_record(void) {
+void run_search_record(StudentDb *db) {
   int search_id;
   printf("\nEnter ID to search: ");
   if (read_integer(&search_id) != SUCCESS) {
@@ -223,38 +522,29 @@ void run_search_record(void) {
     return;
   }
 
-  Student s;
-  FILE *file = fopen(FILENAME, "rb");
-  if (!file) {
-    handle_error(ERR_FILE_NOT_FOUND);
-    return;
-  }
-
-  int found = 0;
-  long position = 0;
-
-  while (fread(&s, sizeof(Student), 1, file)) {
-    if (s.id == search_id) {
-      found = 1;
-      position = ftell(file) - sizeof(Student);
-      break;
-    }
+  uint32_t slot = 0;
+  long misses = db->index.misses;
+  long hits = db->index.hits;
+  Status status = db_sync(db);
+  if (status == SUCCESS) {
+    status = db_find(db, search_id, &slot);
   }
-
-  if (found) {
-    printf("\n=== Record Found ===\n");
-    printf("  - Name: %s\n", s.nombre);
-    printf("  - Age:  %d\n", s.edad);
-    printf("  - GPA:  %.1f\n", s.promedio);
-    printf("  - File Position: byte %ld\n\n", position);
-  } else {
-    handle_error(ERR_RECORD_NOT_FOUND);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
   }
 
-  fclose(file);
+  const Student *s = store_get(&db->store, slot);
+  printf("\n=== Record Found ===\n");
+  printf("  - Name: %s\n", s->nombre);
+  printf("  - Age:  %d\n", s->edad);
+  printf("  - GPA:  %.1f\n", s->promedio);
+  printf("  - File Position: byte %ld\n", (long)slot * (long)sizeof(Student));
+  printf("  - Index pages: %ld read from disk, %ld from the buffer pool\n\n",
+         db->index.misses - misses, db->index.hits - hits);
 }
 
-void run_update_record(void) {
+void run_update_record(StudentDb *db) {
   int update_id;
   printf("\nEnter ID to update: ");
   if (read_integer(&update_id) != SUCCESS) {
@@ -262,40 +552,40 @@ void run_update_record(void) {
     return;
   }
 
-  Student s;
-  FILE *file = fopen(FILENAME, "r+b");
-  if (!file) {
-    handle_error(ERR_FILE_NOT_FOUND);
+  uint32_t slot = 0;
+  Status status = db_sync(db);
+  if (status == SUCCESS) {
+    status = db_find(db, update_id, &slot);
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
     return;
   }
 
-  int found = 0;
-  while (fread(&s, sizeof(Student), 1, file)) {
-    if (s.id == update_id) {
-      found = 1;
-      printf("Record found. Current GPA: %.1f\n", s.promedio);
-      printf("New GPA: ");
-
-      if (read_float(&s.promedio) == SUCCESS) {
-        // Move pointer back to overwrite this exact record
-        fseek(file, -sizeof(Student), SEEK_CUR);
-        fwrite(&s, sizeof(Student), 1, file);
-        printf("\n  - Record updated successfully.\n\n");
-      } else {
-        handle_error(ERR_INVALID_INPUT);
-      }
-      break;
-    }
+  Student s = *store_get(&db->store, slot);
+  printf("Record found. Current GPA: %.1f\n", s.promedio);
+  printf("New GPA: ");
+  if (read_float(&s.promedio) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
   }
 
-  if (!found) {
-    handle_error(ERR_RECORD_NOT_FOUND);
+  // Logged and synced first, then written over this exact record; the ID
+  // and slot do not change, only the data file's mtime
+  status = db_log(db, slot, &s);
+  if (status == SUCCESS) {
+    status = db_commit(db);
   }
-
-  fclose(file);
+  if (status != SUCCESS) {
+    db_rollback(db);
+    handle_error(status);
+    return;
+  }
+  printf("\n  - Record updated successfully (logged to %s).\n\n",
+         WAL_FILENAME);
 }
 
-void run_delete_record(void) {
+void run_delete_record(StudentDb *db) {
   int delete_id;
   printf("\nEnter ID to delete: ");
   if (read_integer(&delete_id) != SUCCESS) {
@@ -303,85 +593,314 @@ void run_delete_record(void) {
     return;
   }
 
-  FILE *file = fopen(FILENAME, "rb");
-  if (!file) {
-    handle_error(ERR_FILE_NOT_FOUND);
-    return;
+  // One 32-byte write and one leaf update instead of rewriting the file
+  uint32_t slot = 0;
+  Status status = db_sync(db);
+  if (status == SUCCESS) {
+    status = db_find(db, delete_id, &slot);
   }
-
-  FILE *temp_file = fopen(TEMP_FILENAME, "wb");
-  if (!temp_file) {
-    fclose(file);
-    handle_error(ERR_FILE_CREATE_FAILED);
+  if (status == SUCCESS) {
+    status = delete_slot(db, slot);
+  }
+  if (status == SUCCESS) {
+    status = index_remove(&db->index, delete_id);
+  }
+  if (status == SUCCESS) {
+    status = db_commit(db);
+  }
+  if (status != SUCCESS) {
+    db_rollback(db);
+    handle_error(status);
     return;
   }
+  printf("\n  - Record deleted successfully (slot %u is now free).\n", slot);
+  printf("  - Remaining records: %llu\n",
+         (unsigned long long)db->index.meta.keys);
 
-  Student s;
-  int found = 0;
-  int records_kept = 0;
-
-  while (fread(&s, sizeof(Student), 1, file)) {
-    if (s.id == delete_id) {
-      found = 1;
-    } else {
-      fwrite(&s, sizeof(Student), 1, temp_file);
-      records_kept++;
+  // Amortized: a compaction only runs after as many deletes as live records
+  uint64_t free_slots = db->index.meta.free_slots;
+  if (free_slots >= COMPACT_MIN_SLOTS && free_slots * 2 >= db->store.count) {
+    uint64_t reclaimed = 0;
+    status = compact_data(db, &reclaimed);
+    if (status != SUCCESS) {
+      handle_error(status);
+      return;
     }
+    printf("  - Auto-compaction reclaimed %llu slots\n",
+           (unsigned long long)reclaimed);
   }
-
-  fclose(file);
-  fclose(temp_file);
-
-  if (found) {
-    remove(FILENAME);
-    rename(TEMP_FILENAME, FILENAME);
-    printf("\n  - Record deleted successfully.\n");
-    printf("  - Remaining records: %d\n\n", records_kept);
-  } else {
-    remove(TEMP_FILENAME);
-    handle_error(ERR_RECORD_NOT_FOUND);
-  }
+  printf("\n");
 }
 
-void run_show_statistics(void) {
-  Student s;
-  FILE *file = fopen(FILENAME, "rb");
-  if (!file) {
+void run_show_statistics(StudentDb *db) {
+  if (db_sync(db) != SUCCESS) {
     handle_error(ERR_FILE_NOT_FOUND);
     return;
   }
 
+  // Straight over the mapping: no read() copies, no per-record calls
+  RecordIterator it;
+  const Student *s;
   int count = 0;
-  float sum_promedios = 0.0f;
-  int sum_edades = 0;
-
-  while (fread(&s, sizeof(Student), 1, file)) {
+  double sum_promedios = 0.0;
+  long long sum_edades = 0;
+  double start = now_seconds();
+  store_iter_begin(&it, &db->store);
+  while ((s = store_iter_next(&it, NULL)) != NULL) {
     count++;
-    sum_promedios += s.promedio;
-    sum_edades += s.edad;
+    sum_promedios += s->promedio;
+    sum_edades += s->edad;
   }
-
-  fseek(file, 0, SEEK_END);
-  long total_bytes = ftell(file);
-  fclose(file);
+  double elapsed = now_seconds() - start;
 
   printf("\n=== Statistics for %s ===\n", FILENAME);
 
   if (count > 0) {
-    printf("  - File Size:       %ld bytes\n", total_bytes);
+    size_t total_bytes = db->store.count * sizeof(Student);
+    printf("  - File Size:       %zu bytes\n", total_bytes);
     printf("  - Total Records:   %d\n", count);
+    printf("  - Deleted Slots:   %zu\n", db->store.count - (size_t)count);
     printf("  - Size per Record: %zu bytes\n", sizeof(Student));
 
-    float avg_promedio = sum_promedios / count;
+    float avg_promedio = (float)(sum_promedios / count);
     float avg_edad = (float)sum_edades / count;
 
     printf("  - Average GPA:     %.2f\n", avg_promedio);
-    printf("  - Average Age:     %.2f years\n\n", avg_edad);
+    printf("  - Average Age:     %.2f years\n", avg_edad);
+    printf("  - Scan Time:       %.2f ms (%.0f MB/s)\n\n", elapsed * 1e3,
+           elapsed > 0.0 ? total_bytes / elapsed / 1e6 : 0.0);
   } else {
     printf("  - No records to analyze.\n\n");
   }
 }
 
+void run_range_scan(StudentDb *db) {
+  int low;
+  int high;
+
+  printf("\nLowest ID: ");
+  if (read_integer(&low) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+  printf("Highest ID: ");
+  if (read_integer(&high) != SUCCESS || high < low) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  // Seek to the first leaf entry >= low, then follow the sibling links
+  IndexCursor cursor;
+  Status status = db_sync(db);
+  if (status == SUCCESS) {
+    status = index_seek(&cursor, &db->index, low);
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  printf("\n--- Records with %d <= ID <= %d (in ID order) ---\n", low, high);
+  const Student *s;
+  int id;
+  uint32_t slot;
+  int count = 0;
+  while (index_next(&cursor, &id, &slot) && id <= high &&
+         (s = store_get(&db->store, slot)) != NULL) {
+    printf("  [%d] ID: %-5d | Name: %-15s | Age: %-3d | GPA: %.1f\n",
+           count + 1, s->id, s->nombre, s->edad, s->promedio);
+    count++;
+  }
+
+  if (count == 0) {
+    printf("  (No records in range)\n");
+  }
+  printf("\n  - Total: %d records\n\n", count);
+}
+
+void run_generate_records(StudentDb *db) {
+  static const char *names[] = {"Ada",    "Alan",   "Grace",  "Edgar",
+                                "Barbara", "Dennis", "Ken",    "Linus",
+                                "Margaret", "Donald", "Frances", "John"};
+  const int num_names = (int)(sizeof(names) / sizeof(names[0]));
+  int count = 0;
+
+  printf("\nNumber of records to add (e.g., 1000000): ");
+  if (read_integer(&count) != SUCCESS || count <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  Status status = db_sync(db);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  // Random positive IDs; collisions with existing records are retried.
+  // Appends go through the log in groups, one fdatasync() per group.
+  double start = now_seconds();
+  long syncs = db->wal.syncs;
+  int added = 0;
+  while (added < count && status == SUCCESS) {
+    Student s;
+    uint32_t slot = db->wal.end;
+    s.id = (int)(((unsigned)rand() << 8 ^ (unsigned)rand()) & 0x7fffffff);
+    status = index_insert(&db->index, s.id, slot);
+    if (status == ERR_DUPLICATE_ID) {
+      status = SUCCESS;
+      continue;
+    }
+    memset(s.nombre, 0, sizeof(s.nombre));
+    snprintf(s.nombre, sizeof(s.nombre), "%s %d", names[rand() % num_names],
+             s.id % 1000);
+    s.edad = 18 + rand() % 50;
+    s.promedio = (float)(rand() % 101) / 10.0f;
+    status = db_log(db, slot, &s);
+    added++;
+  }
+  if (status == SUCCESS) {
+    status = db_commit(db);
+  }
+  if (status != SUCCESS) {
+    db_rollback(db);
+    handle_error(status);
+    return;
+  }
+  printf("\n  - %d records added in %.2f s (%llu IDs indexed, %ld log "
+         "syncs)\n",
+         count, now_seconds() - start, (unsigned long long)db->index.meta.keys,
+         db->wal.syncs - syncs);
+
+  int ids[LOOKUP_PROBES];
+  uint32_t slot_found;
+  int num_ids = sample_ids(&db->index, ids, LOOKUP_PROBES);
+
+  // Tree descent plus one record read each vs one scan for a missing ID
+  long misses = db->index.misses;
+  int found = 0;
+  start = now_seconds();
+  for (int i = 0; i < num_ids; i++) {
+    if (db_find(db, ids[i], &slot_found) == SUCCESS) {
+      found++;
+    }
+  }
+  double lookup = (num_ids > 0) ? (now_seconds() - start) / num_ids : 0.0;
+
+  // The scan reads every record and its sum is printed, so neither an
+  // early exit nor the compiler can cut it short
+  RecordIterator it;
+  const Student *s;
+  int scanned = 0;
+  double gpa_sum = 0.0;
+  start = now_seconds();
+  store_iter_begin(&it, &db->store);
+  while ((s = store_iter_next(&it, NULL)) != NULL) {
+    gpa_sum += s->promedio;
+    scanned++;
+  }
+  double scan = now_seconds() - start;
+
+  printf("  - %d random lookups: %.2f us each, %.2f index pages from disk "
+         "each (%d found)\n",
+         num_ids, lookup * 1e6,
+         num_ids > 0 ? (double)(db->index.misses - misses) / num_ids : 0.0,
+         found);
+  printf("  - Full scan of the mapping: %.3f s (%.0fx slower, %d records, "
+         "mean GPA %.2f)\n\n",
+         scan, lookup > 0.0 ? scan / lookup : 0.0, scanned,
+         scanned > 0 ? gpa_sum / scanned : 0.0);
+}
+
+void run_compact(StudentDb *db) {
+  uint64_t reclaimed = 0;
+  double start = now_seconds();
+  Status status = db_sync(db);
+  if (status == SUCCESS) {
+    status = compact_data(db, &reclaimed);
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+  printf("\n  - Compaction reclaimed %llu slots (%llu bytes) in %.3f s\n",
+         (unsigned long long)reclaimed,
+         (unsigned long long)(reclaimed * sizeof(Student)),
+         now_seconds() - start);
+  printf("  - Live records: %llu\n\n",
+         (unsigned long long)db->index.meta.keys);
+}
+
+void run_batch_update(StudentDb *db) {
+  int count = 0;
+
+  printf("\nNumber of GPA updates (e.g., 100000): ");
+  if (read_integer(&count) != SUCCESS || count <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  Status status = db_sync(db);
+  int *ids = (int *)malloc((size_t)count * sizeof(int));
+  if (status == SUCCESS && ids == NULL) {
+    status = ERR_MEMORY_ALLOCATION;
+  }
+  int num_ids = (status == SUCCESS) ? sample_ids(&db->index, ids, count) : 0;
+  if (status == SUCCESS && num_ids == 0) {
+    status = ERR_FILE_NOT_FOUND;
+  }
+  if (status != SUCCESS) {
+    free(ids);
+    handle_error(status);
+    return;
+  }
+
+  // Every update is durable once its group is synced; the two runs differ
+  // only in how many updates share one fdatasync()
+  double rates[2] = {0.0, 0.0};
+  long syncs[2] = {0, 0};
+  int done[2] = {0, 0};
+  for (int run = 0; run < 2 && status == SUCCESS; run++) {
+    int limit = (run == 0 && num_ids > SYNC_EACH_LIMIT) ? SYNC_EACH_LIMIT
+                                                         : num_ids;
+    long first_sync = db->wal.syncs;
+    double start = now_seconds();
+    for (int i = 0; i < limit && status == SUCCESS; i++) {
+      uint32_t slot;
+      status = db_find(db, ids[i], &slot);
+      if (status == SUCCESS) {
+        Student s = *store_get(&db->store, slot);
+        s.promedio = (float)(rand() % 101) / 10.0f;
+        status = db_log(db, slot, &s);
+      }
+      if (status == SUCCESS && run == 0) {
+        status = wal_flush(&db->wal, &db->store);
+      }
+    }
+    if (status == SUCCESS) {
+      status = db_commit(db);
+    }
+    double elapsed = now_seconds() - start;
+    rates[run] = (elapsed > 0.0) ? limit / elapsed : 0.0;
+    syncs[run] = db->wal.syncs - first_sync;
+    done[run] = limit;
+  }
+  free(ids);
+  if (status != SUCCESS) {
+    db_rollback(db);
+    handle_error(status);
+    return;
+  }
+
+  printf("\n  - One fdatasync() per update: %d updates, %.0f updates/s "
+         "(%ld syncs)\n",
+         done[0], rates[0], syncs[0]);
+  printf("  - Group commit (%d per sync): %d updates, %.0f updates/s "
+         "(%ld syncs, %.1fx faster)\n\n",
+         WAL_GROUP_RECORDS, done[1], rates[1], syncs[1],
+         rates[0] > 0.0 ? rates[1] / rates[0] : 0.0);
+}
+
 void clear_input_buffer(void) {
   int c;
   while ((c = getchar()) != '\n' && c != EOF) {
@@ -421,3 +940,1241 @@ Status read_string(char *buffer, int max_len) {
 
   return SUCCESS;
 }
+
+double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Existing IDs, each the first key at or after a random one (wrapping
+// around to the smallest key)
+int sample_ids(BTree *tree, int *ids, int count) {
+  IndexCursor cursor;
+  uint32_t slot;
+  int found = 0;
+  for (int i = 0; i < count; i++) {
+    int probe = (int)(((unsigned)rand() << 8 ^ (unsigned)rand()) & 0x7fffffff);
+    if (index_seek(&cursor, tree, probe) != SUCCESS ||
+        !index_next(&cursor, &ids[found], &slot)) {
+      if (index_seek(&cursor, tree, INT_MIN) != SUCCESS ||
+          !index_next(&cursor, &ids[found], &slot)) {
+        break;
+      }
+    }
+    found++;
+  }
+  return found;
+}
+
+// Replay runs before the index is opened: a replayed log changes the data
+// file, so the index sees a stale meta page and rebuilds
+Status db_open(StudentDb *db) {
+  Status status = store_open(&db->store);
+  if (status != SUCCESS) {
+    return status;
+  }
+  status = wal_open(&db->wal, &db->store);
+  if (status != SUCCESS) {
+    store_close(&db->store);
+    return status;
+  }
+  status = index_open(&db->index, &db->store, db->wal.next_lsn);
+  if (status != SUCCESS) {
+    wal_close(&db->wal, &db->store);
+    store_close(&db->store);
+  }
+  return status;
+}
+
+void db_close(StudentDb *db) {
+  wal_close(&db->wal, &db->store);
+  index_close(&db->index);
+  store_close(&db->store);
+}
+
+// Picks up changes made by other programs before every operation
+Status db_sync(StudentDb *db) {
+  Status status = store_refresh(&db->store);
+
+  // Leftovers of a failed operation are dropped, never committed later
+  if (status == SUCCESS && db->wal.count > 0) {
+    status = db_rollback(db);
+  }
+
+  // A replaced data file: new log entries must not be tied to the old one.
+  // A log left with a gap by a failed group gets another checkpoint too.
+  if (status == SUCCESS && (db->wal.broken ||
+                            db->wal.header.data_ino != db->store.ino)) {
+    status = wal_checkpoint(&db->wal, &db->store);
+  }
+  db->wal.end = (uint32_t)db->store.count;
+  db->index.lsn = db->wal.next_lsn;
+  if (status == SUCCESS) {
+    status = index_sync(&db->index, &db->store);
+  }
+  return status;
+}
+
+// Log first (synced, then applied to the mapping), index last
+Status db_commit(StudentDb *db) {
+  Status status = wal_flush(&db->wal, &db->store);
+  if (status == SUCCESS) {
+    db->index.lsn = db->wal.next_lsn;
+    status = index_commit(&db->index, &db->store);
+  }
+  return status;
+}
+
+// After a failed operation: unsynced changes are dropped and the index,
+// which may hold keys for them, is rebuilt from the data file
+Status db_rollback(StudentDb *db) {
+  wal_discard(&db->wal, &db->store);
+  db->index.lsn = db->wal.next_lsn;
+  return index_rebuild(&db->index, &db->store);
+}
+
+// Index lookup, double-checked against the record it points to: a crash
+// inside the file's mtime granularity could hide a stale index
+Status db_find(StudentDb *db, int id, uint32_t *slot) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    Status status = index_find(&db->index, id, slot);
+    if (status != SUCCESS) {
+      return status; // '*slot' was not written
+    }
+    const Student *s = store_get(&db->store, *slot);
+    if (s != NULL && s->id == id) {
+      return SUCCESS;
+    }
+    status = index_rebuild(&db->index, &db->store);
+    if (status != SUCCESS) {
+      return status;
+    }
+  }
+  return ERR_INDEX_IO;
+}
+
+// Changes reach the mapping only once their log group is on disk
+Status db_log(StudentDb *db, uint32_t slot, const Student *s) {
+  return wal_log(&db->wal, &db->store, slot, s);
+}
+
+// Fills the most recent hole first, appends when the free list is empty
+Status store_record(StudentDb *db, const Student *s, uint32_t *slot) {
+  IndexMeta *meta = &db->index.meta;
+  const Student *hole = store_get(&db->store, meta->free_head);
+
+  // The list disagrees with the data file: rebuild it from the tombstones
+  if (meta->free_head != FREE_END &&
+      (hole == NULL || hole->id != TOMBSTONE_ID)) {
+    Status status = index_rebuild(&db->index, &db->store);
+    if (status != SUCCESS) {
+      return status;
+    }
+    hole = store_get(&db->store, meta->free_head);
+  }
+
+  if (meta->free_head != FREE_END) {
+    *slot = meta->free_head;
+    meta->free_head = (uint32_t)hole->edad;
+    meta->free_slots--;
+    return db_log(db, *slot, s);
+  }
+
+  // Applying the log entry grows the file
+  *slot = db->wal.end;
+  return db_log(db, *slot, s);
+}
+
+Status delete_slot(StudentDb *db, uint32_t slot) {
+  Student tombstone;
+  memset(&tombstone, 0, sizeof(tombstone));
+  tombstone.id = TOMBSTONE_ID;
+  tombstone.edad = (int)db->index.meta.free_head;
+
+  Status status = db_log(db, slot, &tombstone);
+  if (status == SUCCESS) {
+    db->index.meta.free_head = slot;
+    db->index.meta.free_slots++;
+  }
+  return status;
+}
+
+Status compact_data(StudentDb *db, uint64_t *reclaimed) {
+  // Log entries name slots of the current file: empty the log first
+  Status status = wal_checkpoint(&db->wal, &db->store);
+  if (status != SUCCESS) {
+    return status;
+  }
+  FILE *temp_file = fopen(TEMP_FILENAME, "wb");
+  if (temp_file == NULL) {
+    return ERR_FILE_CREATE_FAILED;
+  }
+
+  // Live records keep their relative order; each run between tombstones
+  // goes out with a single fwrite() straight from the mapping
+  RecordIterator it;
+  const Student *s;
+  uint32_t slot;
+  size_t run_start = 0;
+  size_t run_length = 0;
+  int ok = TRUE;
+  store_iter_begin(&it, &db->store);
+  while (ok && (s = store_iter_next(&it, &slot)) != NULL) {
+    if (run_length > 0 && slot != run_start + run_length) {
+      ok = fwrite(&db->store.records[run_start], sizeof(Student), run_length,
+                  temp_file) == run_length;
+      run_length = 0;
+    }
+    if (run_length == 0) {
+      run_start = slot;
+    }
+    run_length++;
+  }
+  if (ok && run_length > 0) {
+    ok = fwrite(&db->store.records[run_start], sizeof(Student), run_length,
+                temp_file) == run_length;
+  }
+
+  // The new file must be on disk before it replaces the old one, and the
+  // rename itself must reach the directory
+  ok = ok && fflush(temp_file) == 0 && fsync(fileno(temp_file)) == 0;
+  if (fclose(temp_file) != 0 || !ok || rename(TEMP_FILENAME, FILENAME) != 0) {
+    remove(TEMP_FILENAME);
+    return ERR_FILE_CREATE_FAILED;
+  }
+  int dir = open(".", O_RDONLY);
+  if (dir >= 0) {
+    fsync(dir);
+    close(dir);
+  }
+  *reclaimed = db->index.meta.free_slots;
+
+  // New inode: map it, tie the log to it, then rebuild (every slot after
+  // the first hole moved)
+  store_close(&db->store);
+  status = store_open(&db->store);
+  if (status == SUCCESS) {
+    status = wal_checkpoint(&db->wal, &db->store);
+  }
+  if (status == SUCCESS) {
+    status = index_rebuild(&db->index, &db->store);
+  }
+  return status;
+}
+
+Status store_open(RecordStore *store) {
+  struct stat st;
+
+  memset(store, 0, sizeof(*store));
+  store->fd = open(FILENAME, O_RDWR | O_CREAT, 0644);
+  if (store->fd < 0) {
+    return ERR_FILE_CREATE_FAILED;
+  }
+  if (fstat(store->fd, &st) != 0) {
+    close(store->fd);
+    return ERR_FILE_NOT_FOUND;
+  }
+
+  store->ino = (uint64_t)st.st_ino;
+
+  // Reserve address space past the end of file so appends rarely remap;
+  // pages past EOF are never touched (that would be SIGBUS)
+  store->count = (size_t)st.st_size / sizeof(Student);
+  store->capacity = STORE_MIN_SLOTS;
+  while (store->capacity < store->count) {
+    store->capacity *= 2;
+  }
+  void *map = mmap(NULL, store->capacity * sizeof(Student),
+                   PROT_READ | PROT_WRITE, MAP_SHARED, store->fd, 0);
+  if (map == MAP_FAILED) {
+    close(store->fd);
+    return ERR_MAP_FAILED;
+  }
+  store->records = (Student *)map;
+
+  // Most accesses are index-driven point lookups. Hints always cover the
+  // whole mapping: advice on part of it splits the VMA and mremap() refuses
+  // to move a range spanning several
+  madvise(store->records, store->capacity * sizeof(Student), MADV_RANDOM);
+  return SUCCESS;
+}
+
+void store_close(RecordStore *store) {
+  if (store->records != NULL) {
+    if (store->count > 0) {
+      msync(store->records, store->count * sizeof(Student), MS_SYNC);
+    }
+    munmap(store->records, store->capacity * sizeof(Student));
+  }
+  if (store->fd >= 0) {
+    close(store->fd);
+  }
+  store->records = NULL;
+  store->fd = -1;
+}
+
+Status store_refresh(RecordStore *store) {
+  struct stat on_disk;
+  struct stat mapped;
+
+  // Replaced by another program (e.g. a rename): map the new file
+  if (stat(FILENAME, &on_disk) != 0 || fstat(store->fd, &mapped) != 0 ||
+      on_disk.st_ino != mapped.st_ino || on_disk.st_dev != mapped.st_dev) {
+    store_close(store);
+    return store_open(store);
+  }
+
+  // Grown or truncated behind our back
+  size_t count = (size_t)mapped.st_size / sizeof(Student);
+  if (count != store->count) {
+    Status status = store_resize(store, count);
+    if (status != SUCCESS) {
+      return status;
+    }
+  }
+  return SUCCESS;
+}
+
+Status store_resize(RecordStore *store, size_t count) {
+  if (count > store->capacity) {
+    size_t capacity = store->capacity * 2;
+    while (capacity < count) {
+      capacity *= 2;
+    }
+    void *map = mremap(store->records, store->capacity * sizeof(Student),
+                       capacity * sizeof(Student), MREMAP_MAYMOVE);
+    if (map == MAP_FAILED) {
+      return ERR_MAP_FAILED;
+    }
+    store->records = (Student *)map;
+    store->capacity = capacity;
+  }
+
+  // The file always holds exactly 'count' records
+  if (ftruncate(store->fd, (off_t)(count * sizeof(Student))) != 0) {
+    return ERR_MAP_FAILED;
+  }
+  store->count = count;
+  return SUCCESS;
+}
+
+Student *store_get(const RecordStore *store, uint32_t slot) {
+  return (slot < store->count) ? &store->records[slot] : NULL;
+}
+
+// After writing through the mapping: bump the mtime, which a store to a
+// page that is already dirty does not do by itself. Write-back is left to
+// the kernel; the log makes the change durable.
+void store_touch(RecordStore *store) {
+  futimens(store->fd, NULL);
+}
+
+void store_stat(const RecordStore *store, uint64_t *size, int64_t *sec,
+                int64_t *nsec) {
+  struct stat st;
+  if (fstat(store->fd, &st) != 0) {
+    *size = 0;
+    *sec = 0;
+    *nsec = 0;
+    return;
+  }
+  *size = (uint64_t)st.st_size;
+  *sec = (int64_t)st.st_mtim.tv_sec;
+  *nsec = (int64_t)st.st_mtim.tv_nsec;
+}
+
+void store_iter_begin(RecordIterator *it, const RecordStore *store) {
+  it->store = store;
+  it->next = 0;
+  madvise(store->records, store->capacity * sizeof(Student), MADV_SEQUENTIAL);
+  if (store->count > 0) {
+    madvise(store->records, store->count * sizeof(Student), MADV_WILLNEED);
+  }
+}
+
+// Next live record (tombstones skipped), NULL at the end; 'slot' may be NULL
+const Student *store_iter_next(RecordIterator *it, uint32_t *slot) {
+  while (it->next < it->store->count) {
+    const Student *s = &it->store->records[it->next++];
+    if (s->id != TOMBSTONE_ID) {
+      if (slot != NULL) {
+        *slot = (uint32_t)(it->next - 1);
+      }
+      return s;
+    }
+  }
+
+  // Back to point lookups once the scan is over
+  madvise(it->store->records, it->store->capacity * sizeof(Student),
+          MADV_RANDOM);
+  return NULL;
+}
+
+Status wal_open(WriteAheadLog *wal, RecordStore *store) {
+  struct stat st;
+
+  memset(wal, 0, sizeof(*wal));
+  wal->pending = (LogRecord *)malloc(WAL_GROUP_RECORDS * sizeof(LogRecord));
+  wal->fd = open(WAL_FILENAME, O_RDWR | O_CREAT, 0644);
+  if (wal->pending == NULL || wal->fd < 0 || fstat(wal->fd, &st) != 0) {
+    free(wal->pending);
+    if (wal->fd >= 0) {
+      close(wal->fd);
+    }
+    return ERR_WAL_IO;
+  }
+
+  // Redo whatever was committed since the last checkpoint, then start an
+  // empty log
+  Status status = wal_replay(wal, store);
+  if (status == SUCCESS) {
+    status = wal_checkpoint(wal, store);
+  }
+  if (status != SUCCESS) {
+    free(wal->pending);
+    close(wal->fd);
+    return status;
+  }
+
+  // A new log file must survive a crash as well as its contents
+  if (st.st_size == 0) {
+    int dir = open(".", O_RDONLY);
+    if (dir >= 0) {
+      fsync(dir);
+      close(dir);
+    }
+  }
+  return SUCCESS;
+}
+
+// Changes still pending were never committed: they are dropped
+void wal_close(WriteAheadLog *wal, RecordStore *store) {
+  if (wal->fd < 0) {
+    return;
+  }
+  wal_discard(wal, store);
+  wal_checkpoint(wal, store);
+  close(wal->fd);
+  free(wal->pending);
+  wal->pending = NULL;
+  wal->fd = -1;
+}
+
+Status wal_replay(WriteAheadLog *wal, RecordStore *store) {
+  WalHeader header;
+
+  // No log yet, a foreign file, or a log for a data file that has since
+  // been replaced: nothing to redo
+  wal->next_lsn = 1;
+  if (pread(wal->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+      memcmp(header.magic, WAL_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != WAL_VERSION) {
+    return SUCCESS;
+  }
+  wal->next_lsn = header.start_lsn;
+  if (header.data_ino != store->ino) {
+    return SUCCESS;
+  }
+
+  // Entries are read a group at a time; the first one out of sequence or
+  // with a bad checksum ends the log (a group torn by the crash)
+  off_t offset = (off_t)sizeof(header);
+  int torn = FALSE;
+  while (!torn) {
+    ssize_t got = pread(wal->fd, wal->pending,
+                        WAL_GROUP_RECORDS * sizeof(LogRecord), offset);
+    size_t valid = 0;
+    size_t end = store->count;
+    while (got > 0 && valid < (size_t)got / sizeof(LogRecord)) {
+      const LogRecord *record = &wal->pending[valid];
+      if (record->lsn != wal->next_lsn + valid ||
+          record->checksum != wal_checksum(record)) {
+        break;
+      }
+      if (record->slot >= end) {
+        end = (size_t)record->slot + 1;
+      }
+      valid++;
+    }
+    torn = (valid < WAL_GROUP_RECORDS);
+    if (valid == 0) {
+      break;
+    }
+
+    if (end > store->count) {
+      Status status = store_resize(store, end);
+      if (status != SUCCESS) {
+        return status;
+      }
+    }
+    for (size_t i = 0; i < valid; i++) {
+      store->records[wal->pending[i].slot] = wal->pending[i].after;
+    }
+    wal->next_lsn += valid;
+    wal->recovered += valid;
+    offset += (off_t)(valid * sizeof(LogRecord));
+  }
+
+  if (wal->recovered > 0) {
+    store_touch(store);
+  }
+  return SUCCESS;
+}
+
+// Buffers one change; a full group is committed on the spot
+Status wal_log(WriteAheadLog *wal, RecordStore *store, uint32_t slot,
+               const Student *s) {
+  if (wal->broken) {
+    return ERR_WAL_IO;
+  }
+  if (wal->count == WAL_GROUP_RECORDS) {
+    Status status = wal_flush(wal, store);
+    if (status != SUCCESS) {
+      return status;
+    }
+  }
+
+  LogRecord *record = &wal->pending[wal->count++];
+  record->lsn = wal->next_lsn++;
+  record->slot = slot;
+  record->after = *s;
+  record->checksum = wal_checksum(record);
+  if (slot >= wal->end) {
+    wal->end = slot + 1;
+  }
+  return SUCCESS;
+}
+
+// Group commit: one write() and one fdatasync() for every pending change,
+// then the changes are applied to the mapping
+Status wal_flush(WriteAheadLog *wal, RecordStore *store) {
+  if (wal->count == 0) {
+    return SUCCESS;
+  }
+  if (wal->broken) {
+    return ERR_WAL_IO;
+  }
+
+  size_t bytes = wal->count * sizeof(LogRecord);
+  if (pwrite(wal->fd, wal->pending, bytes, wal->size) != (ssize_t)bytes ||
+      fdatasync(wal->fd) != 0) {
+    // Part of the group may be on disk: its LSNs are never reused, and the
+    // checkpoint starts the log past them. Until one succeeds, nothing is
+    // appended behind the gap.
+    wal->count = 0;
+    wal->end = (uint32_t)store->count;
+    wal->broken = TRUE;
+    wal_checkpoint(wal, store);
+    return ERR_WAL_IO;
+  }
+  wal->size += (off_t)bytes;
+  wal->syncs++;
+
+  // A synced group is never discarded (that would hand its LSNs out
+  // again): if it cannot be applied, the checkpoint starts past it
+  if (wal->end > store->count) {
+    Status status = store_resize(store, wal->end);
+    if (status != SUCCESS) {
+      wal->count = 0;
+      wal->end = (uint32_t)store->count;
+      wal->broken = TRUE;
+      wal_checkpoint(wal, store);
+      return status;
+    }
+  }
+  for (size_t i = 0; i < wal->count; i++) {
+    store->records[wal->pending[i].slot] = wal->pending[i].after;
+  }
+  wal->count = 0;
+  store_touch(store);
+
+  if (wal->size >= WAL_CHECKPOINT_BYTES) {
+    return wal_checkpoint(wal, store);
+  }
+  return SUCCESS;
+}
+
+void wal_discard(WriteAheadLog *wal, const RecordStore *store) {
+  wal->next_lsn -= wal->count;
+  wal->count = 0;
+  wal->end = (uint32_t)store->count;
+}
+
+// Once the data pages are on disk the log entries are redundant: the new
+// header (with a start LSN past all of them) goes first, then the log is
+// cut back to the header
+Status wal_checkpoint(WriteAheadLog *wal, RecordStore *store) {
+  Status status = wal_flush(wal, store);
+  if (status != SUCCESS) {
+    return status;
+  }
+  if (store->count > 0 &&
+      msync(store->records, store->count * sizeof(Student), MS_SYNC) != 0) {
+    return ERR_MAP_FAILED;
+  }
+
+  memset(&wal->header, 0, sizeof(wal->header));
+  memcpy(wal->header.magic, WAL_MAGIC, sizeof(wal->header.magic));
+  wal->header.version = WAL_VERSION;
+  wal->header.start_lsn = wal->next_lsn;
+  wal->header.data_ino = store->ino;
+  if (pwrite(wal->fd, &wal->header, sizeof(wal->header), 0) !=
+          (ssize_t)sizeof(wal->header) ||
+      ftruncate(wal->fd, (off_t)sizeof(wal->header)) != 0 ||
+      fdatasync(wal->fd) != 0) {
+    return ERR_WAL_IO;
+  }
+  wal->size = (off_t)sizeof(wal->header);
+  wal->end = (uint32_t)store->count;
+  wal->broken = FALSE;
+  return SUCCESS;
+}
+
+uint32_t wal_checksum(const LogRecord *record) {
+  LogRecord copy = *record;
+  const unsigned char *bytes = (const unsigned char *)&copy;
+  uint32_t hash = 2166136261u;
+
+  copy.checksum = 0;
+  for (size_t i = 0; i < sizeof(copy); i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+Status index_open(BTree *tree, RecordStore *store, uint64_t lsn) {
+  memset(tree, 0, sizeof(*tree));
+  tree->lsn = lsn;
+  tree->frames = (Frame *)calloc(POOL_FRAMES, sizeof(Frame));
+  tree->fd = open(INDEX_FILENAME, O_RDWR | O_CREAT, 0644);
+  if (tree->frames == NULL || tree->fd < 0) {
+    index_close(tree);
+    return ERR_INDEX_IO;
+  }
+
+  // A missing, foreign or stale index is rebuilt from the data file
+  ssize_t got = pread(tree->fd, &tree->meta, sizeof(tree->meta), 0);
+  if (got != (ssize_t)sizeof(tree->meta) ||
+      memcmp(tree->meta.magic, INDEX_MAGIC, sizeof(tree->meta.magic)) != 0 ||
+      tree->meta.version != INDEX_VERSION ||
+      tree->meta.page_bytes != PAGE_BYTES || tree->meta.root == NO_PAGE ||
+      tree->meta.root >= tree->meta.num_pages) {
+    return index_rebuild(tree, store);
+  }
+  return index_sync(tree, store);
+}
+
+void index_close(BTree *tree) {
+  if (tree->fd >= 0 && tree->frames != NULL) {
+    pool_flush(tree, FALSE);
+  }
+  if (tree->fd >= 0) {
+    close(tree->fd);
+  }
+  free(tree->frames);
+  tree->frames = NULL;
+  tree->fd = -1;
+}
+
+Status index_sync(BTree *tree, RecordStore *store) {
+  uint64_t size;
+  int64_t sec;
+  int64_t nsec;
+
+  // Someone changed the data file behind the index's back, the index was
+  // committed at another log position (the mtime alone does not survive
+  // a crash), or pages were written back after the last commit: the data
+  // file wins
+  store_stat(store, &size, &sec, &nsec);
+  if (size != tree->meta.data_size || sec != tree->meta.data_mtime_sec ||
+      nsec != tree->meta.data_mtime_nsec || tree->meta.wal_lsn != tree->lsn ||
+      tree->meta.dirty) {
+    return index_rebuild(tree, store);
+  }
+  return SUCCESS;
+}
+
+Status index_commit(BTree *tree, const RecordStore *store) {
+  // Nodes first, meta page last: until the meta page names the new data
+  // file state, a crash only leaves an index that gets rebuilt
+  store_stat(store, &tree->meta.data_size, &tree->meta.data_mtime_sec,
+             &tree->meta.data_mtime_nsec);
+  tree->meta.wal_lsn = tree->lsn;
+  return pool_flush(tree, TRUE);
+}
+
+Status index_rebuild(BTree *tree, RecordStore *store) {
+  uint64_t records = store->count;
+  KeySlot *pairs = (KeySlot *)malloc((records > 0 ? records : 1) *
+                                     sizeof(KeySlot));
+  if (pairs == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Live records from the front, tombstones from the back of the array
+  uint64_t count = 0;
+  uint64_t free_slots = 0;
+  for (uint64_t slot = 0; slot < records; slot++) {
+    KeySlot *pair = (store->records[slot].id == TOMBSTONE_ID)
+                        ? &pairs[records - ++free_slots]
+                        : &pairs[count++];
+    pair->key = store->records[slot].id;
+    pair->slot = (uint32_t)slot;
+  }
+
+  // Relink the free list in slot order, writing only the links that
+  // differ (normally none); the head is the lowest free slot
+  int relinked = FALSE;
+  for (uint64_t i = 0; i < free_slots; i++) {
+    Student *hole = &store->records[pairs[records - 1 - i].slot];
+    uint32_t next = (i + 1 < free_slots) ? pairs[records - 2 - i].slot
+                                         : FREE_END;
+    if ((uint32_t)hole->edad != next) {
+      hole->edad = (int)next;
+      relinked = TRUE;
+    }
+  }
+  uint32_t free_head = (free_slots > 0) ? pairs[records - 1].slot : FREE_END;
+  if (relinked) {
+    store_touch(store);
+  }
+
+  // Older files may repeat an ID: keep the first slot, as a scan would
+  qsort(pairs, count, sizeof(KeySlot), compare_key_slots);
+  uint64_t unique = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    if (unique == 0 || pairs[i].key != pairs[unique - 1].key) {
+      pairs[unique++] = pairs[i];
+    }
+  }
+
+  Status status = index_bulk_load(tree, pairs, unique);
+  free(pairs);
+  if (status == SUCCESS) {
+    tree->meta.free_slots = free_slots;
+    tree->meta.free_head = free_head;
+    status = index_commit(tree, store);
+  }
+  return status;
+}
+
+Status index_bulk_load(BTree *tree, KeySlot *pairs, uint64_t count) {
+  // Start over with an empty file and pool
+  memset(tree->frames, 0, POOL_FRAMES * sizeof(Frame));
+  if (ftruncate(tree->fd, 0) != 0) {
+    return ERR_INDEX_IO;
+  }
+  memset(&tree->meta, 0, sizeof(tree->meta));
+  memcpy(tree->meta.magic, INDEX_MAGIC, sizeof(tree->meta.magic));
+  tree->meta.version = INDEX_VERSION;
+  tree->meta.page_bytes = PAGE_BYTES;
+  tree->meta.num_pages = 1;
+  tree->meta.keys = count;
+  tree->meta.free_head = FREE_END;
+
+  // Leaves left to right on consecutive pages, some room kept for inserts
+  uint64_t leaf_fill = LEAF_KEYS * BULK_FILL / 100;
+  uint64_t num_leaves = (count + leaf_fill - 1) / leaf_fill;
+  if (num_leaves == 0) {
+    num_leaves = 1;
+  }
+  KeySlot *level = (KeySlot *)malloc(num_leaves * sizeof(KeySlot));
+  if (level == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  uint64_t n = 0;
+  for (uint64_t i = 0; i < num_leaves; i++) {
+    uint32_t page;
+    BNode *leaf = pool_new(tree, &page, TRUE);
+    if (leaf == NULL) {
+      free(level);
+      return ERR_INDEX_IO;
+    }
+    leaf->next = (i + 1 < num_leaves) ? page + 1 : NO_PAGE;
+    level[i].key = (n < count) ? pairs[n].key : 0;
+    level[i].slot = page;
+    while (leaf->count < leaf_fill && n < count) {
+      leaf->u.leaf.keys[leaf->count] = pairs[n].key;
+      leaf->u.leaf.slots[leaf->count] = pairs[n].slot;
+      leaf->count++;
+      n++;
+    }
+    pool_release(tree, leaf, TRUE);
+  }
+
+  // Each upper level indexes the first key of every node below it
+  uint64_t inner_fill = (INNER_KEYS + 1) * BULK_FILL / 100;
+  uint64_t width = num_leaves;
+  while (width > 1) {
+    uint64_t parents = 0;
+    for (uint64_t i = 0; i < width; i += inner_fill) {
+      uint32_t page;
+      BNode *inner = pool_new(tree, &page, FALSE);
+      if (inner == NULL) {
+        free(level);
+        return ERR_INDEX_IO;
+      }
+      uint64_t end = (i + inner_fill < width) ? i + inner_fill : width;
+      for (uint64_t c = i; c < end; c++) {
+        if (c > i) {
+          inner->u.inner.keys[inner->count++] = level[c].key;
+        }
+        inner->u.inner.children[c - i] = level[c].slot;
+      }
+      level[parents].key = level[i].key; // parents <= i: nothing lost
+      level[parents].slot = page;
+      parents++;
+      pool_release(tree, inner, TRUE);
+    }
+    width = parents;
+  }
+
+  tree->meta.root = level[0].slot;
+  free(level);
+  return SUCCESS;
+}
+
+Status index_find(BTree *tree, int id, uint32_t *slot) {
+  uint32_t page;
+  Status status = index_find_leaf(tree, id, &page);
+  if (status != SUCCESS) {
+    return status;
+  }
+
+  BNode *leaf = pool_fetch(tree, page);
+  if (leaf == NULL) {
+    return ERR_INDEX_IO;
+  }
+  uint32_t pos = leaf_lower_bound(leaf, id);
+  status = ERR_RECORD_NOT_FOUND;
+  if (pos < leaf->count && leaf->u.leaf.keys[pos] == id) {
+    *slot = leaf->u.leaf.slots[pos];
+    status = SUCCESS;
+  }
+  pool_release(tree, leaf, FALSE);
+  return status;
+}
+
+Status index_insert(BTree *tree, int id, uint32_t slot) {
+  int split = FALSE;
+  int32_t split_key = 0;
+  uint32_t split_page = NO_PAGE;
+
+  Status status = index_insert_into(tree, tree->meta.root, id, slot, &split,
+                                    &split_key, &split_page);
+  if (status != SUCCESS) {
+    return status;
+  }
+  tree->meta.keys++;
+  if (!split) {
+    return SUCCESS;
+  }
+
+  // The root split: grow the tree by one level
+  uint32_t page;
+  BNode *root = pool_new(tree, &page, FALSE);
+  if (root == NULL) {
+    return ERR_INDEX_IO;
+  }
+  root->count = 1;
+  root->u.inner.keys[0] = split_key;
+  root->u.inner.children[0] = tree->meta.root;
+  root->u.inner.children[1] = split_page;
+  pool_release(tree, root, TRUE);
+  tree->meta.root = page;
+  return SUCCESS;
+}
+
+Status index_insert_into(BTree *tree, uint32_t page, int id, uint32_t slot,
+                         int *split, int32_t *split_key,
+                         uint32_t *split_page) {
+  BNode *node = pool_fetch(tree, page);
+  if (node == NULL) {
+    return ERR_INDEX_IO;
+  }
+
+  if (node->is_leaf) {
+    uint32_t pos = leaf_lower_bound(node, id);
+    if (pos < node->count && node->u.leaf.keys[pos] == id) {
+      pool_release(tree, node, FALSE);
+      return ERR_DUPLICATE_ID;
+    }
+    if (node->count < LEAF_KEYS) {
+      memmove(&node->u.leaf.keys[pos + 1], &node->u.leaf.keys[pos],
+              (node->count - pos) * sizeof(int32_t));
+      memmove(&node->u.leaf.slots[pos + 1], &node->u.leaf.slots[pos],
+              (node->count - pos) * sizeof(uint32_t));
+      node->u.leaf.keys[pos] = id;
+      node->u.leaf.slots[pos] = slot;
+      node->count++;
+      pool_release(tree, node, TRUE);
+      return SUCCESS;
+    }
+
+    // Full leaf: split. Appending past the rightmost key (ascending IDs)
+    // leaves the left page full instead of half empty.
+    uint32_t right_page;
+    BNode *right = pool_new(tree, &right_page, TRUE);
+    if (right == NULL) {
+      pool_release(tree, node, FALSE);
+      return ERR_INDEX_IO;
+    }
+    uint32_t keep = (pos == LEAF_KEYS && node->next == NO_PAGE)
+                        ? LEAF_KEYS
+                        : (LEAF_KEYS + 1) / 2;
+    int32_t keys[LEAF_KEYS + 1];
+    uint32_t slots[LEAF_KEYS + 1];
+    memcpy(keys, node->u.leaf.keys, pos * sizeof(int32_t));
+    memcpy(slots, node->u.leaf.slots, pos * sizeof(uint32_t));
+    keys[pos] = id;
+    slots[pos] = slot;
+    memcpy(&keys[pos + 1], &node->u.leaf.keys[pos],
+           (LEAF_KEYS - pos) * sizeof(int32_t));
+    memcpy(&slots[pos + 1], &node->u.leaf.slots[pos],
+           (LEAF_KEYS - pos) * sizeof(uint32_t));
+
+    node->count = keep;
+    memcpy(node->u.leaf.keys, keys, keep * sizeof(int32_t));
+    memcpy(node->u.leaf.slots, slots, keep * sizeof(uint32_t));
+    right->count = LEAF_KEYS + 1 - keep;
+    memcpy(right->u.leaf.keys, &keys[keep], right->count * sizeof(int32_t));
+    memcpy(right->u.leaf.slots, &slots[keep],
+           right->count * sizeof(uint32_t));
+    right->next = node->next;
+    node->next = right_page;
+
+    *split = TRUE;
+    *split_key = right->u.leaf.keys[0];
+    *split_page = right_page;
+    pool_release(tree, right, TRUE);
+    pool_release(tree, node, TRUE);
+    return SUCCESS;
+  }
+
+  // Inner node: unpin while the child works, the path may be long
+  uint32_t idx = inner_child(node, id);
+  uint32_t child = node->u.inner.children[idx];
+  pool_release(tree, node, FALSE);
+
+  int child_split = FALSE;
+  int32_t child_key = 0;
+  uint32_t child_page = NO_PAGE;
+  Status status = index_insert_into(tree, child, id, slot, &child_split,
+                                    &child_key, &child_page);
+  if (status != SUCCESS || !child_split) {
+    return status;
+  }
+
+  node = pool_fetch(tree, page);
+  if (node == NULL) {
+    return ERR_INDEX_IO;
+  }
+  if (node->count < INNER_KEYS) {
+    memmove(&node->u.inner.keys[idx + 1], &node->u.inner.keys[idx],
+            (node->count - idx) * sizeof(int32_t));
+    memmove(&node->u.inner.children[idx + 2],
+            &node->u.inner.children[idx + 1],
+            (node->count - idx) * sizeof(uint32_t));
+    node->u.inner.keys[idx] = child_key;
+    node->u.inner.children[idx + 1] = child_page;
+    node->count++;
+    pool_release(tree, node, TRUE);
+    return SUCCESS;
+  }
+
+  // Full inner node: the middle key moves up, it is not copied
+  uint32_t right_page;
+  BNode *right = pool_new(tree, &right_page, FALSE);
+  if (right == NULL) {
+    pool_release(tree, node, FALSE);
+    return ERR_INDEX_IO;
+  }
+  int32_t keys[INNER_KEYS + 1];
+  uint32_t children[INNER_KEYS + 2];
+  memcpy(keys, node->u.inner.keys, idx * sizeof(int32_t));
+  memcpy(children, node->u.inner.children, (idx + 1) * sizeof(uint32_t));
+  keys[idx] = child_key;
+  children[idx + 1] = child_page;
+  memcpy(&keys[idx + 1], &node->u.inner.keys[idx],
+         (INNER_KEYS - idx) * sizeof(int32_t));
+  memcpy(&children[idx + 2], &node->u.inner.children[idx + 1],
+         (INNER_KEYS - idx) * sizeof(uint32_t));
+
+  uint32_t mid = (INNER_KEYS + 1) / 2;
+  node->count = mid;
+  memcpy(node->u.inner.keys, keys, mid * sizeof(int32_t));
+  memcpy(node->u.inner.children, children, (mid + 1) * sizeof(uint32_t));
+  right->count = INNER_KEYS - mid;
+  memcpy(right->u.inner.keys, &keys[mid + 1], right->count * sizeof(int32_t));
+  memcpy(right->u.inner.children, &children[mid + 1],
+         (right->count + 1) * sizeof(uint32_t));
+
+  *split = TRUE;
+  *split_key = keys[mid];
+  *split_page = right_page;
+  pool_release(tree, right, TRUE);
+  pool_release(tree, node, TRUE);
+  return SUCCESS;
+}
+
+Status index_remove(BTree *tree, int id) {
+  uint32_t page;
+  Status status = index_find_leaf(tree, id, &page);
+  if (status != SUCCESS) {
+    return status;
+  }
+
+  // Lazy delete: the key leaves its leaf, underfull nodes are not merged
+  // (separators stay valid bounds); a rebuild packs the tree again
+  BNode *leaf = pool_fetch(tree, page);
+  if (leaf == NULL) {
+    return ERR_INDEX_IO;
+  }
+  uint32_t pos = leaf_lower_bound(leaf, id);
+  if (pos >= leaf->count || leaf->u.leaf.keys[pos] != id) {
+    pool_release(tree, leaf, FALSE);
+    return ERR_RECORD_NOT_FOUND;
+  }
+  leaf->count--;
+  memmove(&leaf->u.leaf.keys[pos], &leaf->u.leaf.keys[pos + 1],
+          (leaf->count - pos) * sizeof(int32_t));
+  memmove(&leaf->u.leaf.slots[pos], &leaf->u.leaf.slots[pos + 1],
+          (leaf->count - pos) * sizeof(uint32_t));
+  pool_release(tree, leaf, TRUE);
+  tree->meta.keys--;
+  return SUCCESS;
+}
+
+Status index_find_leaf(BTree *tree, int id, uint32_t *leaf) {
+  uint32_t page = tree->meta.root;
+  for (int depth = 0; depth < MAX_HEIGHT; depth++) {
+    BNode *node = pool_fetch(tree, page);
+    if (node == NULL) {
+      return ERR_INDEX_IO;
+    }
+    int is_leaf = node->is_leaf;
+    uint32_t child = is_leaf ? page
+                             : node->u.inner.children[inner_child(node, id)];
+    pool_release(tree, node, FALSE);
+    if (is_leaf) {
+      *leaf = page;
+      return SUCCESS;
+    }
+    page = child;
+  }
+  return ERR_INDEX_IO;
+}
+
+Status index_seek(IndexCursor *cursor, BTree *tree, int id) {
+  cursor->tree = tree;
+  Status status = index_find_leaf(tree, id, &cursor->page);
+  if (status != SUCCESS) {
+    return status;
+  }
+  BNode *leaf = pool_fetch(tree, cursor->page);
+  if (leaf == NULL) {
+    return ERR_INDEX_IO;
+  }
+  cursor->pos = leaf_lower_bound(leaf, id);
+  pool_release(tree, leaf, FALSE);
+  return SUCCESS;
+}
+
+// Returns FALSE past the last key; empty leaves left by deletes are skipped
+int index_next(IndexCursor *cursor, int *id, uint32_t *slot) {
+  while (cursor->page != NO_PAGE) {
+    BNode *leaf = pool_fetch(cursor->tree, cursor->page);
+    if (leaf == NULL) {
+      return FALSE;
+    }
+    if (cursor->pos < leaf->count) {
+      *id = leaf->u.leaf.keys[cursor->pos];
+      *slot = leaf->u.leaf.slots[cursor->pos];
+      cursor->pos++;
+      pool_release(cursor->tree, leaf, FALSE);
+      return TRUE;
+    }
+    cursor->page = leaf->next;
+    cursor->pos = 0;
+    pool_release(cursor->tree, leaf, FALSE);
+  }
+  return FALSE;
+}
+
+uint32_t leaf_lower_bound(const BNode *node, int id) {
+  uint32_t low = 0;
+  uint32_t high = node->count;
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+    if (node->u.leaf.keys[mid] < id) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+uint32_t inner_child(const BNode *node, int id) {
+  // Number of separators <= id
+  uint32_t low = 0;
+  uint32_t high = node->count;
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+    if (node->u.inner.keys[mid] <= id) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+int compare_key_slots(const void *a, const void *b) {
+  const KeySlot *x = (const KeySlot *)a;
+  const KeySlot *y = (const KeySlot *)b;
+  if (x->key != y->key) {
+    return (x->key < y->key) ? -1 : 1;
+  }
+  return (x->slot > y->slot) - (x->slot < y->slot);
+}
+
+BNode *pool_fetch(BTree *tree, uint32_t page) {
+  Frame *frame = NULL;
+  for (int i = 0; i < POOL_FRAMES; i++) {
+    if (tree->frames[i].page == page) {
+      frame = &tree->frames[i];
+      break;
+    }
+  }
+
+  if (frame != NULL) {
+    tree->hits++;
+  } else {
+    frame = pool_victim(tree);
+    if (frame == NULL) {
+      return NULL;
+    }
+    off_t offset = (off_t)page * PAGE_BYTES;
+    if (page == NO_PAGE || page >= tree->meta.num_pages ||
+        pread(tree->fd, &frame->node, PAGE_BYTES, offset) != PAGE_BYTES ||
+        frame->node.count >
+            (frame->node.is_leaf ? LEAF_KEYS : INNER_KEYS)) {
+      return NULL;
+    }
+    frame->page = page;
+    frame->dirty = FALSE;
+    tree->misses++;
+  }
+  frame->pins++;
+  frame->last_used = ++tree->clock;
+  return &frame->node;
+}
+
+BNode *pool_new(BTree *tree, uint32_t *page, int is_leaf) {
+  Frame *frame = pool_victim(tree);
+  if (frame == NULL) {
+    return NULL;
+  }
+  // Appended at the end of the file; written out when evicted or flushed
+  *page = tree->meta.num_pages++;
+  memset(&frame->node, 0, sizeof(frame->node));
+  frame->node.is_leaf = (uint32_t)is_leaf;
+  frame->node.next = NO_PAGE;
+  frame->page = *page;
+  frame->dirty = TRUE;
+  frame->pins = 1;
+  frame->last_used = ++tree->clock;
+  return &frame->node;
+}
+
+void pool_release(BTree *tree, BNode *node, int dirty) {
+  Frame *frame = (Frame *)node;
+  (void)tree;
+  frame->pins--;
+  if (dirty) {
+    frame->dirty = TRUE;
+  }
+}
+
+// Least recently used unpinned frame, written back first if dirty
+Frame *pool_victim(BTree *tree) {
+  Frame *victim = NULL;
+  for (int i = 0; i < POOL_FRAMES; i++) {
+    Frame *frame = &tree->frames[i];
+    if (frame->page == NO_PAGE) {
+      return frame; // Never used
+    }
+    if (frame->pins == 0 &&
+        (victim == NULL || frame->last_used < victim->last_used)) {
+      victim = frame;
+    }
+  }
+  if (victim == NULL) {
+    return NULL;
+  }
+  if (victim->dirty &&
+      (pool_mark(tree) != SUCCESS ||
+       pwrite(tree->fd, &victim->node, PAGE_BYTES,
+              (off_t)victim->page * PAGE_BYTES) != PAGE_BYTES)) {
+    return NULL;
+  }
+  victim->page = NO_PAGE;
+  victim->dirty = FALSE;
+  return victim;
+}
+
+// Pages are overwritten in place, so the meta page on disk says the tree
+// is in flux before the first one goes out after a commit
+Status pool_mark(BTree *tree) {
+  if (tree->meta.dirty) {
+    return SUCCESS;
+  }
+  tree->meta.dirty = TRUE;
+  Status status = pool_write_meta(tree);
+  if (status != SUCCESS) {
+    tree->meta.dirty = FALSE;
+  }
+  return status;
+}
+
+Status pool_write_meta(BTree *tree) {
+  char meta_page[PAGE_BYTES];
+
+  memset(meta_page, 0, sizeof(meta_page));
+  memcpy(meta_page, &tree->meta, sizeof(tree->meta));
+  if (pwrite(tree->fd, meta_page, PAGE_BYTES, 0) != PAGE_BYTES ||
+      fdatasync(tree->fd) != 0) {
+    return ERR_INDEX_IO;
+  }
+  return SUCCESS;
+}
+
+// The nodes are on disk before the meta page that points at them, and the
+// meta page is on disk before a checkpoint can truncate the log. Only a
+// commit clears the mark; anything else leaves the tree to be rebuilt.
+Status pool_flush(BTree *tree, int commit) {
+  for (int i = 0; i < POOL_FRAMES; i++) {
+    Frame *frame = &tree->frames[i];
+    if (frame->page != NO_PAGE && frame->dirty) {
+      if (pool_mark(tree) != SUCCESS ||
+          pwrite(tree->fd, &frame->node, PAGE_BYTES,
+                 (off_t)frame->page * PAGE_BYTES) != PAGE_BYTES) {
+        return ERR_INDEX_IO;
+      }
+      frame->dirty = FALSE;
+    }
+  }
+
+  // Evicted pages were written without a sync of their own
+  if (tree->meta.dirty && fdatasync(tree->fd) != 0) {
+    return ERR_INDEX_IO;
+  }
+
+  if (commit) {
+    tree->meta.dirty = FALSE;
+  }
+  return pool_write_meta(tree);
+}
@@ -6,26 +6,79 @@
  ===============================================================================
  Features:
  - CSV File Reading and Parsing (handling commas)
- - Record Creation (Appending to CSV)
+ - Zero-copy CSV engine: mmap'd file, quotes/commas/newlines found 64 bytes
+   at a time with SSE2/AVX2 bitmasks, quoted regions from a prefix XOR of
+   the quote mask (RFC 4180: quoted commas, newlines and "" escapes),
+   fields returned as (pointer, length) views into the mapping
+ - Fast integer and decimal parsing straight from the field views
+ - Record Creation (Appending to CSV, quoting fields when needed)
  - Record Searching and Filtering
- - Data Statistics Calculation directly from CSV data
+ - Data Statistics Calculation directly from CSV data: count, Kahan-summed
+   payroll, highest earner and a per-department group-by
+ - Parallel statistics: quote parity counted per chunk, cuts moved to the
+   next unquoted newline, per-thread partial aggregates merged at the end
+ - Columnar binary cache (<csv>.col): id/salary columns, dictionary-coded
+   departments and a name heap, mmap'ed by display/search/statistics and
+   ignored once the CSV's size or mtime no longer match
+ - Sidecar ID index (<csv>.idx): (id, offset, length) entries sorted by ID,
+   binary-searched through mmap and followed by one pread() of the record;
+   new records are appended to it in place (out-of-order IDs go to a short
+   unsorted tail that is merged back when it fills up)
+ - Large CSV generator and parse benchmark (GB/s) against the line-based
+   fgets() + strtok() parser
  - Interactive menu and error handling
  ===============================================================================
 */
 
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
 
 #define FILENAME "employees.csv"
 #define TEMP_FILENAME "employees_tmp.csv"
+#define BIG_FILENAME "employees_big.csv"
 #define MAX_LINE 256
 #define MAX_NAME 50
 #define MAX_DEPT 50
+#define MAX_FIELD 256  // Unescaped copy of a field, for printing
+#define CSV_FIELDS 4   // ID,Name,Department,Salary
+#define CSV_BLOCK 64   // Bytes classified per step, one bit each
+#define MAX_DIGITS 19  // Fits in an unsigned 64-bit mantissa
 #define TRUE 1
 #define FALSE 0
 #define MIN_OPTION 1
-#define MAX_OPTION 6
+#define MAX_OPTION 12
+#define MAX_PATH 256
+#define MAX_THREADS 16
+#define MAX_GROUPS 1024    // Department slots per aggregate (power of two)
+#define GROUP_LIMIT 768    // Departments past this are counted as "other"
+#define CACHE_SUFFIX ".col"
+#define CACHE_MAGIC "EMPCOL1"  // 8 bytes with the NUL
+#define CACHE_VERSION 2
+#define DICT_SLOTS (1 << 17)   // Department dictionary while building
+#define MAX_DEPARTMENTS 65535  // Codes are 16-bit
+#define INDEX_SUFFIX ".idx"
+#define INDEX_MAGIC "EMPIDX1"
+#define INDEX_VERSION 1
+#define INDEX_TAIL_LIMIT 1024  // Unsorted appends before a merge
+#define INDEX_PROBES 1000      // Random lookups in the index benchmark
+#define IO_BUFFER (1 << 20)
+#define MB (1024 * 1024)
 
 typedef enum {
   SUCCESS,
@@ -34,7 +87,11 @@ typedef enum {
   ERR_FILE_NOT_FOUND,
   ERR_FILE_CREATE_FAILED,
   ERR_RECORD_NOT_FOUND,
-  ERR_PARSE_ERROR
+  ERR_PARSE_ERROR,
+  ERR_MEMORY_ALLOCATION,
+  ERR_CACHE_INVALID,
+  ERR_TOO_MANY_GROUPS,
+  ERR_INDEX_INVALID
 } Status;
 
 typedef struct {
@@ -44,6 +101,130 @@ typedef struct {
   float salary;
 } Employee;
 
+// A field inside the mapped file; nothing is copied
+typedef struct {
+  const char *ptr;
+  size_t len;
+  int quoted; // Surrounding quotes removed, may still hold "" escapes
+} FieldView;
+
+typedef struct {
+  int id;
+  FieldView name;
+  FieldView department;
+  double salary;
+} EmployeeView;
+
+typedef struct {
+  const char *data;
+  size_t size;
+  size_t base;         // Offset of the block in 'structural'
+  size_t next;         // Offset of the next block to classify
+  size_t field_start;  // First byte of the current field
+  uint64_t structural; // Unquoted commas/newlines not consumed yet
+  uint64_t in_quotes;  // All ones if the last block ended inside quotes
+} CsvCursor;
+
+// Compensated sum: the running error is fed back into the next addition
+typedef struct {
+  double sum;
+  double compensation;
+} KahanSum;
+
+typedef struct {
+  FieldView department; // ptr == NULL marks an empty slot
+  long long count;
+  KahanSum total;
+  double max_salary;
+} DeptStats;
+
+typedef struct {
+  long long count;
+  KahanSum total;
+  double max_salary;
+  int max_id;
+  FieldView max_earner;
+  long long other; // Records whose department did not fit in the table
+  int num_groups;
+  DeptStats groups[MAX_GROUPS];
+} CsvAggregate;
+
+// On-disk layout: this header, then 8-byte aligned columns at the offsets
+typedef struct {
+  char magic[8];
+  uint64_t version;
+  uint64_t csv_size;     // Source CSV the cache was built from
+  int64_t csv_mtime_sec;
+  int64_t csv_mtime_nsec;
+  uint64_t rows;
+  uint64_t departments;
+  uint64_t file_size;
+  uint64_t ids;          // int32_t[rows]
+  uint64_t salaries;     // double[rows]
+  uint64_t dept_codes;   // uint16_t[rows], index into the dictionary
+  uint64_t name_offsets; // uint64_t[rows + 1] into the name heap
+  uint64_t names;        // Unescaped names, back to back
+  uint64_t dict_offsets; // uint64_t[departments + 1] into the dictionary
+  uint64_t dict;         // Unescaped department names
+} CacheHeader;
+
+typedef struct {
+  const char *data;
+  size_t size;
+  const CacheHeader *header;
+  const int32_t *ids;
+  const double *salaries;
+  const uint16_t *dept_codes;
+  const uint64_t *name_offsets;
+  const char *names;
+  const uint64_t *dict_offsets;
+  const char *dict;
+} ColumnCache;
+
+typedef struct {
+  char *data;
+  size_t len;
+  size_t cap;
+} ByteBuffer;
+
+typedef struct {
+  FieldView department; // ptr == NULL marks an empty slot
+  uint16_t code;
+} DictSlot;
+
+typedef struct {
+  int32_t id;
+  uint32_t length; // Bytes of the record, line break included
+  uint64_t offset; // First byte of the record in the CSV
+} IndexEntry;
+
+// Followed by entries[0, sorted) in (id, offset) order, then the unsorted
+// tail [sorted, entries) in file order
+typedef struct {
+  char magic[8];
+  uint64_t version;
+  uint64_t csv_size;
+  int64_t csv_mtime_sec;
+  int64_t csv_mtime_nsec;
+  uint64_t sorted;
+  uint64_t entries;
+} IndexHeader;
+
+typedef struct {
+  const char *data;
+  size_t size;
+  const IndexHeader *header;
+  const IndexEntry *entries;
+} IdIndex;
+
+typedef struct {
+  const char *data;
+  size_t start; // Chunk [start, end); on record starts for aggregation
+  size_t end;
+  long long quotes;
+  CsvAggregate aggregate;
+} AggregateJob;
+
 void show_menu(void);
 void handle_error(Status status);
 
@@ -52,19 +233,110 @@ void run_add_record(void);
 void run_search_record(void);
 void run_calculate_stats(void);
 void run_create_dummy_csv(void);
+void run_generate_csv(void);
+void run_parse_benchmark(void);
+void run_parallel_stats(void);
+void run_build_cache(void);
+void run_cache_benchmark(void);
+void run_build_index(void);
 
 void clear_input_buffer(void);
 Status read_integer(int *value);
 Status read_float(float *value);
 Status read_string(char *buffer, int max_len);
+Status read_path(char *path, int max_len, const char *fallback);
+double now_seconds(void);
+int online_cpus(void);
 
 Status parse_csv_line(char *line, Employee *emp);
 
+const char *map_file(const char *path, size_t *size);
+void unmap_file(const char *data, size_t size);
+void csv_cursor_init(CsvCursor *cursor, const char *data, size_t size);
+int csv_next_record(CsvCursor *cursor, FieldView *fields, int max_fields);
+int csv_load_block(CsvCursor *cursor);
+void csv_store_field(FieldView *fields, int max_fields, int index,
+                     const char *p, size_t len, int end_of_record);
+void csv_block_masks(const char *p, uint64_t *quotes, uint64_t *separators);
+#ifdef __x86_64__
+void csv_block_masks_avx2(const char *p, uint64_t *quotes,
+                          uint64_t *separators);
+#endif
+uint64_t prefix_xor(uint64_t bits);
+Status view_to_employee(const FieldView *fields, int count,
+                        EmployeeView *emp);
+int parse_int_field(FieldView field, long long *value);
+int parse_decimal_field(FieldView field, double *value);
+const char *field_text(FieldView field, char *buffer, size_t size);
+size_t field_next(FieldView field, size_t i);
+int field_equal(FieldView a, FieldView b);
+void write_csv_field(FILE *file, const char *text);
+
+void aggregate_init(CsvAggregate *agg);
+void aggregate_range(const char *data, size_t size, CsvAggregate *agg);
+void aggregate_record(CsvAggregate *agg, const EmployeeView *emp);
+void aggregate_merge(CsvAggregate *total, const CsvAggregate *part);
+DeptStats *find_group(CsvAggregate *agg, FieldView department);
+Status aggregate_parallel(const char *data, size_t size, int num_threads,
+                          CsvAggregate *total);
+void run_jobs(AggregateJob *jobs, int num_jobs, void *(*worker)(void *));
+void *quote_worker(void *arg);
+void *aggregate_worker(void *arg);
+size_t next_record_start(const char *data, size_t size, size_t from,
+                         int in_quotes);
+long long count_quotes(const char *p, size_t n);
+#ifdef __x86_64__
+long long count_quotes_avx2(const char *p, size_t n);
+#endif
+void kahan_add(KahanSum *k, double value);
+double kahan_value(const KahanSum *k);
+void show_aggregate(const CsvAggregate *agg);
+int compare_groups(const void *a, const void *b);
+
+void cache_path(const char *csv_path, char *path, size_t size);
+Status cache_build(const char *csv_path, long long *rows);
+Status cache_write(const char *csv_path, const struct stat *st,
+                   ByteBuffer columns[], uint64_t rows, uint64_t departments);
+Status cache_open(const char *csv_path, ColumnCache *cache, int check_rows);
+void cache_close(ColumnCache *cache);
+void cache_remove(const char *csv_path);
+int cache_check(const ColumnCache *cache);
+int cache_check_row(const ColumnCache *cache, uint64_t row);
+void cache_display(const ColumnCache *cache);
+long long cache_find_id(const ColumnCache *cache, int id);
+Status cache_aggregate(const ColumnCache *cache, CsvAggregate *agg);
+FieldView cache_name(const ColumnCache *cache, uint64_t row);
+FieldView cache_department(const ColumnCache *cache, uint64_t code);
+int dict_code(DictSlot *slots, FieldView department, uint64_t *count);
+Status buffer_append(ByteBuffer *b, const void *src, size_t n);
+Status buffer_append_field(ByteBuffer *b, FieldView field);
+Status buffer_pad(ByteBuffer *b);
+
+void index_path(const char *csv_path, char *path, size_t size);
+Status index_build(const char *csv_path, long long *entries);
+Status index_write(const char *csv_path, const struct stat *st,
+                   IndexEntry *entries, uint64_t count);
+Status index_open(const char *csv_path, IdIndex *index);
+void index_close(IdIndex *index);
+const IndexEntry *index_find(const IdIndex *index, int id);
+Status index_fetch(const char *csv_path, const IndexEntry *entry,
+                   char **record, EmployeeView *emp);
+Status index_append(const char *csv_path, const struct stat *before,
+                    const struct stat *after, const IndexEntry *entry);
+int index_matches(const IndexHeader *header, const struct stat *st);
+int compare_entries(const void *a, const void *b);
+void show_employee(const char *title, const EmployeeView *emp);
+
+int use_avx2 = FALSE;
+
 int main(void) {
   int option = 0;
 
   // Initialize a dummy CSV file if it doesn't exist
   run_create_dummy_csv();
+#ifdef __x86_64__
+  use_avx2 = __builtin_cpu_supports("avx2");
+#endif
 
   while (TRUE) {
     show_menu();
@@ -103,6 +375,24 @@ int main(void) {
       run_create_dummy_csv();
       printf("\n  - CSV file reset to default dummy data.\n\n");
       break;
+    case 6:
+      run_generate_csv();
+      break;
+    case 7:
+      run_parse_benchmark();
+      break;
+    case 8:
+      run_parallel_stats();
+      break;
+    case 9:
+      run_build_cache();
+      break;
+    case 10:
+      run_cache_benchmark();
+      break;
+    case 11:
+      run_build_index();
+      break;
     }
   }
 
@@ -117,7 +407,13 @@ void show_menu(void) {
   printf("3. Search Record by ID\n");
   printf("4. Calculate Statistics\n");
   printf("5. Reset/Create Dummy CSV\n");
-  printf("6. Exit\n");
+  printf("6. Generate Large CSV (%s)\n", BIG_FILENAME);
+  printf("7. Parse Benchmark (strtok vs SIMD engine)\n");
+  printf("8. Parallel Statistics (multi-threaded)\n");
+  printf("9. Build Columnar Cache\n");
+  printf("10. Cache Benchmark (re-parse vs columns)\n");
+  printf("11. Build ID Index\n");
+  printf("12. Exit\n");
   printf("Option: ");
 }
 
@@ -141,11 +437,24 @@ void handle_error(Status status) {
   case ERR_PARSE_ERROR:
     printf("Error: Failed to parse CSV line format.\n\n");
     break;
+  case ERR_MEMORY_ALLOCATION:
+    printf("Error: Memory allocation failed.\n\n");
+    break;
+  case ERR_CACHE_INVALID:
+    printf("Error: Columnar cache missing, stale or corrupt.\n\n");
+    break;
+  case ERR_TOO_MANY_GROUPS:
+    printf("Error: Too many distinct departments for the cache.\n\n");
+    break;
+  case ERR_INDEX_INVALID:
+    printf("Error: ID index missing, stale or corrupt.\n\n");
+    break;
   case SUCCESS:
     break;
   }
 }
 
+// Line-based parser: no quoting, kept as the benchmark baseline
 Status parse_csv_line(char *line, Employee *emp) {
   // We expect: ID,Name,Department,Salary
   char *token;
@@ -187,31 +496,41 @@ Status parse_csv_line(char *line, Employee *emp) {
 }
 
 void run_display_all(void) {
-  FILE *file = fopen(FILENAME, "r");
-  if (!file) {
+  ColumnCache cache;
+  if (cache_open(FILENAME, &cache, TRUE) == SUCCESS) {
+    cache_display(&cache);
+    cache_close(&cache);
+    return;
+  }
+
+  size_t size = 0;
+  const char *data = map_file(FILENAME, &size);
+  if (data == NULL) {
     handle_error(ERR_FILE_NOT_FOUND);
     return;
   }
 
-  char buffer[MAX_LINE];
-  Employee emp;
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView emp;
+  char name[MAX_FIELD];
+  char department[MAX_FIELD];
   int count = 0;
+  int n;
 
   printf("\n=== Employee Records ===\n");
   printf("%-5s | %-20s | %-15s | %-10s\n", "ID", "Name", "Department",
          "Salary");
   printf("------------------------------------------------------------\n");
 
-  // Read lines
-  while (fgets(buffer, sizeof(buffer), file)) {
-    // Skip header line if it exists
-    if (count == 0 && strncmp(buffer, "ID,Name", 7) == 0) {
-      continue;
-    }
-
-    if (parse_csv_line(buffer, &emp) == SUCCESS) {
-      printf("%-5d | %-20s | %-15s | $%-9.2f\n", emp.id, emp.name,
-             emp.department, emp.salary);
+  // The header fails the numeric ID check and is skipped like bad lines
+  csv_cursor_init(&cursor, data, size);
+  while ((n = csv_next_record(&cursor, fields, CSV_FIELDS)) >= 0) {
+    if (view_to_employee(fields, n, &emp) == SUCCESS) {
+      printf("%-5d | %-20s | %-15s | $%-9.2f\n", emp.id,
+             field_text(emp.name, name, sizeof(name)),
+             field_text(emp.department, department, sizeof(department)),
+             emp.salary);
       count++;
     }
   }
@@ -223,7 +542,7 @@ void run_display_all(void) {
   printf("------------------------------------------------------------\n");
   printf("  - Total valid records parsed: %d\n\n", count);
 
-  fclose(file);
+  unmap_file(data, size);
 }
 
 void run_add_record(void) {
@@ -237,37 +556,30 @@ void run_add_record(void) {
     return;
   }
 
+  // Commas and quotes are fine: write_csv_field() quotes them
   printf("Name: ");
   if (read_string(emp.name, MAX_NAME) != SUCCESS) {
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
-  // Basic sanity check: prevent commas in names for simple CSV format
-  if (strchr(emp.name, ',')) {
-    printf(
-        "Error: Commas not allowed in input for this simple CSV format.\n\n");
-    return;
-  }
-
   printf("Department: ");
   if (read_string(emp.department, MAX_DEPT) != SUCCESS) {
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
-  if (strchr(emp.department, ',')) {
-    printf(
-        "Error: Commas not allowed in input for this simple CSV format.\n\n");
-    return;
-  }
-
   printf("Salary: ");
   if (read_float(&emp.salary) != SUCCESS) {
     handle_error(ERR_INVALID_INPUT);
     return;
   }
 
+  // The index is only extended if it described the file before the append
+  struct stat before;
+  struct stat after;
+  int existed = (stat(FILENAME, &before) == 0);
+
   FILE *file = fopen(FILENAME, "a");
   if (!file) {
     handle_error(ERR_FILE_CREATE_FAILED);
@@ -282,11 +594,23 @@ void run_add_record(void) {
 
   // Note: if file doesn't end with newline, this might append to same line,
   // but we enforce newlines in our writes.
-  fprintf(file, "%d,%s,%s,%.2f\n", emp.id, emp.name, emp.department,
-          emp.salary);
+  IndexEntry entry;
+  entry.id = emp.id;
+  entry.offset = (uint64_t)ftell(file);
+  fprintf(file, "%d,", emp.id);
+  write_csv_field(file, emp.name);
+  fputc(',', file);
+  write_csv_field(file, emp.department);
+  fprintf(file, ",%.2f\n", emp.salary);
+  entry.length = (uint32_t)((uint64_t)ftell(file) - entry.offset);
   fclose(file);
 
-  printf("\n  - Record added successfully to %s\n\n", FILENAME);
+  printf("\n  - Record added successfully to %s\n", FILENAME);
+  if (existed && stat(FILENAME, &after) == 0 &&
+      index_append(FILENAME, &before, &after, &entry) == SUCCESS) {
+    printf("  - ID index updated\n");
+  }
+  printf("\n");
 }
 
 void run_search_record(void) {
@@ -297,34 +621,76 @@ void run_search_record(void) {
     return;
   }
 
-  FILE *file = fopen(FILENAME, "r");
-  if (!file) {
+  // The index answers with a few page reads; it is authoritative when valid
+  IdIndex index;
+  if (index_open(FILENAME, &index) == SUCCESS) {
+    const IndexEntry *entry = index_find(&index, search_id);
+    char *record = NULL;
+    EmployeeView found;
+    Status status = (entry != NULL)
+                        ? index_fetch(FILENAME, entry, &record, &found)
+                        : ERR_RECORD_NOT_FOUND;
+    index_close(&index);
+    if (status == SUCCESS) {
+      show_employee("Record Found (ID index)", &found);
+    }
+    free(record);
+    if (status != ERR_INDEX_INVALID) {
+      if (status != SUCCESS) {
+        handle_error(status);
+      }
+      return;
+    }
+  }
+
+  // One pass over the ID column; only the row found is checked
+  char text[MAX_FIELD];
+  ColumnCache cache;
+  long long row = -1;
+  if (cache_open(FILENAME, &cache, FALSE) == SUCCESS) {
+    row = cache_find_id(&cache, search_id);
+    if (row >= 0 && !cache_check_row(&cache, (uint64_t)row)) {
+      cache_close(&cache);
+      cache_remove(FILENAME);
+    }
+  }
+  if (cache.data != NULL) {
+    if (row >= 0) {
+      printf("\n=== Record Found (columnar cache) ===\n");
+      printf("  - ID:         %d\n", cache.ids[row]);
+      printf("  - Name:       %s\n",
+             field_text(cache_name(&cache, row), text, sizeof(text)));
+      printf("  - Department: %s\n",
+             field_text(cache_department(&cache, cache.dept_codes[row]), text,
+                        sizeof(text)));
+      printf("  - Salary:     $%.2f\n\n", cache.salaries[row]);
+    } else {
+      handle_error(ERR_RECORD_NOT_FOUND);
+    }
+    cache_close(&cache);
+    return;
+  }
+
+  size_t size = 0;
+  const char *data = map_file(FILENAME, &size);
+  if (data == NULL) {
     handle_error(ERR_FILE_NOT_FOUND);
     return;
   }
 
-  char buffer[MAX_LINE];
-  Employee emp;
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView emp;
   int found = 0;
-  int is_first_line = 1;
-
-  while (fgets(buffer, sizeof(buffer), file)) {
-    if (is_first_line && strncmp(buffer, "ID,Name", 7) == 0) {
-      is_first_line = 0;
-      continue;
-    }
-    is_first_line = 0;
-
-    if (parse_csv_line(buffer, &emp) == SUCCESS) {
-      if (emp.id == search_id) {
-        printf("\n=== Record Found ===\n");
-        printf("  - ID:         %d\n", emp.id);
-        printf("  - Name:       %s\n", emp.name);
-        printf("  - Department: %s\n", emp.department);
-        printf("  - Salary:     $%.2f\n\n", emp.salary);
-        found = 1;
-        break;
-      }
+  int n;
+
+  csv_cursor_init(&cursor, data, size);
+  while ((n = csv_next_record(&cursor, fields, CSV_FIELDS)) >= 0) {
+    if (view_to_employee(fields, n, &emp) == SUCCESS &&
+        emp.id == search_id) {
+      show_employee("Record Found", &emp);
+      found = 1;
+      break;
     }
   }
 
@@ -332,52 +698,46 @@ void run_search_record(void) {
     handle_error(ERR_RECORD_NOT_FOUND);
   }
 
-  fclose(file);
+  unmap_file(data, size);
 }
 
 void run_calculate_stats(void) {
-  FILE *file = fopen(FILENAME, "r");
-  if (!file) {
-    handle_error(ERR_FILE_NOT_FOUND);
+  CsvAggregate *agg = (CsvAggregate *)malloc(sizeof(CsvAggregate));
+  if (agg == NULL) {
+    handle_error(ERR_MEMORY_ALLOCATION);
     return;
   }
 
-  char buffer[MAX_LINE];
-  Employee emp;
-  int count = 0;
-  float total_salary = 0.0f;
-  float max_salary = -1.0f;
-  char max_earner[MAX_NAME] = "";
-  int is_first_line = 1;
-
-  while (fgets(buffer, sizeof(buffer), file)) {
-    if (is_first_line && strncmp(buffer, "ID,Name", 7) == 0) {
-      is_first_line = 0;
-      continue;
-    }
-    is_first_line = 0;
-
-    if (parse_csv_line(buffer, &emp) == SUCCESS) {
-      count++;
-      total_salary += emp.salary;
-      if (emp.salary > max_salary) {
-        max_salary = emp.salary;
-        strcpy(max_earner, emp.name);
-      }
+  ColumnCache cache;
+  if (cache_open(FILENAME, &cache, TRUE) == SUCCESS) {
+    Status status = cache_aggregate(&cache, agg);
+    if (status == SUCCESS) {
+      printf("\n=== CSV Statistics (columnar cache) ===\n");
+      show_aggregate(agg);
+    } else {
+      handle_error(status);
     }
+    cache_close(&cache);
+    free(agg);
+    return;
   }
 
-  fclose(file);
+  size_t size = 0;
+  const char *data = map_file(FILENAME, &size);
+  if (data == NULL) {
+    free(agg);
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+  aggregate_init(agg);
+  aggregate_range(data, size, agg);
 
   printf("\n=== CSV Statistics ===\n");
-  if (count > 0) {
-    printf("  - Total Employees: %d\n", count);
-    printf("  - Avg Salary:      $%.2f\n", total_salary / count);
-    printf("  - Total Payroll:   $%.2f\n", total_salary);
-    printf("  - Highest Earner:  %s ($%.2f)\n\n", max_earner, max_salary);
-  } else {
-    printf("  - No data available to calculate statistics.\n\n");
-  }
+  show_aggregate(agg);
+
+  // The highest earner's name points into the mapping
+  free(agg);
+  unmap_file(data, size);
 }
 
 void run_create_dummy_csv(void) {
@@ -398,6 +758,403 @@ void run_create_dummy_csv(void) {
   }
 }
 
+void run_generate_csv(void) {
+  static const char *first[] = {"Ada",   "Alan",  "Grace", "Edgar",
+                                "Barbara", "Dennis", "Ken", "Linus",
+                                "Margaret", "Donald", "Frances", "John"};
+  static const char *last[] = {"Lovelace", "Turing",  "Hopper",  "Codd",
+                               "Liskov",   "Ritchie", "Thompson", "Torvalds",
+                               "Hamilton", "Knuth",   "Allen",   "Backus"};
+  static const char *departments[] = {"Engineering", "Research",
+                                      "Management",  "Database",
+                                      "Operations",  "Sales"};
+  const int num_first = (int)(sizeof(first) / sizeof(first[0]));
+  const int num_last = (int)(sizeof(last) / sizeof(last[0]));
+  const int num_departments =
+      (int)(sizeof(departments) / sizeof(departments[0]));
+  int size_mb = 0;
+
+  printf("\nEnter size in MB (e.g., 1024): ");
+  if (read_integer(&size_mb) != SUCCESS || size_mb <= 0) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  FILE *file = fopen(BIG_FILENAME, "w");
+  char *buffer = (char *)malloc(IO_BUFFER + MAX_LINE);
+  if (file == NULL || buffer == NULL) {
+    if (file != NULL) {
+      fclose(file);
+    }
+    free(buffer);
+    handle_error(buffer == NULL ? ERR_MEMORY_ALLOCATION
+                                : ERR_FILE_CREATE_FAILED);
+    return;
+  }
+
+  long long target = (long long)size_mb * MB;
+  long long written = 0;
+  long records = 0;
+  double start = now_seconds();
+  int used = snprintf(buffer, MAX_LINE, "ID,Name,Department,Salary\n");
+  while (written < target) {
+    while (used < IO_BUFFER) {
+      const char *f = first[rand() % num_first];
+      const char *l = last[rand() % num_last];
+      const char *d = departments[rand() % num_departments];
+      int cents = 3000000 + rand() % 20000000;
+      int kind = rand() % 16;
+      records++;
+
+      // Mostly plain fields, some quoted ones the line parser cannot read
+      if (kind == 0) {
+        used += snprintf(buffer + used, MAX_LINE, "%ld,\"%s, %s\",%s,%d.%02d\n",
+                         records, l, f, d, cents / 100, cents % 100);
+      } else if (kind == 1) {
+        used += snprintf(buffer + used, MAX_LINE,
+                         "%ld,\"%s \"\"%.3s\"\" %s\",%s,%d.%02d\n", records,
+                         f, f, l, d, cents / 100, cents % 100);
+      } else {
+        used += snprintf(buffer + used, MAX_LINE, "%ld,%s %s,%s,%d.%02d\n",
+                         records, f, l, d, cents / 100, cents % 100);
+      }
+    }
+    if (fwrite(buffer, 1, (size_t)used, file) != (size_t)used) {
+      break;
+    }
+    written += used;
+    used = 0;
+  }
+
+  fclose(file);
+  free(buffer);
+  printf("\n  - Wrote %lld bytes (%ld records) to '%s' in %.2f s\n\n",
+         written, records, BIG_FILENAME, now_seconds() - start);
+}
+
+void run_parse_benchmark(void) {
+  char buffer[MAX_LINE];
+  Employee emp;
+  long legacy_count = 0;
+  double legacy_sum = 0.0;
+
+  FILE *file = fopen(BIG_FILENAME, "r");
+  if (file == NULL) {
+    printf("\nError: %s not found (generate it first).\n\n", BIG_FILENAME);
+    return;
+  }
+
+  double start = now_seconds();
+  while (fgets(buffer, sizeof(buffer), file)) {
+    if (parse_csv_line(buffer, &emp) == SUCCESS && emp.id > 0) {
+      legacy_count++;
+      legacy_sum += emp.salary;
+    }
+  }
+  double legacy_time = now_seconds() - start;
+  fclose(file);
+
+  // Mapping is part of the engine's cost
+  start = now_seconds();
+  size_t size = 0;
+  const char *data = map_file(BIG_FILENAME, &size);
+  if (data == NULL) {
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView view;
+  long engine_count = 0;
+  long quoted = 0;
+  double engine_sum = 0.0;
+  int n;
+
+  csv_cursor_init(&cursor, data, size);
+  while ((n = csv_next_record(&cursor, fields, CSV_FIELDS)) >= 0) {
+    if (view_to_employee(fields, n, &view) == SUCCESS) {
+      engine_count++;
+      engine_sum += view.salary;
+      quoted += view.name.quoted;
+    }
+  }
+  double engine_time = now_seconds() - start;
+  unmap_file(data, size);
+
+  printf("\n=== Parse Benchmark: %s (%.1f MB) ===\n\n", BIG_FILENAME,
+         (double)size / MB);
+  printf("%-24s | %-9s | %-6s | %-10s | %s\n", "Parser", "Time (s)", "GB/s",
+         "Records", "Salary sum");
+  printf("-------------------------|-----------|--------|------------|"
+         "------------------\n");
+  printf("%-24s | %9.3f | %6.2f | %10ld | %17.2f\n", "fgets + strtok",
+         legacy_time, legacy_time > 0.0 ? size / legacy_time / 1e9 : 0.0,
+         legacy_count, legacy_sum);
+  printf("%-24s | %9.3f | %6.2f | %10ld | %17.2f\n",
+         use_avx2 ? "mmap + AVX2 bitmasks" : "mmap + SSE2 bitmasks",
+         engine_time, engine_time > 0.0 ? size / engine_time / 1e9 : 0.0,
+         engine_count, engine_sum);
+  printf("\n  - Quoted names: %ld (the strtok parser reads a wrong salary "
+         "for those\n    with a comma inside the quotes)\n\n",
+         quoted);
+}
+
+void run_parallel_stats(void) {
+  char path[MAX_PATH];
+
+  printf("\nEnter CSV path (leave empty for default '%s'): ", BIG_FILENAME);
+  if (read_path(path, sizeof(path), BIG_FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  size_t size = 0;
+  const char *data = map_file(path, &size);
+  CsvAggregate *single = (CsvAggregate *)malloc(sizeof(CsvAggregate));
+  CsvAggregate *parallel = (CsvAggregate *)malloc(sizeof(CsvAggregate));
+  if (data == NULL || single == NULL || parallel == NULL) {
+    handle_error(data == NULL ? ERR_FILE_NOT_FOUND : ERR_MEMORY_ALLOCATION);
+    if (data != NULL) {
+      unmap_file(data, size);
+    }
+    free(single);
+    free(parallel);
+    return;
+  }
+
+  int threads = online_cpus();
+  if (threads > MAX_THREADS) {
+    threads = MAX_THREADS;
+  }
+
+  double start = now_seconds();
+  aggregate_init(single);
+  aggregate_range(data, size, single);
+  double single_time = now_seconds() - start;
+
+  start = now_seconds();
+  Status status = aggregate_parallel(data, size, threads, parallel);
+  double parallel_time = now_seconds() - start;
+
+  if (status != SUCCESS) {
+    handle_error(status);
+  } else {
+    printf("\n=== Parallel Statistics: %s (%.1f MB) ===\n", path,
+           (double)size / MB);
+    show_aggregate(parallel);
+
+    printf("%-14s | %-9s | %s\n", "Mode", "Time (s)", "GB/s");
+    printf("---------------|-----------|--------\n");
+    printf("%-14s | %9.3f | %6.2f\n", "1 thread", single_time,
+           single_time > 0.0 ? size / single_time / 1e9 : 0.0);
+    printf("%2d threads     | %9.3f | %6.2f\n", threads, parallel_time,
+           parallel_time > 0.0 ? size / parallel_time / 1e9 : 0.0);
+    printf("\n  - Speedup: %.2fx, results %s\n\n",
+           parallel_time > 0.0 ? single_time / parallel_time : 0.0,
+           (single->count == parallel->count &&
+            single->max_id == parallel->max_id &&
+            single->num_groups == parallel->num_groups &&
+            fabs(kahan_value(&single->total) -
+                 kahan_value(&parallel->total)) < 0.01)
+               ? "match"
+               : "DIFFER");
+  }
+
+  free(single);
+  free(parallel);
+  unmap_file(data, size);
+}
+
+void run_build_cache(void) {
+  char path[MAX_PATH];
+  char col_path[MAX_PATH + 8];
+  long long rows = 0;
+
+  printf("\nEnter CSV path (leave empty for default '%s'): ", FILENAME);
+  if (read_path(path, sizeof(path), FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  double start = now_seconds();
+  Status status = cache_build(path, &rows);
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+
+  cache_path(path, col_path, sizeof(col_path));
+  printf("\n  - %lld records written to '%s' in %.2f s\n", rows, col_path,
+         now_seconds() - start);
+  printf("  - Used until '%s' changes size or modification time\n\n", path);
+}
+
+void run_cache_benchmark(void) {
+  char path[MAX_PATH];
+  char text[MAX_FIELD];
+  long long rows = 0;
+  ColumnCache cache;
+
+  printf("\nEnter CSV path (leave empty for default '%s'): ", BIG_FILENAME);
+  if (read_path(path, sizeof(path), BIG_FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  CsvAggregate *parsed = (CsvAggregate *)malloc(sizeof(CsvAggregate));
+  CsvAggregate *cached = (CsvAggregate *)malloc(sizeof(CsvAggregate));
+  if (parsed == NULL || cached == NULL) {
+    free(parsed);
+    free(cached);
+    handle_error(ERR_MEMORY_ALLOCATION);
+    return;
+  }
+
+  // Build only when missing or stale, like any later query would
+  double build_time = 0.0;
+  Status status = cache_open(path, &cache, FALSE);
+  if (status == SUCCESS) {
+    cache_close(&cache);
+  } else {
+    double start = now_seconds();
+    status = cache_build(path, &rows);
+    build_time = now_seconds() - start;
+  }
+  if (status != SUCCESS) {
+    free(parsed);
+    free(cached);
+    handle_error(status);
+    return;
+  }
+
+  // Statistics: parse the CSV again vs scan the columns
+  double start = now_seconds();
+  size_t size = 0;
+  const char *data = map_file(path, &size);
+  if (data == NULL) {
+    free(parsed);
+    free(cached);
+    handle_error(ERR_FILE_NOT_FOUND);
+    return;
+  }
+  aggregate_init(parsed);
+  aggregate_range(data, size, parsed);
+  double parse_time = now_seconds() - start;
+
+  start = now_seconds();
+  status = cache_open(path, &cache, TRUE);
+  if (status == SUCCESS) {
+    status = cache_aggregate(&cache, cached);
+  }
+  double column_time = now_seconds() - start;
+
+  // Search for the last record: worst case for both
+  int last_id = (status == SUCCESS && cache.header->rows > 0)
+                    ? cache.ids[cache.header->rows - 1]
+                    : 0;
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView emp;
+  int n;
+  start = now_seconds();
+  csv_cursor_init(&cursor, data, size);
+  while ((n = csv_next_record(&cursor, fields, CSV_FIELDS)) >= 0) {
+    if (view_to_employee(fields, n, &emp) == SUCCESS && emp.id == last_id) {
+      break;
+    }
+  }
+  double parse_search = now_seconds() - start;
+
+  start = now_seconds();
+  long long row = (status == SUCCESS) ? cache_find_id(&cache, last_id) : -1;
+  double column_search = now_seconds() - start;
+
+  if (status != SUCCESS) {
+    handle_error(status);
+  } else {
+    printf("\n=== Columnar Cache: %s (%.1f MB, %llu rows, %.1f MB cache) "
+           "===\n\n",
+           path, (double)size / MB, (unsigned long long)cache.header->rows,
+           (double)cache.size / MB);
+    if (build_time > 0.0) {
+      printf("  - Cache built in %.3f s\n\n", build_time);
+    }
+    printf("%-22s | %-12s | %-12s | %s\n", "Query", "Re-parse (s)",
+           "Columns (s)", "Speedup");
+    printf("-----------------------|--------------|--------------|--------\n");
+    printf("%-22s | %12.4f | %12.4f | %6.1fx\n", "Statistics + group-by",
+           parse_time, column_time,
+           column_time > 0.0 ? parse_time / column_time : 0.0);
+    printf("%-22s | %12.4f | %12.4f | %6.1fx\n", "Search last ID",
+           parse_search, column_search,
+           column_search > 0.0 ? parse_search / column_search : 0.0);
+    printf("\n  - Results %s (highest earner: %s)\n\n",
+           (parsed->count == cached->count &&
+            parsed->max_id == cached->max_id &&
+            parsed->num_groups == cached->num_groups &&
+            fabs(kahan_value(&parsed->total) - kahan_value(&cached->total)) <
+                0.01 &&
+            row >= 0)
+               ? "match"
+               : "DIFFER",
+           field_text(cached->max_earner, text, sizeof(text)));
+    cache_close(&cache);
+  }
+
+  unmap_file(data, size);
+  free(parsed);
+  free(cached);
+}
+
+void run_build_index(void) {
+  char path[MAX_PATH];
+  char idx_path[MAX_PATH + 8];
+  long long entries = 0;
+  IdIndex index;
+
+  printf("\nEnter CSV path (leave empty for default '%s'): ", FILENAME);
+  if (read_path(path, sizeof(path), FILENAME) != SUCCESS) {
+    handle_error(ERR_INVALID_INPUT);
+    return;
+  }
+
+  double start = now_seconds();
+  Status status = index_build(path, &entries);
+  if (status == SUCCESS) {
+    status = index_open(path, &index);
+  }
+  if (status != SUCCESS) {
+    handle_error(status);
+    return;
+  }
+  index_path(path, idx_path, sizeof(idx_path));
+  printf("\n  - %lld IDs written to '%s' in %.2f s\n", entries, idx_path,
+         now_seconds() - start);
+
+  // Random point lookups: binary search plus one pread() each
+  int failures = 0;
+  start = now_seconds();
+  for (int i = 0; i < INDEX_PROBES && entries > 0; i++) {
+    const IndexEntry *probe = &index.entries[(uint64_t)rand() % entries];
+    const IndexEntry *entry = index_find(&index, probe->id);
+    char *record = NULL;
+    EmployeeView emp;
+    if (entry == NULL ||
+        index_fetch(path, entry, &record, &emp) != SUCCESS) {
+      failures++;
+    }
+    free(record);
+  }
+  double elapsed = now_seconds() - start;
+  if (entries > 0) {
+    printf("  - %d random lookups: %.1f us each, %d failed\n", INDEX_PROBES,
+           elapsed * 1e6 / INDEX_PROBES, failures);
+  }
+  printf("  - Kept up to date by 'Add New Record'\n\n");
+  index_close(&index);
+}
+
 void clear_input_buffer(void) {
   int c;
   while ((c = getchar()) != '\n' && c != EOF) {
@@ -435,3 +1192,1379 @@ Status read_string(char *buffer, int max_len) {
   }
   return SUCCESS;
 }
+
+Status read_path(char *path, int max_len, const char *fallback) {
+  if (read_string(path, max_len) != SUCCESS) {
+    return ERR_INVALID_INPUT;
+  }
+  if (strlen(path) == 0) {
+    strcpy(path, fallback);
+  }
+  return SUCCESS;
+}
+
+double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int online_cpus(void) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return (cpus > 0) ? (int)cpus : 1;
+}
+
+const char *map_file(const char *path, size_t *size) {
+  struct stat st;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+
+  *size = (size_t)st.st_size;
+  if (*size == 0) {
+    close(fd);
+    return ""; // Nothing to map; unmap_file() skips size 0
+  }
+
+  void *data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return NULL;
+  }
+  madvise(data, *size, MADV_SEQUENTIAL);
+  return (const char *)data;
+}
+
+void unmap_file(const char *data, size_t size) {
+  if (size > 0) {
+    munmap((void *)data, size);
+  }
+}
+
+void csv_cursor_init(CsvCursor *cursor, const char *data, size_t size) {
+  memset(cursor, 0, sizeof(*cursor));
+  cursor->data = data;
+  cursor->size = size;
+}
+
+// Returns the number of fields in the record (only the first max_fields
+// are stored), or -1 at the end of the data
+int csv_next_record(CsvCursor *cursor, FieldView *fields, int max_fields) {
+  int count = 0;
+
+  if (cursor->field_start >= cursor->size) {
+    return -1;
+  }
+
+  while (TRUE) {
+    while (cursor->structural == 0) {
+      if (!csv_load_block(cursor)) {
+        // Last record without a trailing newline
+        csv_store_field(fields, max_fields, count,
+                        cursor->data + cursor->field_start,
+                        cursor->size - cursor->field_start, TRUE);
+        cursor->field_start = cursor->size;
+        return count + 1;
+      }
+    }
+
+    size_t pos = cursor->base + (size_t)__builtin_ctzll(cursor->structural);
+    cursor->structural &= cursor->structural - 1;
+
+    int end_of_record = (cursor->data[pos] == '\n');
+    csv_store_field(fields, max_fields, count,
+                    cursor->data + cursor->field_start,
+                    pos - cursor->field_start, end_of_record);
+    count++;
+    cursor->field_start = pos + 1;
+    if (end_of_record) {
+      return count;
+    }
+  }
+}
+
+int csv_load_block(CsvCursor *cursor) {
+  char tail[CSV_BLOCK];
+  uint64_t quotes = 0;
+  uint64_t separators = 0;
+
+  if (cursor->next >= cursor->size) {
+    return FALSE;
+  }
+
+  // The last partial block is classified from a zero-padded copy
+  const char *p = cursor->data + cursor->next;
+  if (cursor->size - cursor->next < CSV_BLOCK) {
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail, p, cursor->size - cursor->next);
+    p = tail;
+  }
+
+#ifdef __x86_64__
+  if (use_avx2) {
+    csv_block_masks_avx2(p, &quotes, &separators);
+  } else {
+    csv_block_masks(p, &quotes, &separators);
+  }
+#else
+  csv_block_masks(p, &quotes, &separators);
+#endif
+
+  // Bit i of 'inside' is set when byte i sits between an odd number of
+  // quotes; "" escapes toggle twice and leave the state unchanged
+  uint64_t inside = prefix_xor(quotes) ^ cursor->in_quotes;
+  cursor->in_quotes = (uint64_t)((int64_t)inside >> 63);
+  cursor->structural = separators & ~inside;
+  cursor->base = cursor->next;
+  cursor->next += CSV_BLOCK;
+  return TRUE;
+}
+
+void csv_store_field(FieldView *fields, int max_fields, int index,
+                     const char *p, size_t len, int end_of_record) {
+  if (index >= max_fields) {
+    return;
+  }
+
+  // CRLF line endings
+  if (end_of_record && len > 0 && p[len - 1] == '\r') {
+    len--;
+  }
+
+  FieldView *field = &fields[index];
+  field->quoted = (len > 0 && p[0] == '"');
+  if (field->quoted) {
+    p++;
+    len--;
+    if (len > 0 && p[len - 1] == '"') {
+      len--;
+    }
+  }
+  field->ptr = p;
+  field->len = len;
+}
+
+void csv_block_masks(const char *p, uint64_t *quotes, uint64_t *separators) {
+  *quotes = 0;
+  *separators = 0;
+
+#ifdef __x86_64__
+  // SSE2 (always present on x86_64): four 16-byte compares per class
+  __m128i quote = _mm_set1_epi8('"');
+  __m128i comma = _mm_set1_epi8(',');
+  __m128i newline = _mm_set1_epi8('\n');
+  for (int i = 0; i < CSV_BLOCK / 16; i++) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(p + i * 16));
+    uint64_t q = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote));
+    uint64_t s = (uint16_t)_mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, newline)));
+    *quotes |= q << (i * 16);
+    *separators |= s << (i * 16);
+  }
+#else
+  for (int i = 0; i < CSV_BLOCK; i++) {
+    *quotes |= (uint64_t)(p[i] == '"') << i;
+    *separators |= (uint64_t)(p[i] == ',' || p[i] == '\n') << i;
+  }
+#endif
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) void
+csv_block_masks_avx2(const char *p, uint64_t *quotes, uint64_t *separators) {
+  __m256i quote = _mm256_set1_epi8('"');
+  __m256i comma = _mm256_set1_epi8(',');
+  __m256i newline = _mm256_set1_epi8('\n');
+  __m256i lo = _mm256_loadu_si256((const __m256i *)p);
+  __m256i hi = _mm256_loadu_si256((const __m256i *)(p + 32));
+
+  uint64_t q_lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, quote));
+  uint64_t q_hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, quote));
+  uint64_t s_lo = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+      _mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline)));
+  uint64_t s_hi = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+      _mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline)));
+
+  *quotes = q_lo | (q_hi << 32);
+  *separators = s_lo | (s_hi << 32);
+}
+#endif
+
+uint64_t prefix_xor(uint64_t bits) {
+  // Bit i becomes the XOR of bits 0..i (what PCLMULQDQ by ~0 computes)
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+Status view_to_employee(const FieldView *fields, int count,
+                        EmployeeView *emp) {
+  long long id = 0;
+
+  // The index and the cache store 32-bit IDs: wider ones are invalid,
+  // never truncated into some other ID
+  if (count < CSV_FIELDS || !parse_int_field(fields[0], &id) ||
+      id < INT_MIN || id > INT_MAX ||
+      !parse_decimal_field(fields[3], &emp->salary)) {
+    return ERR_PARSE_ERROR;
+  }
+  emp->id = (int)id;
+  emp->name = fields[1];
+  emp->department = fields[2];
+  return SUCCESS;
+}
+
+int parse_int_field(FieldView field, long long *value) {
+  const char *p = field.ptr;
+  const char *end = field.ptr + field.len;
+  int negative = (p < end && *p == '-');
+  unsigned long long result = 0;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    p++;
+  }
+  if (p == end || end - p > MAX_DIGITS - 1) {
+    return FALSE;
+  }
+  for (; p < end; p++) {
+    unsigned digit = (unsigned)(*p - '0');
+    if (digit > 9) {
+      return FALSE;
+    }
+    result = result * 10 + digit;
+  }
+
+  *value = negative ? -(long long)result : (long long)result;
+  return TRUE;
+}
+
+int parse_decimal_field(FieldView field, double *value) {
+  // Powers of ten that are exact in a double
+  static const double exact[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                 1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char *p = field.ptr;
+  const char *end = field.ptr + field.len;
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int scale = 0; // Digits after the point
+  int negative = (p < end && *p == '-');
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    p++;
+  }
+  for (; p < end && (unsigned)(*p - '0') <= 9; p++, digits++) {
+    mantissa = mantissa * 10 + (unsigned)(*p - '0');
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && (unsigned)(*p - '0') <= 9; p++, digits++, scale++) {
+      mantissa = mantissa * 10 + (unsigned)(*p - '0');
+    }
+  }
+
+  // Mantissa and power of ten both exact: one division, correctly
+  // rounded. Anything else (exponents, long digits) goes to strtod().
+  if (p == end && digits > 0 && digits <= 15) {
+    double result = (double)mantissa / exact[scale];
+    *value = negative ? -result : result;
+    return TRUE;
+  }
+
+  char buffer[MAX_FIELD];
+  char *stop = NULL;
+  if (field.len == 0 || field.len >= sizeof(buffer)) {
+    return FALSE;
+  }
+  memcpy(buffer, field.ptr, field.len);
+  buffer[field.len] = '\0';
+  *value = strtod(buffer, &stop);
+  return stop == buffer + field.len;
+}
+
+const char *field_text(FieldView field, char *buffer, size_t size) {
+  size_t out = 0;
+
+  // Only quoted fields can hold "" escapes
+  for (size_t i = 0; i < field.len && out + 1 < size; i++) {
+    buffer[out++] = field.ptr[i];
+    if (field.quoted && field.ptr[i] == '"' && i + 1 < field.len &&
+        field.ptr[i + 1] == '"') {
+      i++;
+    }
+  }
+  buffer[out] = '\0';
+  return buffer;
+}
+
+// Index of the character after field.ptr[i], a "" escape counting as one
+size_t field_next(FieldView field, size_t i) {
+  if (field.quoted && field.ptr[i] == '"' && i + 1 < field.len &&
+      field.ptr[i + 1] == '"') {
+    return i + 2;
+  }
+  return i + 1;
+}
+
+// Same text once quotes and escapes are gone: Sales and "Sales" match
+int field_equal(FieldView a, FieldView b) {
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.len && j < b.len) {
+    if (a.ptr[i] != b.ptr[j]) {
+      return FALSE;
+    }
+    i = field_next(a, i);
+    j = field_next(b, j);
+  }
+  return i == a.len && j == b.len;
+}
+
+void write_csv_field(FILE *file, const char *text) {
+  if (strpbrk(text, ",\"\r\n") == NULL) {
+    fputs(text, file);
+    return;
+  }
+
+  // RFC 4180: wrap in quotes and double the quotes inside
+  fputc('"', file);
+  for (; *text; text++) {
+    if (*text == '"') {
+      fputc('"', file);
+    }
+    fputc(*text, file);
+  }
+  fputc('"', file);
+}
+
+void aggregate_init(CsvAggregate *agg) {
+  memset(agg, 0, sizeof(*agg));
+  agg->max_salary = -1.0;
+  agg->max_earner.ptr = "";
+}
+
+void aggregate_range(const char *data, size_t size, CsvAggregate *agg) {
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView emp;
+  int n;
+
+  csv_cursor_init(&cursor, data, size);
+  while ((n = csv_next_record(&cursor, fields, CSV_FIELDS)) >= 0) {
+    if (view_to_employee(fields, n, &emp) == SUCCESS) {
+      aggregate_record(agg, &emp);
+    }
+  }
+}
+
+void aggregate_record(CsvAggregate *agg, const EmployeeView *emp) {
+  agg->count++;
+  kahan_add(&agg->total, emp->salary);
+  if (emp->salary > agg->max_salary) {
+    agg->max_salary = emp->salary;
+    agg->max_id = emp->id;
+    agg->max_earner = emp->name;
+  }
+
+  DeptStats *group = find_group(agg, emp->department);
+  if (group == NULL) {
+    agg->other++;
+    return;
+  }
+  group->count++;
+  kahan_add(&group->total, emp->salary);
+  if (emp->salary > group->max_salary) {
+    group->max_salary = emp->salary;
+  }
+}
+
+void aggregate_merge(CsvAggregate *total, const CsvAggregate *part) {
+  total->count += part->count;
+  total->other += part->other;
+  kahan_add(&total->total, part->total.sum);
+  kahan_add(&total->total, -part->total.compensation);
+
+  // Parts are merged in file order: ties keep the earliest record
+  if (part->max_salary > total->max_salary) {
+    total->max_salary = part->max_salary;
+    total->max_id = part->max_id;
+    total->max_earner = part->max_earner;
+  }
+
+  for (int i = 0; i < MAX_GROUPS; i++) {
+    const DeptStats *src = &part->groups[i];
+    if (src->department.ptr == NULL) {
+      continue;
+    }
+    DeptStats *dst = find_group(total, src->department);
+    if (dst == NULL) {
+      total->other += src->count;
+      continue;
+    }
+    dst->count += src->count;
+    kahan_add(&dst->total, src->total.sum);
+    kahan_add(&dst->total, -src->total.compensation);
+    if (src->max_salary > dst->max_salary) {
+      dst->max_salary = src->max_salary;
+    }
+  }
+}
+
+DeptStats *find_group(CsvAggregate *agg, FieldView department) {
+  // FNV-1a over the raw field bytes, linear probing
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < department.len; i++) {
+    hash = (hash ^ (unsigned char)department.ptr[i]) * 16777619u;
+  }
+
+  for (uint32_t i = hash & (MAX_GROUPS - 1);; i = (i + 1) & (MAX_GROUPS - 1)) {
+    DeptStats *group = &agg->groups[i];
+    if (group->department.ptr == NULL) {
+      if (agg->num_groups >= GROUP_LIMIT) {
+        return NULL;
+      }
+      group->department = department;
+      group->max_salary = -1.0;
+      agg->num_groups++;
+      return group;
+    }
+    if (group->department.len == department.len &&
+        memcmp(group->department.ptr, department.ptr, department.len) == 0) {
+      return group;
+    }
+  }
+}
+
+Status aggregate_parallel(const char *data, size_t size, int num_threads,
+                          CsvAggregate *total) {
+  AggregateJob *jobs = (AggregateJob *)malloc(num_threads * sizeof(*jobs));
+  if (jobs == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Pass 1: quotes per chunk. A byte is quoted when the quotes before it
+  // are odd, so the prefix parity tells each cut whether it is inside
+  for (int t = 0; t < num_threads; t++) {
+    jobs[t].data = data;
+    jobs[t].start = size / num_threads * t;
+    jobs[t].end = (t == num_threads - 1) ? size : size / num_threads * (t + 1);
+  }
+  run_jobs(jobs, num_threads, quote_worker);
+
+  // Move every cut past the next unquoted newline: a record start
+  long long quotes = 0;
+  for (int t = 1; t < num_threads; t++) {
+    quotes += jobs[t - 1].quotes;
+    jobs[t].start =
+        next_record_start(data, size, jobs[t].start, (int)(quotes & 1));
+  }
+  for (int t = 0; t < num_threads; t++) {
+    if (t < num_threads - 1) {
+      jobs[t].end = jobs[t + 1].start;
+    }
+    if (jobs[t].end < jobs[t].start) {
+      jobs[t].end = jobs[t].start; // Cut swallowed by a long record
+    }
+  }
+
+  // Pass 2: partial aggregates, folded together in file order
+  run_jobs(jobs, num_threads, aggregate_worker);
+  aggregate_init(total);
+  for (int t = 0; t < num_threads; t++) {
+    aggregate_merge(total, &jobs[t].aggregate);
+  }
+
+  free(jobs);
+  return SUCCESS;
+}
+
+void run_jobs(AggregateJob *jobs, int num_jobs, void *(*worker)(void *)) {
+  pthread_t threads[MAX_THREADS];
+  int running[MAX_THREADS] = {FALSE};
+
+  for (int t = 1; t < num_jobs; t++) {
+    running[t] = pthread_create(&threads[t], NULL, worker, &jobs[t]) == 0;
+    if (!running[t]) {
+      worker(&jobs[t]);
+    }
+  }
+  worker(&jobs[0]);
+
+  for (int t = 1; t < num_jobs; t++) {
+    if (running[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+}
+
+void *quote_worker(void *arg) {
+  AggregateJob *job = (AggregateJob *)arg;
+  job->quotes = count_quotes(job->data + job->start, job->end - job->start);
+  return NULL;
+}
+
+void *aggregate_worker(void *arg) {
+  AggregateJob *job = (AggregateJob *)arg;
+  aggregate_init(&job->aggregate);
+  aggregate_range(job->data + job->start, job->end - job->start,
+                  &job->aggregate);
+  return NULL;
+}
+
+size_t next_record_start(const char *data, size_t size, size_t from,
+                         int in_quotes) {
+  for (size_t i = from; i < size; i++) {
+    if (data[i] == '"') {
+      in_quotes = !in_quotes;
+    } else if (data[i] == '\n' && !in_quotes) {
+      return i + 1;
+    }
+  }
+  return size;
+}
+
+long long count_quotes(const char *p, size_t n) {
+  long long quotes = 0;
+  size_t i = 0;
+
+#ifdef __x86_64__
+  if (use_avx2) {
+    return count_quotes_avx2(p, n);
+  }
+  __m128i quote = _mm_set1_epi8('"');
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+    quotes += __builtin_popcount(
+        (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)));
+  }
+#endif
+
+  for (; i < n; i++) {
+    quotes += (p[i] == '"');
+  }
+  return quotes;
+}
+
+#ifdef __x86_64__
+__attribute__((target("avx2"))) long long count_quotes_avx2(const char *p,
+                                                            size_t n) {
+  __m256i quote = _mm256_set1_epi8('"');
+  long long quotes = 0;
+  size_t i = 0;
+
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+    quotes += __builtin_popcount(
+        (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)));
+  }
+  for (; i < n; i++) {
+    quotes += (p[i] == '"');
+  }
+  return quotes;
+}
+#endif
+
+void kahan_add(KahanSum *k, double value) {
+  double y = value - k->compensation;
+  double t = k->sum + y;
+  k->compensation = (t - k->sum) - y; // What t lost of y
+  k->sum = t;
+}
+
+double kahan_value(const KahanSum *k) {
+  return k->sum - k->compensation;
+}
+
+void show_aggregate(const CsvAggregate *agg) {
+  const DeptStats *groups[MAX_GROUPS];
+  char text[MAX_FIELD];
+  int n = 0;
+
+  if (agg->count == 0) {
+    printf("  - No data available to calculate statistics.\n\n");
+    return;
+  }
+
+  double total = kahan_value(&agg->total);
+  printf("  - Total Employees: %lld\n", agg->count);
+  printf("  - Avg Salary:      $%.2f\n", total / agg->count);
+  printf("  - Total Payroll:   $%.2f\n", total);
+  printf("  - Highest Earner:  %s (ID %d, $%.2f)\n\n",
+         field_text(agg->max_earner, text, sizeof(text)), agg->max_id,
+         agg->max_salary);
+
+  for (int i = 0; i < MAX_GROUPS; i++) {
+    if (agg->groups[i].department.ptr != NULL) {
+      groups[n++] = &agg->groups[i];
+    }
+  }
+  qsort(groups, n, sizeof(groups[0]), compare_groups);
+
+  printf("%-20s | %10s | %16s | %12s | %12s\n", "Department", "Employees",
+         "Payroll", "Avg", "Max");
+  printf("---------------------|------------|------------------|"
+         "--------------|-------------\n");
+  for (int i = 0; i < n; i++) {
+    double sum = kahan_value(&groups[i]->total);
+    printf("%-20s | %10lld | %16.2f | %12.2f | %12.2f\n",
+           field_text(groups[i]->department, text, sizeof(text)),
+           groups[i]->count, sum, sum / groups[i]->count,
+           groups[i]->max_salary);
+  }
+  if (agg->other > 0) {
+    printf("%-20s | %10lld |\n", "(other)", agg->other);
+  }
+  printf("\n");
+}
+
+int compare_groups(const void *a, const void *b) {
+  const FieldView *x = &(*(const DeptStats *const *)a)->department;
+  const FieldView *y = &(*(const DeptStats *const *)b)->department;
+  size_t len = (x->len < y->len) ? x->len : y->len;
+  int diff = memcmp(x->ptr, y->ptr, len);
+  if (diff != 0) {
+    return diff;
+  }
+  return (x->len > y->len) - (x->len < y->len);
+}
+
+void cache_path(const char *csv_path, char *path, size_t size) {
+  snprintf(path, size, "%s%s", csv_path, CACHE_SUFFIX);
+}
+
+Status cache_build(const char *csv_path, long long *rows) {
+  // Columns in file order: ids, salaries, codes, name offsets, names,
+  // dictionary offsets, dictionary
+  ByteBuffer columns[7];
+  struct stat st;
+  uint64_t departments = 0;
+  uint64_t count = 0;
+  uint64_t offset = 0;
+
+  if (stat(csv_path, &st) != 0) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  size_t size = 0;
+  const char *data = map_file(csv_path, &size);
+  DictSlot *slots = (DictSlot *)calloc(DICT_SLOTS, sizeof(DictSlot));
+  if (data == NULL || slots == NULL) {
+    if (data != NULL) {
+      unmap_file(data, size);
+    }
+    free(slots);
+    return (data == NULL) ? ERR_FILE_NOT_FOUND : ERR_MEMORY_ALLOCATION;
+  }
+  memset(columns, 0, sizeof(columns));
+
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView emp;
+  Status status = buffer_append(&columns[3], &offset, sizeof(offset));
+  int n;
+
+  csv_cursor_init(&cursor, data, size);
+  while (status == SUCCESS &&
+         (n = csv_next_record(&cursor, fields, CSV_FIELDS)) >= 0) {
+    if (view_to_employee(fields, n, &emp) != SUCCESS) {
+      continue;
+    }
+
+    uint64_t before = departments;
+    int code = dict_code(slots, emp.department, &departments);
+    if (code < 0) {
+      status = ERR_TOO_MANY_GROUPS;
+      break;
+    }
+    uint16_t code16 = (uint16_t)code;
+    int32_t id = emp.id;
+    if (departments > before) {
+      status = buffer_append_field(&columns[6], emp.department);
+      offset = columns[6].len;
+      if (status == SUCCESS) {
+        status = buffer_append(&columns[5], &offset, sizeof(offset));
+      }
+    }
+    if (status == SUCCESS) {
+      status = buffer_append(&columns[0], &id, sizeof(id));
+    }
+    if (status == SUCCESS) {
+      status = buffer_append(&columns[1], &emp.salary, sizeof(emp.salary));
+    }
+    if (status == SUCCESS) {
+      status = buffer_append(&columns[2], &code16, sizeof(code16));
+    }
+    if (status == SUCCESS) {
+      status = buffer_append_field(&columns[4], emp.name);
+    }
+    offset = columns[4].len;
+    if (status == SUCCESS) {
+      status = buffer_append(&columns[3], &offset, sizeof(offset));
+    }
+    count++;
+  }
+  unmap_file(data, size);
+  free(slots);
+
+  if (status == SUCCESS) {
+    status = cache_write(csv_path, &st, columns, count, departments);
+  }
+  for (int i = 0; i < 7; i++) {
+    free(columns[i].data);
+  }
+  *rows = (long long)count;
+  return status;
+}
+
+Status cache_write(const char *csv_path, const struct stat *st,
+                   ByteBuffer columns[], uint64_t rows, uint64_t departments) {
+  char path[MAX_PATH + 8];
+  char tmp_path[MAX_PATH + 16];
+  CacheHeader header;
+  uint64_t *offsets[7];
+  Status status = SUCCESS;
+
+  // The dictionary offsets column starts with 0 like the name offsets
+  uint64_t zero = 0;
+  ByteBuffer dict_offsets = {NULL, 0, 0};
+  if (buffer_append(&dict_offsets, &zero, sizeof(zero)) != SUCCESS ||
+      buffer_append(&dict_offsets, columns[5].data, columns[5].len) !=
+          SUCCESS) {
+    free(dict_offsets.data);
+    return ERR_MEMORY_ALLOCATION;
+  }
+  free(columns[5].data);
+  columns[5] = dict_offsets;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+  header.version = CACHE_VERSION;
+  header.csv_size = (uint64_t)st->st_size;
+  header.csv_mtime_sec = (int64_t)st->st_mtim.tv_sec;
+  header.csv_mtime_nsec = (int64_t)st->st_mtim.tv_nsec;
+  header.rows = rows;
+  header.departments = departments;
+
+  offsets[0] = &header.ids;
+  offsets[1] = &header.salaries;
+  offsets[2] = &header.dept_codes;
+  offsets[3] = &header.name_offsets;
+  offsets[4] = &header.names;
+  offsets[5] = &header.dict_offsets;
+  offsets[6] = &header.dict;
+  uint64_t position = sizeof(header);
+  for (int i = 0; i < 7 && status == SUCCESS; i++) {
+    status = buffer_pad(&columns[i]);
+    *offsets[i] = position;
+    position += columns[i].len;
+  }
+  header.file_size = position;
+  if (status != SUCCESS) {
+    return status;
+  }
+
+  // Written next to the target and renamed: readers never see half a file
+  cache_path(csv_path, path, sizeof(path));
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (file == NULL) {
+    return ERR_FILE_CREATE_FAILED;
+  }
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    status = ERR_FILE_CREATE_FAILED;
+  }
+  for (int i = 0; i < 7 && status == SUCCESS; i++) {
+    if (columns[i].len > 0 &&
+        fwrite(columns[i].data, 1, columns[i].len, file) != columns[i].len) {
+      status = ERR_FILE_CREATE_FAILED;
+    }
+  }
+  if (fclose(file) != 0 || status != SUCCESS ||
+      rename(tmp_path, path) != 0) {
+    remove(tmp_path);
+    return ERR_FILE_CREATE_FAILED;
+  }
+  return SUCCESS;
+}
+
+// The header and column layout are checked on every open. The per-row
+// codes and offsets only when the caller reads every row anyway
+// (check_rows); a point lookup checks its one row with cache_check_row.
+Status cache_open(const char *csv_path, ColumnCache *cache, int check_rows) {
+  char path[MAX_PATH + 8];
+  struct stat st;
+
+  memset(cache, 0, sizeof(*cache));
+  if (stat(csv_path, &st) != 0) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  cache_path(csv_path, path, sizeof(path));
+  cache->data = map_file(path, &cache->size);
+  if (cache->data == NULL) {
+    return ERR_CACHE_INVALID;
+  }
+
+  const CacheHeader *h = (const CacheHeader *)cache->data;
+  int valid = cache->size >= sizeof(CacheHeader) &&
+              memcmp(h->magic, CACHE_MAGIC, sizeof(h->magic)) == 0 &&
+              h->version == CACHE_VERSION && h->file_size == cache->size;
+
+  // A stale cache would silently answer with old data: drop it
+  if (valid && (h->csv_size != (uint64_t)st.st_size ||
+                h->csv_mtime_sec != (int64_t)st.st_mtim.tv_sec ||
+                h->csv_mtime_nsec != (int64_t)st.st_mtim.tv_nsec)) {
+    unmap_file(cache->data, cache->size);
+    remove(path);
+    memset(cache, 0, sizeof(*cache));
+    return ERR_CACHE_INVALID;
+  }
+  // Columns must follow each other in order and end inside the file (every
+  // offset is bounded first so the sums below cannot wrap)
+  valid = valid && h->rows <= cache->size && h->departments <= cache->size &&
+          h->salaries <= h->file_size && h->dept_codes <= h->file_size &&
+          h->name_offsets <= h->file_size && h->names <= h->file_size &&
+          h->dict_offsets <= h->file_size && h->dict <= h->file_size &&
+          h->ids == sizeof(CacheHeader) &&
+          h->ids + h->rows * sizeof(int32_t) <= h->salaries &&
+          h->salaries + h->rows * sizeof(double) <= h->dept_codes &&
+          h->dept_codes + h->rows * sizeof(uint16_t) <= h->name_offsets &&
+          h->name_offsets + (h->rows + 1) * sizeof(uint64_t) <= h->names &&
+          h->names <= h->dict_offsets &&
+          h->dict_offsets + (h->departments + 1) * sizeof(uint64_t) <=
+              h->dict &&
+          h->dict <= h->file_size;
+  if (valid) {
+    cache->header = h;
+    cache->ids = (const int32_t *)(cache->data + h->ids);
+    cache->salaries = (const double *)(cache->data + h->salaries);
+    cache->dept_codes = (const uint16_t *)(cache->data + h->dept_codes);
+    cache->name_offsets = (const uint64_t *)(cache->data + h->name_offsets);
+    cache->names = cache->data + h->names;
+    cache->dict_offsets = (const uint64_t *)(cache->data + h->dict_offsets);
+    cache->dict = cache->data + h->dict;
+    valid = !check_rows || cache_check(cache);
+  }
+
+  // Corrupt or foreign: queries fall back to the CSV, the next build
+  // writes a fresh cache
+  if (!valid) {
+    unmap_file(cache->data, cache->size);
+    remove(path);
+    memset(cache, 0, sizeof(*cache));
+    return ERR_CACHE_INVALID;
+  }
+  return SUCCESS;
+}
+
+// Every code and offset is checked once here, so full passes can index
+// the columns without bounds checks
+int cache_check(const ColumnCache *cache) {
+  const CacheHeader *h = cache->header;
+  uint64_t names_size = h->dict_offsets - h->names;
+  uint64_t dict_size = h->file_size - h->dict;
+
+  for (uint64_t r = 0; r < h->rows; r++) {
+    if (cache->dept_codes[r] >= h->departments ||
+        cache->name_offsets[r] > cache->name_offsets[r + 1]) {
+      return FALSE;
+    }
+  }
+  if (h->rows > 0 && h->departments == 0) {
+    return FALSE;
+  }
+  for (uint64_t d = 0; d < h->departments; d++) {
+    if (cache->dict_offsets[d] > cache->dict_offsets[d + 1]) {
+      return FALSE;
+    }
+  }
+  return cache->name_offsets[h->rows] <= names_size &&
+         cache->dict_offsets[h->departments] <= dict_size;
+}
+
+int cache_check_row(const ColumnCache *cache, uint64_t row) {
+  const CacheHeader *h = cache->header;
+  uint16_t code = cache->dept_codes[row];
+
+  return code < h->departments &&
+         cache->name_offsets[row] <= cache->name_offsets[row + 1] &&
+         cache->name_offsets[row + 1] <= h->dict_offsets - h->names &&
+         cache->dict_offsets[code] <= cache->dict_offsets[code + 1] &&
+         cache->dict_offsets[code + 1] <= h->file_size - h->dict;
+}
+
+// Corrupt: the next build writes a fresh one
+void cache_remove(const char *csv_path) {
+  char path[MAX_PATH + 8];
+  cache_path(csv_path, path, sizeof(path));
+  remove(path);
+}
+
+void cache_close(ColumnCache *cache) {
+  if (cache->data != NULL) {
+    unmap_file(cache->data, cache->size);
+  }
+  memset(cache, 0, sizeof(*cache));
+}
+
+void cache_display(const ColumnCache *cache) {
+  char name[MAX_FIELD];
+  char department[MAX_FIELD];
+  uint64_t rows = cache->header->rows;
+
+  printf("\n=== Employee Records (columnar cache) ===\n");
+  printf("%-5s | %-20s | %-15s | %-10s\n", "ID", "Name", "Department",
+         "Salary");
+  printf("------------------------------------------------------------\n");
+  for (uint64_t r = 0; r < rows; r++) {
+    printf("%-5d | %-20s | %-15s | $%-9.2f\n", cache->ids[r],
+           field_text(cache_name(cache, r), name, sizeof(name)),
+           field_text(cache_department(cache, cache->dept_codes[r]),
+                      department, sizeof(department)),
+           cache->salaries[r]);
+  }
+  if (rows == 0) {
+    printf("  (No valid records found in file)\n");
+  }
+  printf("------------------------------------------------------------\n");
+  printf("  - Total valid records parsed: %llu\n\n",
+         (unsigned long long)rows);
+}
+
+long long cache_find_id(const ColumnCache *cache, int id) {
+  // One 4-byte column: 16 ids per cache line instead of whole CSV lines
+  for (uint64_t r = 0; r < cache->header->rows; r++) {
+    if (cache->ids[r] == id) {
+      return (long long)r;
+    }
+  }
+  return -1;
+}
+
+Status cache_aggregate(const ColumnCache *cache, CsvAggregate *agg) {
+  uint64_t departments = cache->header->departments;
+  DeptStats *per_code =
+      (DeptStats *)calloc(departments > 0 ? departments : 1, sizeof(DeptStats));
+  if (per_code == NULL) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+
+  // Group-by on the 16-bit codes: a direct index, no hashing
+  aggregate_init(agg);
+  for (uint64_t d = 0; d < departments; d++) {
+    per_code[d].max_salary = -1.0;
+  }
+  for (uint64_t r = 0; r < cache->header->rows; r++) {
+    double salary = cache->salaries[r];
+    DeptStats *group = &per_code[cache->dept_codes[r]];
+    kahan_add(&agg->total, salary);
+    if (salary > agg->max_salary) {
+      agg->max_salary = salary;
+      agg->max_id = cache->ids[r];
+      agg->max_earner = cache_name(cache, r);
+    }
+    group->count++;
+    kahan_add(&group->total, salary);
+    if (salary > group->max_salary) {
+      group->max_salary = salary;
+    }
+  }
+  agg->count = (long long)cache->header->rows;
+
+  // Merged, not assigned: codes and groups need not map one to one
+  for (uint64_t d = 0; d < departments; d++) {
+    DeptStats *group = find_group(agg, cache_department(cache, d));
+    if (group == NULL) {
+      agg->other += per_code[d].count;
+      continue;
+    }
+    group->count += per_code[d].count;
+    kahan_add(&group->total, per_code[d].total.sum);
+    kahan_add(&group->total, -per_code[d].total.compensation);
+    if (per_code[d].max_salary > group->max_salary) {
+      group->max_salary = per_code[d].max_salary;
+    }
+  }
+
+  free(per_code);
+  return SUCCESS;
+}
+
+FieldView cache_name(const ColumnCache *cache, uint64_t row) {
+  FieldView view;
+  view.ptr = cache->names + cache->name_offsets[row];
+  view.len = cache->name_offsets[row + 1] - cache->name_offsets[row];
+  view.quoted = FALSE; // Stored unescaped
+  return view;
+}
+
+FieldView cache_department(const ColumnCache *cache, uint64_t code) {
+  FieldView view;
+  view.ptr = cache->dict + cache->dict_offsets[code];
+  view.len = cache->dict_offsets[code + 1] - cache->dict_offsets[code];
+  view.quoted = FALSE;
+  return view;
+}
+
+// Keyed on the unescaped text, which is what the dictionary stores
+int dict_code(DictSlot *slots, FieldView department, uint64_t *count) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < department.len; i = field_next(department, i)) {
+    hash = (hash ^ (unsigned char)department.ptr[i]) * 16777619u;
+  }
+
+  for (uint32_t i = hash & (DICT_SLOTS - 1);; i = (i + 1) & (DICT_SLOTS - 1)) {
+    DictSlot *slot = &slots[i];
+    if (slot->department.ptr == NULL) {
+      if (*count >= MAX_DEPARTMENTS) {
+        return -1;
+      }
+      slot->department = department;
+      slot->code = (uint16_t)(*count)++;
+      return slot->code;
+    }
+    if (field_equal(slot->department, department)) {
+      return slot->code;
+    }
+  }
+}
+
+Status buffer_append(ByteBuffer *b, const void *src, size_t n) {
+  if (n == 0) {
+    return SUCCESS;
+  }
+  if (b->len + n > b->cap) {
+    size_t cap = (b->cap == 0) ? 4096 : b->cap * 2;
+    while (cap < b->len + n) {
+      cap *= 2;
+    }
+    char *data = (char *)realloc(b->data, cap);
+    if (data == NULL) {
+      return ERR_MEMORY_ALLOCATION;
+    }
+    b->data = data;
+    b->cap = cap;
+  }
+  memcpy(b->data + b->len, src, n);
+  b->len += n;
+  return SUCCESS;
+}
+
+Status buffer_append_field(ByteBuffer *b, FieldView field) {
+  size_t start = b->len;
+  if (buffer_append(b, field.ptr, field.len) != SUCCESS) {
+    return ERR_MEMORY_ALLOCATION;
+  }
+  if (!field.quoted) {
+    return SUCCESS;
+  }
+
+  // Collapse "" escapes in place
+  size_t out = start;
+  for (size_t i = start; i < b->len; i++) {
+    b->data[out++] = b->data[i];
+    if (b->data[i] == '"' && i + 1 < b->len && b->data[i + 1] == '"') {
+      i++;
+    }
+  }
+  b->len = out;
+  return SUCCESS;
+}
+
+Status buffer_pad(ByteBuffer *b) {
+  static const char zeros[8] = {0};
+  return buffer_append(b, zeros, (8 - b->len % 8) % 8);
+}
+
+void index_path(const char *csv_path, char *path, size_t size) {
+  snprintf(path, size, "%s%s", csv_path, INDEX_SUFFIX);
+}
+
+Status index_build(const char *csv_path, long long *entries) {
+  struct stat st;
+  if (stat(csv_path, &st) != 0) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  size_t size = 0;
+  const char *data = map_file(csv_path, &size);
+  if (data == NULL) {
+    return ERR_FILE_NOT_FOUND;
+  }
+
+  ByteBuffer buffer = {NULL, 0, 0};
+  CsvCursor cursor;
+  FieldView fields[CSV_FIELDS];
+  EmployeeView emp;
+  Status status = SUCCESS;
+  int n;
+
+  csv_cursor_init(&cursor, data, size);
+  while (status == SUCCESS) {
+    size_t start = cursor.field_start;
+    if ((n = csv_next_record(&cursor, fields, CSV_FIELDS)) < 0) {
+      break;
+    }
+    if (view_to_employee(fields, n, &emp) != SUCCESS) {
+      continue;
+    }
+    IndexEntry entry;
+    entry.id = emp.id;
+    entry.length = (uint32_t)(cursor.field_start - start);
+    entry.offset = start;
+    status = buffer_append(&buffer, &entry, sizeof(entry));
+  }
+  unmap_file(data, size);
+
+  uint64_t count = buffer.len / sizeof(IndexEntry);
+  if (status == SUCCESS) {
+    status = index_write(csv_path, &st, (IndexEntry *)buffer.data, count);
+  }
+  free(buffer.data);
+  *entries = (long long)count;
+  return status;
+}
+
+Status index_write(const char *csv_path, const struct stat *st,
+                   IndexEntry *entries, uint64_t count) {
+  char path[MAX_PATH + 8];
+  char tmp_path[MAX_PATH + 16];
+  IndexHeader header;
+
+  // Stable order for equal IDs: the first record in the file wins
+  if (count > 0) {
+    qsort(entries, count, sizeof(IndexEntry), compare_entries);
+  }
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+  header.version = INDEX_VERSION;
+  header.csv_size = (uint64_t)st->st_size;
+  header.csv_mtime_sec = (int64_t)st->st_mtim.tv_sec;
+  header.csv_mtime_nsec = (int64_t)st->st_mtim.tv_nsec;
+  header.sorted = count;
+  header.entries = count;
+
+  index_path(csv_path, path, sizeof(path));
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (file == NULL) {
+    return ERR_FILE_CREATE_FAILED;
+  }
+  int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+           (count == 0 ||
+            fwrite(entries, sizeof(IndexEntry), count, file) == count);
+  if (fclose(file) != 0 || !ok || rename(tmp_path, path) != 0) {
+    remove(tmp_path);
+    return ERR_FILE_CREATE_FAILED;
+  }
+  return SUCCESS;
+}
+
+Status index_open(const char *csv_path, IdIndex *index) {
+  char path[MAX_PATH + 8];
+  struct stat st;
+  struct stat idx_st;
+
+  memset(index, 0, sizeof(*index));
+  if (stat(csv_path, &st) != 0) {
+    return ERR_FILE_NOT_FOUND;
+  }
+  index_path(csv_path, path, sizeof(path));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return ERR_INDEX_INVALID;
+  }
+  if (fstat(fd, &idx_st) != 0 ||
+      (size_t)idx_st.st_size < sizeof(IndexHeader)) {
+    close(fd);
+    return ERR_INDEX_INVALID;
+  }
+
+  // No MAP_POPULATE: a lookup should only fault in the pages it probes
+  index->size = (size_t)idx_st.st_size;
+  void *data = mmap(NULL, index->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    memset(index, 0, sizeof(*index));
+    return ERR_INDEX_INVALID;
+  }
+  madvise(data, index->size, MADV_RANDOM);
+  index->data = (const char *)data;
+
+  const IndexHeader *h = (const IndexHeader *)index->data;
+  if (!index_matches(h, &st) || h->sorted > h->entries ||
+      h->entries > index->size / sizeof(IndexEntry) ||
+      sizeof(IndexHeader) + h->entries * sizeof(IndexEntry) != index->size) {
+    index_close(index);
+    return ERR_INDEX_INVALID;
+  }
+  index->header = h;
+  index->entries = (const IndexEntry *)(index->data + sizeof(IndexHeader));
+  return SUCCESS;
+}
+
+void index_close(IdIndex *index) {
+  if (index->data != NULL) {
+    munmap((void *)index->data, index->size);
+  }
+  memset(index, 0, sizeof(*index));
+}
+
+const IndexEntry *index_find(const IdIndex *index, int id) {
+  // Lower bound in the sorted part: about log2(n) probes, most of them in
+  // pages already cached from earlier lookups
+  uint64_t low = 0;
+  uint64_t high = index->header->sorted;
+  while (low < high) {
+    uint64_t mid = low + (high - low) / 2;
+    if (index->entries[mid].id < id) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low < index->header->sorted && index->entries[low].id == id) {
+    return &index->entries[low];
+  }
+
+  // The tail only holds records appended after the sorted ones
+  for (uint64_t i = index->header->sorted; i < index->header->entries; i++) {
+    if (index->entries[i].id == id) {
+      return &index->entries[i];
+    }
+  }
+  return NULL;
+}
+
+Status index_fetch(const char *csv_path, const IndexEntry *entry,
+                   char **record, EmployeeView *emp) {
+  FieldView fields[CSV_FIELDS];
+  CsvCursor cursor;
+
+  *record = (char *)malloc(entry->length > 0 ? entry->length : 1);
+  int fd = open(csv_path, O_RDONLY);
+  if (*record == NULL || fd < 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return (*record == NULL) ? ERR_MEMORY_ALLOCATION : ERR_FILE_NOT_FOUND;
+  }
+  ssize_t got = pread(fd, *record, entry->length, (off_t)entry->offset);
+  close(fd);
+
+  // Never trust the offset blindly: the record must parse to the same ID
+  if (got != (ssize_t)entry->length) {
+    return ERR_INDEX_INVALID;
+  }
+  csv_cursor_init(&cursor, *record, entry->length);
+  int n = csv_next_record(&cursor, fields, CSV_FIELDS);
+  if (n < 0 || view_to_employee(fields, n, emp) != SUCCESS ||
+      emp->id != entry->id) {
+    return ERR_INDEX_INVALID;
+  }
+  return SUCCESS;
+}
+
+Status index_append(const char *csv_path, const struct stat *before,
+                    const struct stat *after, const IndexEntry *entry) {
+  char path[MAX_PATH + 8];
+  IndexHeader header;
+  IndexEntry last;
+
+  index_path(csv_path, path, sizeof(path));
+  int fd = open(path, O_RDWR);
+  if (fd < 0) {
+    return ERR_INDEX_INVALID;
+  }
+  off_t end = lseek(fd, 0, SEEK_END);
+  if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+      !index_matches(&header, before) || header.sorted > header.entries ||
+      end != (off_t)(sizeof(header) + header.entries * sizeof(IndexEntry))) {
+    // Out of date already: drop it rather than extend a wrong index
+    close(fd);
+    remove(path);
+    return ERR_INDEX_INVALID;
+  }
+
+  // Ascending IDs (the usual case) keep the whole index sorted
+  int in_order = header.sorted == header.entries;
+  if (in_order && header.entries > 0) {
+    off_t last_pos = end - (off_t)sizeof(IndexEntry);
+    in_order = pread(fd, &last, sizeof(last), last_pos) ==
+                   (ssize_t)sizeof(last) &&
+               last.id <= entry->id;
+  }
+
+  // Entry first, header last: a crash in between leaves a header that no
+  // longer matches the CSV, and the index is simply rebuilt
+  if (pwrite(fd, entry, sizeof(*entry), end) != (ssize_t)sizeof(*entry)) {
+    close(fd);
+    remove(path);
+    return ERR_FILE_CREATE_FAILED;
+  }
+  header.entries++;
+  if (in_order) {
+    header.sorted = header.entries;
+  }
+  header.csv_size = (uint64_t)after->st_size;
+  header.csv_mtime_sec = (int64_t)after->st_mtim.tv_sec;
+  header.csv_mtime_nsec = (int64_t)after->st_mtim.tv_nsec;
+
+  if (header.entries - header.sorted <= INDEX_TAIL_LIMIT) {
+    int ok = pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+    close(fd);
+    if (!ok) {
+      remove(path);
+      return ERR_FILE_CREATE_FAILED;
+    }
+    return SUCCESS;
+  }
+
+  // Tail full: merge it into a freshly sorted index
+  size_t bytes = header.entries * sizeof(IndexEntry);
+  IndexEntry *entries = (IndexEntry *)malloc(bytes);
+  int ok = entries != NULL &&
+           pread(fd, entries, bytes, sizeof(header)) == (ssize_t)bytes;
+  close(fd);
+  Status status = ok ? index_write(csv_path, after, entries, header.entries)
+                     : ERR_MEMORY_ALLOCATION;
+  free(entries);
+  if (status != SUCCESS) {
+    remove(path);
+  }
+  return status;
+}
+
+int index_matches(const IndexHeader *header, const struct stat *st) {
+  return memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) == 0 &&
+         header->version == INDEX_VERSION &&
+         header->csv_size == (uint64_t)st->st_size &&
+         header->csv_mtime_sec == (int64_t)st->st_mtim.tv_sec &&
+         header->csv_mtime_nsec == (int64_t)st->st_mtim.tv_nsec;
+}
+
+int compare_entries(const void *a, const void *b) {
+  const IndexEntry *x = (const IndexEntry *)a;
+  const IndexEntry *y = (const IndexEntry *)b;
+  if (x->id != y->id) {
+    return (x->id < y->id) ? -1 : 1;
+  }
+  return (x->offset > y->offset) - (x->offset < y->offset);
+}
+
+void show_employee(const char *title, const EmployeeView *emp) {
+  char text[MAX_FIELD];
+
+  printf("\n=== %s ===\n", title);
+  printf("  - ID:         %d\n", emp->id);
+  printf("  - Name:       %s\n", field_text(emp->name, text, sizeof(text)));
+  printf("  - Department: %s\n",
+         field_text(emp->department, text, sizeof(text)));
+  printf("  - Salary:     $%.2f\n\n", emp->salary);
+}